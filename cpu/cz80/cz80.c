@@ -223,6 +223,51 @@ static inline unsigned char picodrive_read(unsigned short a)
 		return ((z80_read_f *)(v << 1))(a);
 	return *(unsigned char *)((v << 1) + a);
 }
+
+void z80_idle_hit(unsigned int pc);
+
+/* op points to the start of a loop that a jr has just jumped back to, len is
+   the size of the loop body. It is an idle loop if it only loads a byte from
+   plain memory (not an I/O handler) and tests it: only this cpu can change
+   that while it runs, so the loop spins until an interrupt comes or the cpu
+   is stopped and something else writes there. */
+static int Cz80_Is_Idle_Loop(cz80_struc *CPU, const UINT8 *op, int len)
+{
+	UINT32 a;
+
+	if (op[len] == 0x10)	// djnz
+		return 0;
+
+	switch (len)
+	{
+	case 0:		// jr $
+		return 1;
+	case 2:		// ld a,(hl); or a|and a - bit n,(hl)
+		if (!(op[0] == 0x7e && (op[1] == 0xb7 || op[1] == 0xa7)) &&
+		    !(op[0] == 0xcb && (op[1] & 0xc7) == 0x46))
+			return 0;
+		a = zHL;
+		break;
+	case 3:		// ld a,(hl); and n|cp n
+		if (op[0] != 0x7e || (op[1] != 0xe6 && op[1] != 0xfe))
+			return 0;
+		a = zHL;
+		break;
+	case 4:		// ld a,(nn); or a|and a
+		if (op[0] != 0x3a || (op[3] != 0xb7 && op[3] != 0xa7))
+			return 0;
+		a = op[1] | (op[2] << 8);
+		break;
+	case 5:		// ld a,(nn); and n|cp n
+		if (op[0] != 0x3a || (op[3] != 0xe6 && op[3] != 0xfe))
+			return 0;
+		a = op[1] | (op[2] << 8);
+		break;
+	default:
+		return 0;
+	}
+	return !map_flag_set(z80_read_map[a >> Z80_MEM_SHIFT]);
+}
 #endif
 
 /*--------------------------------------------------------
@@ -65,6 +65,7 @@ extern "C" {
 #define PICODRIVE_HACKS		1
 #define CZ80_LITTLE_ENDIAN		1
 #define CZ80_USE_JUMPTABLE 1
+#define CZ80_THREADED_DISPATCH	1
 #define CZ80_BIG_FLAGS_ARRAY	1
 //#ifdef BUILD_CPS1PSP
 //#define CZ80_ENCRYPTED_ROM		1
@@ -271,6 +272,9 @@ typedef struct cz80_t
 
 	INT32  (*Interrupt_Callback)(INT32 irqline);
 
+#if PICODRIVE_HACKS
+	UINT32 IdleDet;		/* skip rest of the timeslice in idle loops */
+#endif
 } cz80_struc;
 
 
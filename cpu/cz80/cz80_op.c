@@ -918,6 +918,15 @@ OP_DJNZ:
 OP_JR:
 		adr = (INT8)READ_ARG();
 		PC += (INT8)adr;
+#if PICODRIVE_HACKS
+		if ((INT8)adr < 0 && CPU->IdleDet &&
+		    Cz80_Is_Idle_Loop(CPU, (UINT8 *)PC, -(INT8)adr - 2))
+		{
+			z80_idle_hit(zRealPC);
+			if (CPU->ICount > 12)
+				CPU->ICount = 12;
+		}
+#endif
 		RET(12)
 
 	OP(0x20):   // JR   NZ,n
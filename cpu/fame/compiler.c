@@ -0,0 +1,1005 @@
+/*
+ * PicoDrive
+ * 68000 recompiler for the FAME core
+ *
+ * This work is licensed under the terms of MAME license.
+ * See COPYING file in the top-level directory.
+ *
+ * notes:
+ * - blocks are looked up by host address of the code, so bank switching and
+ *   mirrors need no special handling, and both 68ks share translations
+ * - all 68k state stays in the FAME context, host code only keeps
+ *   the context (CONTEXT_REG) and block start PC (xBX) in registers
+ * - instructions without a native translation call the FAME opcode handler,
+ *   with PC/Opcode set up the same way as the interpreter does it
+ * - on each entry, a block compares the 68k code it was translated from
+ *   against memory and asks to be retranslated if it doesn't match. This
+ *   catches self modifying code in RAM, writes done by any memory handler or
+ *   DMA, ROM patches and idle loop patching.
+ * - cycles are taken after every instruction, same as the interpreter, so
+ *   SekCyclesLeft/SekEndRun work from memory handlers
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include "../../pico/pico_int.h"
+#include "../drc/cmn.h"
+#include "compiler.h"
+
+#ifdef DRC_M68K
+
+#define COUNT_OP
+static u8 *tcache_ptr;
+
+#include "../drc/emit_x86.c"
+
+// limits
+#define BLOCK_INSN_LIMIT        64
+#define BLOCK_WORD_LIMIT        256
+#define MAX_INSN_WORDS          5
+#define MAX_BLOCK_SIZE          (BLOCK_INSN_LIMIT * 260 + BLOCK_WORD_LIMIT * 8 + 256)
+#define M68K_TCACHE_SIZE        (4*1024*1024)
+#define BLOCK_HASH_SIZE         0x1000
+#define BLOCK_MAX_COUNT         0x4000
+
+#define CTX(f)       offsetof(M68K_CONTEXT, f)
+#define DREG_OFS(r)  (CTX(dreg) + (r) * 4)
+#define AREG_OFS(r)  (CTX(areg) + (r) * 4)
+
+// flags for emit_flags_host()
+#define FL_X  1 // X is set too
+#define FL_V  2 // V from host, else cleared
+
+// extra x86 bits not in emit_x86.c
+#define emith_ctx_write_ptr(r, offs) do { \
+  EMIT_REX_IF(1, r, CONTEXT_REG); \
+  emith_deref_op(0x89, r, CONTEXT_REG, offs); \
+} while (0)
+
+#define emith_move_r_imm64(r, imm) do { \
+  EMIT_REX(1, 0, 0, 0); \
+  EMIT_OP(0xb8 + (r)); \
+  EMIT(imm, unsigned long long); \
+} while (0)
+
+struct block_desc {
+  const u16 *src;                  // host address of the 68k code
+  int (*code)(M68K_CONTEXT *ctx, const void *entry); // NULL: run single insn
+                                   //   in the interpreter
+  const u32 *entries;              // per insn: word offset << 24 | host offset
+  struct block_desc *next;         // in hash chain
+  u16 op;                          // 1st opcode, to validate NULL code blocks
+  u8 insns;
+};
+
+static u8 ALIGNED(4096) tcache_m68k[M68K_TCACHE_SIZE];
+static struct block_desc block_descs[BLOCK_MAX_COUNT];
+static struct block_desc *block_hash[BLOCK_HASH_SIZE];
+static int block_count;
+
+// block each cpu was in when it ran out of cycles, to resume mid-block
+static struct block_desc *exit_block[2];
+#define CPU_IDX(ctx) ((ctx) != &PicoCpuFM68k)
+static int drc_state; // 0 - uninitialized, 1 - ready, -1 - can't execute code
+
+// host code of each insn in block being translated, for backward branches
+static u8 *insn_ptrs[BLOCK_WORD_LIMIT];
+
+#define HASH_FUNC(src) \
+  (((uintptr_t)(src) >> 1) & (BLOCK_HASH_SIZE - 1))
+
+void fm68k_drc_flush_all(void)
+{
+  memset(block_hash, 0, sizeof(block_hash));
+  block_count = 0;
+  tcache_ptr = tcache_m68k;
+  exit_block[0] = exit_block[1] = NULL;
+}
+
+static int drc_init(void)
+{
+  int ret = plat_mem_set_exec(tcache_m68k, sizeof(tcache_m68k));
+  elprintf(EL_STATUS, "fm68k_drc: %p, %zd bytes: %d",
+    tcache_m68k, sizeof(tcache_m68k), ret);
+
+  drc_state = ret == 0 ? 1 : -1;
+  fm68k_drc_flush_all();
+  return ret;
+}
+
+static struct block_desc *block_find(const u16 *src)
+{
+  struct block_desc *bd;
+
+  for (bd = block_hash[HASH_FUNC(src)]; bd != NULL; bd = bd->next)
+    if (bd->src == src)
+      return bd;
+
+  return NULL;
+}
+
+static struct block_desc *block_new(const u16 *src)
+{
+  struct block_desc *bd = &block_descs[block_count++];
+  int h = HASH_FUNC(src);
+
+  bd->src = src;
+  bd->code = NULL;
+  bd->next = block_hash[h];
+  block_hash[h] = bd;
+  return bd;
+}
+
+// -------------------------------------------------------------------------
+// instruction length decoder
+
+// extension words of an effective address, -1 if invalid
+static int ea_words(int mode, int reg, int size)
+{
+  if (mode < 5)
+    return 0;
+  if (mode < 7)
+    return 1;
+
+  switch (reg) {
+  case 0: // abs.w
+  case 2: // d16(PC)
+  case 3: // d8(PC,Xn)
+    return 1;
+  case 1: // abs.l
+    return 2;
+  case 4: // #imm
+    return size == 2 ? 2 : 1;
+  }
+  return -1;
+}
+
+// length in words of an instruction that continues to the next one,
+// 0 if it's unknown or the instruction changes flow
+static int op_len(u32 op)
+{
+  int mode = (op >> 3) & 7, reg = op & 7, size = (op >> 6) & 3;
+  int n = 1, ea = 0;
+
+  switch (op >> 12) {
+  case 0x0:
+    if ((op & 0x100) && mode == 1)  // movep
+      n = 2;
+    else if (op & 0x100)            // btst/bchg/bclr/bset Dn
+      ea = ea_words(mode, reg, 0);
+    else if ((op & 0xf00) == 0x800) // btst/bchg/bclr/bset #imm
+      n = 2, ea = ea_words(mode, reg, 0);
+    else if ((op & 0x3f) == 0x3c)   // ori/andi/eori to ccr/sr
+      n = 2;
+    else if (size == 3)
+      return 0;
+    else                            // ori/andi/subi/addi/eori/cmpi
+      n += size == 2 ? 2 : 1, ea = ea_words(mode, reg, size);
+    break;
+
+  case 0x1: case 0x2: case 0x3: { // move/movea
+    int dmode = (op >> 6) & 7, dreg = (op >> 9) & 7;
+    int sz = (op >> 12) == 1 ? 0 : (op >> 12) == 3 ? 1 : 2;
+    ea = ea_words(mode, reg, sz);
+    if (ea < 0 || (dmode == 7 && dreg > 1))
+      return 0;
+    ea += ea_words(dmode, dreg, sz);
+    break;
+  }
+
+  case 0x4:
+    if ((op & 0xf1c0) == 0x41c0)      // lea
+      ea = ea_words(mode, reg, 2);
+    else if ((op & 0xf1c0) == 0x4180) // chk
+      ea = ea_words(mode, reg, 1);
+    else if (op & 0x100)
+      return 0;
+    else if ((op & 0xf900) == 0x4000) { // negx/clr/neg/not, move from/to sr
+      if ((op & 0xffc0) == 0x42c0)     // move from ccr
+        return 0;
+      ea = ea_words(mode, reg, size == 3 ? 1 : size);
+    }
+    else if ((op & 0xfff8) == 0x4840 || (op & 0xfeb8) == 0x4880)
+      ;                                 // swap, ext
+    else if ((op & 0xffc0) == 0x4800 || (op & 0xffc0) == 0x4840)
+      ea = ea_words(mode, reg, 0);      // nbcd, pea
+    else if ((op & 0xfb80) == 0x4880)   // movem
+      n = 2, ea = ea_words(mode, reg, 1);
+    else if ((op & 0xff00) == 0x4a00) { // tst, tas
+      if (op == 0x4afc)
+        return 0;
+      ea = ea_words(mode, reg, size == 3 ? 0 : size);
+    }
+    else if ((op & 0xfff8) == 0x4e50)   // link
+      n = 2;
+    else if ((op & 0xfff0) == 0x4e60 || (op & 0xfff8) == 0x4e58
+             || op == 0x4e70 || op == 0x4e71 || op == 0x4e76)
+      ;                                 // move usp, unlk, reset, nop, trapv
+    else
+      return 0;
+    break;
+
+  case 0x5:
+    if (size == 3 && mode == 1)         // dbcc
+      return 0;
+    ea = ea_words(mode, reg, size == 3 ? 0 : size);
+    break;
+
+  case 0x7:
+    if (op & 0x100)
+      return 0;
+    break;
+
+  case 0x8: case 0xc:
+    if (size == 3)                      // divu/divs/mulu/muls
+      ea = ea_words(mode, reg, 1);
+    else if ((op & 0x1f0) == 0x100)     // sbcd/abcd
+      ;
+    else if ((op & 0xf130) == 0xc100)   // exg
+      ;
+    else
+      ea = ea_words(mode, reg, size);
+    break;
+
+  case 0x9: case 0xb: case 0xd:
+    if (size == 3)                      // suba/cmpa/adda
+      ea = ea_words(mode, reg, (op & 0x100) ? 2 : 1);
+    else if ((op & 0x130) == 0x100 && (op >> 12) != 0xb)
+      ;                                 // subx/addx
+    else if ((op & 0x138) == 0x108 && (op >> 12) == 0xb)
+      ;                                 // cmpm
+    else
+      ea = ea_words(mode, reg, size);
+    break;
+
+  case 0xe:
+    if (size == 3)
+      ea = ea_words(mode, reg, 1);
+    break;
+
+  default:
+    return 0;
+  }
+
+  if (ea < 0)
+    return 0;
+  return n + ea;
+}
+
+// -------------------------------------------------------------------------
+// emitters
+
+static void emit_ctx_op_imm(int ext, int offs, u32 imm) // op [ctx + offs], imm
+{
+  emith_deref_op(0x81, ext, CONTEXT_REG, offs);
+  EMIT(imm, u32);
+}
+
+static void emit_ctx_move_imm(int offs, u32 imm)
+{
+  emith_deref_op(0xc7, 0, CONTEXT_REG, offs);
+  EMIT(imm, u32);
+}
+
+// r = 68k register at offs, zero or sign extended
+static void emit_load(int r, int offs, int size, int sext)
+{
+  if (size == 2) {
+    emith_ctx_read(r, offs);
+    return;
+  }
+  EMIT_OP(0x0f);
+  emith_deref_op((size ? 0xb7 : 0xb6) | (sext ? 8 : 0), r, CONTEXT_REG, offs);
+}
+
+static void emit_store(int r, int offs, int size)
+{
+  assert(size != 0 || is_abcdx(r));
+  if (size == 1)
+    EMIT(0x66, u8);
+  emith_deref_op(size ? 0x89 : 0x88, r, CONTEXT_REG, offs);
+}
+
+// op d, s with 68k operand size (op is the 32bit x86 "op r/m, r" opcode)
+static void emit_alu_r_r(int op, int size, int d, int s)
+{
+  if (size == 1)
+    EMIT(0x66, u8);
+  EMIT_OP_MODRM(size ? op : op - 1, 3, s, d);
+}
+
+static void emit_alu_r_imm(int ext, int size, int d, u32 imm)
+{
+  if (size == 1)
+    EMIT(0x66, u8);
+  EMIT_OP_MODRM(size ? 0x81 : 0x80, 3, ext, d);
+  if (size == 2)
+    EMIT(imm, u32);
+  else if (size == 1)
+    EMIT(imm, u16);
+  else
+    EMIT(imm, u8);
+}
+
+static void emit_shift_r_imm(int ext, int size, int d, int cnt)
+{
+  if (size == 1)
+    EMIT(0x66, u8);
+  EMIT_OP_MODRM(size ? 0xc1 : 0xc0, 3, ext, d);
+  EMIT(cnt, u8);
+}
+
+static void emit_unary_r(int ext, int size, int d) // not/neg
+{
+  if (size == 1)
+    EMIT(0x66, u8);
+  EMIT_OP_MODRM(size ? 0xf7 : 0xf6, 3, ext, d);
+}
+
+// N and Z from result in xDX, C = V = 0, FAME flag format
+static void emit_flags_nz(int size)
+{
+  emith_ctx_write(xDX, CTX(flag_NotZ));
+  if (size == 0)
+    emith_ctx_write(xDX, CTX(flag_N));
+  else {
+    emith_lsr(xAX, xDX, size == 2 ? 24 : 8);
+    emith_ctx_write(xAX, CTX(flag_N));
+  }
+  emit_ctx_move_imm(CTX(flag_C), 0);
+  emit_ctx_move_imm(CTX(flag_V), 0);
+}
+
+// flags from host flags of the last op, result in xDX
+static void emit_flags_host(int fl)
+{
+  EMIT_OP(0x9c); // pushf
+  emith_pop(xAX);
+  emith_ctx_write(xDX, CTX(flag_NotZ));
+  emith_move_r_r(xCX, xAX);
+  emith_and_r_imm(xCX, 1);
+  emith_lsl(xCX, xCX, 8);
+  emith_ctx_write(xCX, CTX(flag_C));
+  if (fl & FL_X)
+    emith_ctx_write(xCX, CTX(flag_X));
+  emith_move_r_r(xCX, xAX);
+  emith_and_r_imm(xCX, 0x80); // SF
+  emith_ctx_write(xCX, CTX(flag_N));
+  if (fl & FL_V) {
+    emith_lsr(xAX, xAX, 4);   // OF
+    emith_and_r_imm(xAX, 0x80);
+    emith_ctx_write(xAX, CTX(flag_V));
+  }
+  else
+    emit_ctx_move_imm(CTX(flag_V), 0);
+}
+
+// evaluate 68k condition, host Z flag clear if true
+static void emit_cond(int cc)
+{
+  int base = cc | 1; // ls, cs, eq, vs, mi, lt, le
+
+  switch (base) {
+  case 3: case 5:
+    emith_ctx_read(xAX, CTX(flag_C));
+    emith_lsr(xAX, xAX, 8);
+    break;
+  case 9:
+    emith_ctx_read(xAX, CTX(flag_V));
+    emith_lsr(xAX, xAX, 7);
+    break;
+  case 11:
+    emith_ctx_read(xAX, CTX(flag_N));
+    emith_lsr(xAX, xAX, 7);
+    break;
+  case 13: case 15:
+    emith_ctx_read(xAX, CTX(flag_N));
+    emith_deref_op(0x33, xAX, CONTEXT_REG, CTX(flag_V)); // xor eax, [V]
+    emith_lsr(xAX, xAX, 7);
+    break;
+  default:
+    emith_eor_r_r(xAX, xAX);
+    break;
+  }
+  emith_and_r_imm(xAX, 1);
+
+  if (base == 3 || base == 7 || base == 15) {
+    emit_ctx_op_imm(7, CTX(flag_NotZ), 0);
+    EMIT_OP(0x0f);
+    EMIT_OP_MODRM(0x94, 3, 0, xCX);   // sete cl
+    EMIT_OP(0x0f);
+    EMIT_OP_MODRM(0xb6, 3, xCX, xCX); // movzx ecx, cl
+    emith_or_r_r(xAX, xCX);
+  }
+  if (!(cc & 1))
+    emith_eor_r_imm(xAX, 1);
+  emith_tst_r_r(xAX, xAX);
+}
+
+static void emit_exit(int ret)
+{
+  if (ret)
+    emith_move_r_imm(xAX, ret);
+  else
+    emith_eor_r_r(xAX, xAX);
+  emith_sh2_drc_exit();
+}
+
+// leave block with PC at byte offset from block start
+static void emit_exit_pc(int offs)
+{
+  emith_add_r_r_ptr_imm(xAX, xBX, offs);
+  emith_ctx_write_ptr(xAX, CTX(PC));
+  emit_exit(0);
+}
+
+// take cycles, leave with PC at offs if we're out of them
+static void emit_cycles(int cycles, int offs)
+{
+  u8 *jmp;
+
+  emit_ctx_op_imm(5, CTX(io_cycle_counter), cycles); // sub
+  JMP8_POS(jmp);
+  emit_exit_pc(offs);
+  JMP8_EMIT(ICOND_JG, jmp);
+}
+
+// jump to insn already in this block, or leave
+static void emit_branch(int offs)
+{
+  if (offs >= 0 && offs / 2 < BLOCK_WORD_LIMIT && insn_ptrs[offs / 2] != NULL) {
+    emith_jump(insn_ptrs[offs / 2]);
+  }
+  else
+    emit_exit_pc(offs);
+}
+
+// call FAME handler for opcode at offs
+static void emit_interp(int offs)
+{
+  int arg0 = 0;
+
+  host_arg2reg(arg0, 0);
+  emith_add_r_r_ptr_imm(xAX, xBX, offs);
+  EMIT_OP(0x0f);
+  emith_deref_op(0xb7, xDX, xAX, 0);      // movzx edx, word [rax]
+  emith_add_r_r_ptr_imm(xAX, xAX, 2);
+  emith_ctx_write_ptr(xAX, CTX(PC));
+  emith_ctx_write(xDX, CTX(Opcode));
+  emith_move_r_r_ptr(arg0, CONTEXT_REG);
+  emith_move_r_imm64(xAX, (uintptr_t)fm68k_jump_table);
+  EMIT_OP_MODRM(0xff, 0, 2, 4);           // call [rax + rdx*8]
+  EMIT_SIB(3, xDX, xAX);
+}
+
+// leave if the handler ran out of cycles or went somewhere else
+static void emit_interp_check(int next_offs)
+{
+  u8 *jmp;
+
+  emit_ctx_op_imm(7, CTX(io_cycle_counter), 0); // cmp
+  JMP8_POS(jmp);
+  emit_exit(0);
+  JMP8_EMIT(ICOND_JG, jmp);
+
+  emith_add_r_r_ptr_imm(xCX, xBX, next_offs);
+  EMIT_REX_IF(1, xCX, CONTEXT_REG);
+  emith_deref_op(0x39, xCX, CONTEXT_REG, CTX(PC)); // cmp [ctx+PC], rcx
+  JMP8_POS(jmp);
+  emit_exit(0);
+  JMP8_EMIT(ICOND_JE, jmp);
+}
+
+// compare block source with what's in memory now
+static void emit_verify(const u16 *src, int words, u8 *stale)
+{
+  unsigned long long v64;
+  u32 v32;
+  int i;
+
+  for (i = 0; i + 4 <= words; i += 4) {
+    memcpy(&v64, src + i, sizeof(v64));
+    emith_move_r_imm64(xAX, v64);
+    EMIT_REX_IF(1, xAX, xBX);
+    emith_deref_op(0x39, xAX, xBX, i * 2); // cmp [rbx+offs], rax
+    emith_jump_cond(ICOND_JNE, stale);
+  }
+  if (i + 2 <= words) {
+    memcpy(&v32, src + i, sizeof(v32));
+    emith_deref_op(0x81, 7, xBX, i * 2);
+    EMIT(v32, u32);
+    emith_jump_cond(ICOND_JNE, stale);
+    i += 2;
+  }
+  if (i < words) {
+    EMIT(0x66, u8);
+    emith_deref_op(0x81, 7, xBX, i * 2);
+    EMIT(src[i], u16);
+    emith_jump_cond(ICOND_JNE, stale);
+  }
+}
+
+// -------------------------------------------------------------------------
+// native translations, return insn length or 0 if not handled.
+// Cycle counts follow famec_opcodes.h.
+
+static int emit_bcc(const u16 *p, int offs, int bank_lo, int bank_hi, int *end)
+{
+  u32 op = p[0];
+  int cc = (op >> 8) & 15;
+  int len = 1, disp = (s8)op, target;
+  u8 *jmp;
+
+  if (cc == 1) // bsr
+    return 0;
+  if (disp == 0)
+    disp = (s16)p[1], len = 2;
+  else if (disp == -1)
+    return 0;
+
+  // short backward bra/bne/beq may get patched by idle loop detection
+  if (len == 1 && disp < 0 && disp >= -16 && (cc == 0 || cc == 6 || cc == 7))
+    return 0;
+
+  target = offs + 2 + disp;
+  if ((disp & 1) || target < bank_lo || target >= bank_hi)
+    return 0;
+
+  if (cc == 0) {
+    emit_cycles(10, target);
+    emit_branch(target);
+    *end = 1;
+    return len;
+  }
+
+  emit_cond(cc);
+  jmp = tcache_ptr;
+  emith_jump_cond(ICOND_JE, tcache_ptr);
+  emit_cycles(10, target);
+  emit_branch(target);
+  emith_jump_patch(jmp, tcache_ptr);
+  emit_cycles(len == 1 ? 8 : 12, offs + len * 2);
+  return len;
+}
+
+static int emit_dbcc(const u16 *p, int offs, int bank_lo, int bank_hi)
+{
+  u32 op = p[0];
+  int cc = (op >> 8) & 15, r = op & 7;
+  int disp = (s16)p[1], target = offs + 2 + disp;
+  u8 *jmp_ct = NULL, *jmp_exp, *jmp_join;
+
+  if ((disp & 1) || target < bank_lo || target >= bank_hi)
+    return 0;
+
+  if (cc == 0) { // dbt
+    emit_cycles(12, offs + 4);
+    return 2;
+  }
+
+  emith_deref_op(0xc6, 0, CONTEXT_REG, CTX(not_polling));
+  EMIT(1, u8);
+  if (cc != 1) {
+    emit_cond(cc);
+    jmp_ct = tcache_ptr;
+    emith_jump_cond(ICOND_JNE, tcache_ptr);
+  }
+
+  emit_load(xDX, DREG_OFS(r), 1, 0);
+  emith_sub_r_imm(xDX, 1);
+  emit_store(xDX, DREG_OFS(r), 1);
+  emith_cmp_r_imm(xDX, 0xffffffff);
+  jmp_exp = tcache_ptr;
+  emith_jump_cond(ICOND_JE, tcache_ptr);
+  emit_cycles(10, target);
+  emit_branch(target);
+
+  emith_jump_patch(jmp_exp, tcache_ptr);
+  emit_cycles(14, offs + 4);
+  if (jmp_ct != NULL) {
+    jmp_join = tcache_ptr;
+    emith_jump(tcache_ptr);
+    emith_jump_patch(jmp_ct, tcache_ptr);
+    emit_cycles(12, offs + 4);
+    emith_jump_patch(jmp_join, tcache_ptr);
+  }
+  return 2;
+}
+
+static int emit_native(const u16 *p, int offs, int bank_lo, int bank_hi, int *end)
+{
+  u32 op = p[0];
+  int rx = (op >> 9) & 7, ry = op & 7, mode = (op >> 3) & 7;
+  int size = (op >> 6) & 3, len = 1, cycles;
+
+  switch (op >> 12) {
+  case 0x1: case 0x2: case 0x3: { // move Dn/An, movea Dn/An
+    int dmode = (op >> 6) & 7;
+    int sz = (op >> 12) == 1 ? 0 : (op >> 12) == 3 ? 1 : 2;
+    int src = mode ? AREG_OFS(ry) : DREG_OFS(ry);
+    if (mode > 1 || (mode == 1 && sz == 0))
+      return 0;
+    if (dmode == 0) {
+      emit_load(xDX, src, sz, 0);
+      emit_store(xDX, DREG_OFS(rx), sz);
+      emit_flags_nz(sz);
+    }
+    else if (dmode == 1 && sz != 0) {
+      emit_load(xDX, src, sz, 1);
+      emit_store(xDX, AREG_OFS(rx), 2);
+    }
+    else
+      return 0;
+    cycles = 4;
+    break;
+  }
+
+  case 0x4:
+    if ((op & 0xf1f8) == 0x41d0) {      // lea (An)
+      emith_ctx_read(xDX, AREG_OFS(ry));
+      emith_ctx_write(xDX, AREG_OFS(rx));
+      cycles = 4;
+    }
+    else if ((op & 0xf1f8) == 0x41e8) { // lea d16(An)
+      emith_ctx_read(xDX, AREG_OFS(ry));
+      emith_add_r_imm(xDX, (s16)p[1]);
+      emith_ctx_write(xDX, AREG_OFS(rx));
+      cycles = 8, len = 2;
+    }
+    else if ((op & 0xfff8) == 0x4840) { // swap
+      emith_ctx_read(xDX, DREG_OFS(ry));
+      emith_rol(xDX, xDX, 16);
+      emith_ctx_write(xDX, DREG_OFS(ry));
+      emit_flags_nz(2);
+      cycles = 4;
+    }
+    else if ((op & 0xfff8) == 0x4880) { // ext.w
+      emit_load(xDX, DREG_OFS(ry), 0, 1);
+      emit_store(xDX, DREG_OFS(ry), 1);
+      emit_flags_nz(1);
+      cycles = 4;
+    }
+    else if ((op & 0xfff8) == 0x48c0) { // ext.l
+      emit_load(xDX, DREG_OFS(ry), 1, 1);
+      emith_ctx_write(xDX, DREG_OFS(ry));
+      emit_flags_nz(2);
+      cycles = 4;
+    }
+    else if (op == 0x4e71)              // nop
+      cycles = 4;
+    else if (mode != 0 || size == 3)
+      return 0;
+    else if ((op & 0xff00) == 0x4a00) { // tst Dn
+      emit_load(xDX, DREG_OFS(ry), size, 0);
+      emit_flags_nz(size);
+      cycles = 4;
+    }
+    else if ((op & 0xff00) == 0x4200) { // clr Dn
+      emith_eor_r_r(xDX, xDX);
+      emit_store(xDX, DREG_OFS(ry), size);
+      emit_flags_nz(size);
+      cycles = size == 2 ? 6 : 4;
+    }
+    else if ((op & 0xff00) == 0x4600) { // not Dn
+      emit_load(xDX, DREG_OFS(ry), size, 0);
+      emit_unary_r(2, size, xDX);
+      emit_store(xDX, DREG_OFS(ry), size);
+      emit_flags_nz(size);
+      cycles = size == 2 ? 6 : 4;
+    }
+    else if ((op & 0xff00) == 0x4400) { // neg Dn
+      emit_load(xDX, DREG_OFS(ry), size, 0);
+      emit_unary_r(3, size, xDX);
+      emit_flags_host(FL_X | FL_V);
+      emit_store(xDX, DREG_OFS(ry), size);
+      cycles = size == 2 ? 6 : 4;
+    }
+    else
+      return 0;
+    break;
+
+  case 0x5:
+    if (size == 3) {
+      if (mode != 1)
+        return 0;
+      return emit_dbcc(p, offs, bank_lo, bank_hi);
+    }
+    else {                              // addq/subq
+      int imm = rx ? rx : 8, is_sub = op & 0x100;
+      if (mode == 0) {
+        emit_load(xDX, DREG_OFS(ry), size, 0);
+        emit_alu_r_imm(is_sub ? 5 : 0, size, xDX, imm);
+        emit_flags_host(FL_X | FL_V);
+        emit_store(xDX, DREG_OFS(ry), size);
+        cycles = size == 2 ? 8 : 4;
+      }
+      else if (mode == 1 && size != 0) {
+        emith_ctx_read(xDX, AREG_OFS(ry));
+        emith_arith_r_imm(is_sub ? 5 : 0, xDX, imm);
+        emith_ctx_write(xDX, AREG_OFS(ry));
+        cycles = (!is_sub && size == 1) ? 4 : 8;
+      }
+      else
+        return 0;
+    }
+    break;
+
+  case 0x6:
+    return emit_bcc(p, offs, bank_lo, bank_hi, end);
+
+  case 0x7:                             // moveq
+    if (op & 0x100)
+      return 0;
+    emit_ctx_move_imm(DREG_OFS(rx), (s8)op);
+    emit_ctx_move_imm(CTX(flag_NotZ), (s8)op);
+    emit_ctx_move_imm(CTX(flag_N), (s8)op);
+    emit_ctx_move_imm(CTX(flag_C), 0);
+    emit_ctx_move_imm(CTX(flag_V), 0);
+    cycles = 4;
+    break;
+
+  case 0x8: case 0x9: case 0xb: case 0xc: case 0xd: {
+    int top = op >> 12;
+    int src = mode ? AREG_OFS(ry) : DREG_OFS(ry);
+    if (mode > 1)
+      return 0;
+    if (size == 3) {                    // suba/cmpa/adda
+      if (top == 0x8 || top == 0xc)
+        return 0;
+      emit_load(xCX, src, (op & 0x100) ? 2 : 1, 1);
+      emith_ctx_read(xDX, AREG_OFS(rx));
+      if (top == 0xd)
+        emith_add_r_r(xDX, xCX);
+      else
+        emith_sub_r_r(xDX, xCX);
+      if (top == 0xb) {
+        emit_flags_host(FL_V);
+        cycles = 6;
+      }
+      else {
+        emith_ctx_write(xDX, AREG_OFS(rx));
+        cycles = 8;
+      }
+    }
+    else if (op & 0x100) {              // eor Dn,Dn
+      if (top != 0xb || mode != 0)
+        return 0;
+      emit_load(xDX, DREG_OFS(ry), size, 0);
+      emit_load(xCX, DREG_OFS(rx), size, 0);
+      emit_alu_r_r(0x31, size, xDX, xCX);
+      emit_store(xDX, DREG_OFS(ry), size);
+      emit_flags_nz(size);
+      cycles = size == 2 ? 8 : 4;
+    }
+    else {                              // or/sub/cmp/and/add Dn/An,Dn
+      if (mode == 1 && (size == 0 || top == 0x8 || top == 0xc))
+        return 0;
+      emit_load(xDX, DREG_OFS(rx), size, 0);
+      emit_load(xCX, src, size, 0);
+      switch (top) {
+      case 0x8: emit_alu_r_r(0x09, size, xDX, xCX); break;
+      case 0xc: emit_alu_r_r(0x21, size, xDX, xCX); break;
+      case 0xd: emit_alu_r_r(0x01, size, xDX, xCX); break;
+      default:  emit_alu_r_r(0x29, size, xDX, xCX); break;
+      }
+      if (top == 0x8 || top == 0xc) {
+        emit_flags_nz(size);
+        emit_store(xDX, DREG_OFS(rx), size);
+        cycles = size == 2 ? 8 : 4;
+      }
+      else if (top == 0xb) {
+        emit_flags_host(FL_V);
+        cycles = size == 2 ? 6 : 4;
+      }
+      else {
+        emit_flags_host(FL_X | FL_V);
+        emit_store(xDX, DREG_OFS(rx), size);
+        cycles = size == 2 ? 8 : 4;
+      }
+    }
+    break;
+  }
+
+  case 0xe: {                           // lsl/lsr/asr #imm,Dn
+    int cnt = rx ? rx : 8, type = (op >> 3) & 3, left = op & 0x100;
+    int ext;
+    if (size == 3 || (op & 0x20) || cnt >= (8 << size))
+      return 0;
+    if (type == 1)
+      ext = left ? 4 : 5;
+    else if (type == 0 && !left)
+      ext = 7;
+    else
+      return 0;
+    emit_load(xDX, DREG_OFS(ry), size, 0);
+    emit_shift_r_imm(ext, size, xDX, cnt);
+    emit_flags_host(FL_X);
+    emit_store(xDX, DREG_OFS(ry), size);
+    cycles = (size == 2 ? 8 : 6) + cnt * 2;
+    break;
+  }
+
+  default:
+    return 0;
+  }
+
+  emit_cycles(cycles, offs + len * 2);
+  return len;
+}
+
+// -------------------------------------------------------------------------
+
+static struct block_desc *block_translate(M68K_CONTEXT *ctx, struct block_desc *bd)
+{
+  const u16 *src = ctx->PC;
+  u32 pc = (uintptr_t)src - ctx->BasePC;
+  int bank_lo = -(int)(pc & 0xffff), bank_hi = 0x10000 - (pc & 0xffff);
+  u8 *block_start, *jmp_verify, *stale;
+  u8 insn_words[BLOCK_INSN_LIMIT];
+  u32 *entries;
+  int w, n, insns, end = 0, arg0 = 0, arg1 = 1, entry_cnt = 0;
+
+  if (tcache_ptr + MAX_BLOCK_SIZE > tcache_m68k + sizeof(tcache_m68k)
+      || block_count >= BLOCK_MAX_COUNT)
+  {
+    elprintf(EL_STATUS, "fm68k_drc: tcache or blocks full, flushing");
+    fm68k_drc_flush_all();
+    bd = NULL;
+  }
+  if (bd == NULL)
+    bd = block_new(src);
+
+  block_start = tcache_ptr;
+  memset(insn_ptrs, 0, sizeof(insn_ptrs));
+
+  // PC must be at block start, entry is where to go after verification
+  emith_sh2_drc_entry();
+  host_arg2reg(arg0, 0);
+  host_arg2reg(arg1, 1);
+  emith_move_r_r_ptr(CONTEXT_REG, arg0);
+  if (arg1 != xSI)
+    emith_move_r_r_ptr(xSI, arg1);
+  emith_ctx_read_ptr(xBX, CTX(PC));
+  jmp_verify = tcache_ptr;
+  emith_jump(tcache_ptr);
+
+  for (w = insns = 0; ; insns++)
+  {
+    int offs = w * 2;
+
+    if (insns >= BLOCK_INSN_LIMIT || w + MAX_INSN_WORDS > BLOCK_WORD_LIMIT
+        || offs + MAX_INSN_WORDS * 2 > bank_hi)
+    {
+      if (insns == 0)
+        goto interpret;
+      emit_exit_pc(offs);
+      break;
+    }
+
+    insn_ptrs[w] = tcache_ptr;
+    insn_words[entry_cnt++] = w;
+    n = emit_native(src + w, offs, bank_lo, bank_hi, &end);
+    if (n > 0) {
+      w += n;
+      if (end)
+        break;
+      continue;
+    }
+
+    n = op_len(src[w]);
+    if (n == 0 && insns == 0)
+      goto interpret;
+    emit_interp(offs);
+    if (n == 0) {
+      // flow change or unknown length, the handler decides where to go
+      emit_exit(0);
+      w++;
+      break;
+    }
+    emit_interp_check(offs + n * 2);
+    w += n;
+  }
+
+  stale = tcache_ptr;
+  emit_exit(1);
+  emith_jump_patch(jmp_verify, tcache_ptr);
+  emit_verify(src, w, stale);
+  emith_jump_reg(xSI);
+
+  // entry points for resuming in the middle of the block
+  tcache_ptr = (u8 *)(((uintptr_t)tcache_ptr + 3) & ~3);
+  entries = (u32 *)tcache_ptr;
+  for (n = 0; n < entry_cnt; n++)
+    entries[n] = (insn_words[n] << 24) | (insn_ptrs[insn_words[n]] - block_start);
+  tcache_ptr += entry_cnt * sizeof(entries[0]);
+
+  bd->code = (void *)block_start;
+  bd->entries = entries;
+  bd->insns = entry_cnt;
+  return bd;
+
+interpret:
+  tcache_ptr = block_start;
+  bd->code = NULL;
+  bd->op = src[0];
+  return bd;
+}
+
+static void interp_one(M68K_CONTEXT *ctx)
+{
+  ctx->Opcode = *ctx->PC++;
+  fm68k_jump_table[ctx->Opcode](ctx);
+}
+
+// host code for insn at pc inside bd, if it's one
+static const void *block_entry(const struct block_desc *bd, const u16 *pc)
+{
+  int i, w = pc - bd->src;
+
+  if (bd->code == NULL || w < 0 || w >= BLOCK_WORD_LIMIT)
+    return NULL;
+  for (i = 0; i < bd->insns; i++)
+    if ((bd->entries[i] >> 24) == w)
+      return (u8 *)bd->code + (bd->entries[i] & 0xffffff);
+
+  return NULL;
+}
+
+int fm68k_drc_execute(M68K_CONTEXT *ctx)
+{
+  struct block_desc *bd, *resume;
+  const void *entry;
+  u16 *pc;
+
+  if (!(PicoIn.opt & POPT_EN_DRC))
+    return 0;
+  if (drc_state == 0)
+    drc_init();
+  if (drc_state < 0)
+    return 0;
+
+  // the last run likely ran out of cycles in the middle of some block,
+  // continue in there instead of starting a new block at every exit point
+  resume = exit_block[CPU_IDX(ctx)];
+  exit_block[CPU_IDX(ctx)] = NULL;
+
+  for (;;)
+  {
+    pc = ctx->PC;
+    entry = NULL;
+    bd = block_find(pc);
+    if (bd == NULL && resume != NULL && (entry = block_entry(resume, pc)))
+      bd = resume;
+    else if (bd == NULL || (bd->code == NULL && bd->op != *pc))
+      bd = block_translate(ctx, bd);
+    resume = NULL;
+
+    if (bd->code != NULL) {
+      if (entry == NULL)
+        entry = block_entry(bd, bd->src);
+      ctx->PC = (u16 *)bd->src;
+      if (bd->code(ctx, entry) != 0) {
+        // 68k code changed since translation
+        bd = block_translate(ctx, bd);
+        ctx->PC = pc;
+        resume = bd;
+        continue;
+      }
+    }
+    else
+      interp_one(ctx);
+
+    if (ctx->io_cycle_counter <= 0)
+      break;
+  }
+
+  if (bd->code != NULL)
+    exit_block[CPU_IDX(ctx)] = bd;
+  return 1;
+}
+
+#endif // DRC_M68K
+
+// vim:shiftwidth=2:expandtab
@@ -0,0 +1,16 @@
+#include "fame.h"
+
+// only an x86-64 emitter is available for now
+#if defined(DRC_M68K) && !defined(__x86_64__)
+#undef DRC_M68K
+#endif
+
+#ifdef DRC_M68K
+extern void (*fm68k_jump_table[0x10000])(M68K_CONTEXT *ctx);
+
+int  fm68k_drc_execute(M68K_CONTEXT *ctx);
+void fm68k_drc_flush_all(void);
+#else
+#define fm68k_drc_execute(ctx) 0
+#define fm68k_drc_flush_all()
+#endif
@@ -147,6 +147,13 @@ typedef struct
 	unsigned char  pad[3];
 
 	uintptr_t      Fetch[M68K_FETCHBANK1];
+
+	// direct data access to work RAM (64K, mirrored over 0xe00000-0xffffff,
+	// NULL if not mapped like that) and to linear ROM from fast_rom_lo
+	unsigned char  *fast_ram;
+	unsigned char  *fast_rom;
+	unsigned int   fast_rom_lo;
+	unsigned int   fast_rom_len;
 } M68K_CONTEXT;
 
 typedef enum
@@ -172,6 +179,8 @@ unsigned int fm68k_get_pc(const M68K_CONTEXT *ctx);
 // PICODRIVE_HACK
 int fm68k_idle_install(void);
 int fm68k_idle_remove(void);
+void fm68k_predecode_setup(void *rom, unsigned int size);
+void fm68k_predecode_invalidate(unsigned int offs, unsigned int size);
 
 #ifdef __cplusplus
 }
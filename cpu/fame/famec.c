@@ -16,6 +16,7 @@
 #endif
 
 #include "fame.h"
+#include "compiler.h"
 
 
 // Options //
@@ -35,6 +36,11 @@
 #define PICODRIVE_HACK
 // Options //
 
+// the recompiler calls opcode handlers as functions
+#if defined(DRC_M68K) && !defined(FAMEC_NO_GOTOS)
+#define FAMEC_NO_GOTOS
+#endif
+
 #ifndef FAMEC_NO_GOTOS
 // computed gotos is a GNU extension
 #ifndef __GNUC__
@@ -287,10 +293,21 @@ typedef signed int	s32;
 
 #else
 
+// ROM code goes through the predecoded handler table, everything else
+// through JumpTable
 #define NEXT \
+    if (!fm68k_drc_execute(ctx)) \
     do { \
+        uptr pd_ofs = (uptr)PC - predecode_base; \
         FETCH_WORD(Opcode); \
-        JumpTable[Opcode](ctx); \
+        if (pd_ofs < predecode_size) { \
+            opcode_func op_ = predecode[pd_ofs >> 1]; \
+            if (op_ == NULL) \
+                op_ = predecode_op(pd_ofs >> 1, Opcode); \
+            op_(ctx); \
+        } \
+        else \
+            JumpTable[Opcode](ctx); \
     } while (ctx->io_cycle_counter > 0);
 
 #define RET(A) \
@@ -345,30 +362,99 @@ typedef signed int	s32;
 #define POST_IO                 \
 //    CCnt = io_cycle_counter;
 
+// work RAM and linear ROM are accessed directly if the host allows
+// (fast_* filled in by the memory setup), the rest through the handlers.
+// Memory is kept in host order 16bit words, hence the byte swizzle.
+#ifndef FAME_BIG_ENDIAN
+#define FAST_BYTE(A)	((A) ^ 1)
+#else
+#define FAST_BYTE(A)	(A)
+#endif
+#define FAST_RAM(A)	(((A) & 0xe00000) == 0xe00000 && ctx->fast_ram != NULL)
+#define FAST_ROM(A)	(((A) & 0xffffff) - ctx->fast_rom_lo < ctx->fast_rom_len)
+
+static FAMEC_EXTRA_INLINE u32 fm68k_read_byte(M68K_CONTEXT *ctx, u32 a)
+{
+	if (FAST_RAM(a))
+		return ctx->fast_ram[FAST_BYTE(a & 0xffff)];
+	if (FAST_ROM(a))
+		return ctx->fast_rom[FAST_BYTE(a & 0xffffff)];
+	return ctx->read_byte(a) & 0xFF;
+}
+
+static FAMEC_EXTRA_INLINE u32 fm68k_read_word(M68K_CONTEXT *ctx, u32 a)
+{
+	if (FAST_RAM(a))
+		return *(u16 *)(ctx->fast_ram + (a & 0xfffe));
+	if (FAST_ROM(a))
+		return *(u16 *)(ctx->fast_rom + (a & 0xfffffe));
+	return ctx->read_word(a) & 0xFFFF;
+}
+
+static FAMEC_EXTRA_INLINE u32 fm68k_read_long(M68K_CONTEXT *ctx, u32 a)
+{
+	u16 *m;
+	if (FAST_RAM(a) && (a & 0xfffe) != 0xfffe)
+		m = (u16 *)(ctx->fast_ram + (a & 0xfffe));
+	else if (FAST_ROM(a) && FAST_ROM(a + 2))
+		m = (u16 *)(ctx->fast_rom + (a & 0xfffffe));
+	else
+		return ctx->read_long(a);
+	return (m[0] << 16) | m[1];
+}
+
+static FAMEC_EXTRA_INLINE void fm68k_write_byte(M68K_CONTEXT *ctx, u32 a, u32 d)
+{
+	if (FAST_RAM(a))
+		ctx->fast_ram[FAST_BYTE(a & 0xffff)] = d;
+	else
+		ctx->write_byte(a, d);
+}
+
+static FAMEC_EXTRA_INLINE void fm68k_write_word(M68K_CONTEXT *ctx, u32 a, u32 d)
+{
+	if (FAST_RAM(a))
+		*(u16 *)(ctx->fast_ram + (a & 0xfffe)) = d;
+	else
+		ctx->write_word(a, d);
+}
+
+static FAMEC_EXTRA_INLINE void fm68k_write_long(M68K_CONTEXT *ctx, u32 a, u32 d)
+{
+	u16 *m;
+	if (FAST_RAM(a) && (a & 0xfffe) != 0xfffe) {
+		m = (u16 *)(ctx->fast_ram + (a & 0xfffe));
+		m[0] = d >> 16;
+		m[1] = d;
+	}
+	else
+		ctx->write_long(a, d);
+}
+
 #define READ_BYTE_F(A, D)           \
-	D = ctx->read_byte(A) & 0xFF;
+	D = fm68k_read_byte(ctx, A);
 
 #define READ_WORD_F(A, D)           \
-	D = ctx->read_word(A) & 0xFFFF;
+	D = fm68k_read_word(ctx, A);
 
 #define READ_LONG_F(A, D)           \
-	D = ctx->read_long(A);
+	D = fm68k_read_long(ctx, A);
 
 #define READSX_LONG_F READ_LONG_F
 
 #define WRITE_LONG_F(A, D)          \
-	ctx->write_long(A, D);
+	fm68k_write_long(ctx, A, D);
 
 #define WRITE_LONG_DEC_F(A, D)          \
-	ctx->write_word((A) + 2, (D) & 0xFFFF);    \
-	ctx->write_word((A), (D) >> 16);
+	fm68k_write_word(ctx, (A) + 2, (D) & 0xFFFF);    \
+	fm68k_write_word(ctx, (A), (D) >> 16);
 
 #define PUSH_32_F(D)                        \
 	AREG(7) -= 4;                               \
-	ctx->write_long(AREG(7), D);
+	fm68k_write_long(ctx, AREG(7), D);
 
 #define POP_32_F(D)                         \
-	D = ctx->read_long(AREG(7));         \
+	D = fm68k_read_long(ctx, AREG(7));         \
 	AREG(7) += 4;
 
 #ifndef FAME_BIG_ENDIAN
@@ -440,23 +526,23 @@ typedef signed int	s32;
 #endif
 
 #define READSX_BYTE_F(A, D)             \
-    D = (s8)ctx->read_byte(A);
+    D = (s8)fm68k_read_byte(ctx, A);
 
 #define READSX_WORD_F(A, D)             \
-    D = (s16)ctx->read_word(A);
+    D = (s16)fm68k_read_word(ctx, A);
 
 
 #define WRITE_BYTE_F(A, D)      \
-    ctx->write_byte(A, D);
+    fm68k_write_byte(ctx, A, D);
 
 #define WRITE_WORD_F(A, D)      \
-    ctx->write_word(A, D);
+    fm68k_write_word(ctx, A, D);
 
 #define PUSH_16_F(D)                    \
-    ctx->write_word(AREG(7) -= 2, D);   \
+    fm68k_write_word(ctx, AREG(7) -= 2, D);   \
 
 #define POP_16_F(D)                     \
-    D = (u16)ctx->read_word(AREG(7));   \
+    D = (u16)fm68k_read_word(ctx, AREG(7));   \
     AREG(7) += 2;
 
 #define GET_CCR                                     \
@@ -557,7 +643,28 @@ extern M68K_CONTEXT PicoCpuFS68k;
 /* Custom function handler */
 typedef void (*opcode_func)(M68K_CONTEXT *ctx);
 
+#ifdef DRC_M68K
+#define JumpTable fm68k_jump_table
+opcode_func JumpTable[0x10000];
+#else
 static opcode_func JumpTable[0x10000];
+#endif
+
+#ifdef FAMEC_NO_GOTOS
+// handlers for ROM resident code, one per 68k word, filled on first use.
+// Kept valid until ROM contents change (fm68k_predecode_invalidate()).
+static opcode_func *predecode;
+static uptr predecode_base;
+static uptr predecode_size;
+
+static opcode_func predecode_op(uptr i, u32 op)
+{
+	// the idle detector may swap handlers for these at any time
+	if ((op & 0xf100) != 0x7100 && (op & 0xf0f0) != 0x60f0)
+		predecode[i] = JumpTable[op];
+	return JumpTable[op];
+}
+#endif
 
 // exception cycle table (taken from musashi core)
 static const s32 exception_cycle_table[256] =
@@ -801,6 +908,42 @@ static FAMEC_EXTRA_INLINE u32 execute_exception_group_0(M68K_CONTEXT *ctx, s32 v
 #endif
 
 
+// ROM handler predecoding
+//////////////////////////
+
+void fm68k_predecode_setup(void *rom, u32 size)
+{
+#ifdef FAMEC_NO_GOTOS
+	free(predecode);
+	predecode = NULL;
+	predecode_base = predecode_size = 0;
+	if (rom == NULL || size < 2)
+		return;
+
+	// calloc leaves pages for unused ROM areas untouched
+	predecode = calloc(size / 2, sizeof(predecode[0]));
+	if (predecode == NULL)
+		return;
+	predecode_base = (uptr)rom;
+	predecode_size = size & ~1;
+#endif
+}
+
+void fm68k_predecode_invalidate(u32 offs, u32 size)
+{
+#ifdef FAMEC_NO_GOTOS
+	u32 end = offs + size;
+
+	if (offs >= predecode_size)
+		return;
+	if (end > predecode_size)
+		end = predecode_size;
+	offs >>= 1;
+	end = (end + 1) >> 1;
+	memset(predecode + offs, 0, (end - offs) * sizeof(predecode[0]));
+#endif
+}
+
 // main exec function
 //////////////////////
 
@@ -40040,18 +40040,15 @@ RET(14)
 }
 
 #ifdef PICODRIVE_HACK
-#if 0
 #define UPDATE_IDLE_COUNT { \
-	extern int idle_hit_counter; \
-	idle_hit_counter++; \
+	extern void SekRegisterIdleHit(unsigned int pc); \
+	SekRegisterIdleHit(GET_PC - 2); \
 }
-#else
-#define UPDATE_IDLE_COUNT
-#endif
 
 // BRA
 OPCODE(0x6001_idle)
 {
+	UPDATE_IDLE_COUNT
 #ifdef FAMEC_CHECK_BRANCHES
 	u32 newPC = GET_PC;
 	s8 offs=Opcode;
@@ -40061,7 +40058,6 @@ OPCODE(0x6001_idle)
 #else
 	PC += ((s8)(Opcode & 0xFE)) >> 1;
 #endif
-	UPDATE_IDLE_COUNT
 RET0()
 }
 
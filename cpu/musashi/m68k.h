@@ -301,8 +301,9 @@ void m68k_init(void);
  */
 void m68k_pulse_reset(void);
 
-/* execute num_cycles worth of instructions.  returns number of cycles used */
-int m68k_execute(int num_cycles);
+/* execute num_cycles worth of instructions on the cpu context (or the
+ * current one if NULL).  returns number of cycles used */
+int m68k_execute(void* context, int num_cycles);
 
 /* These functions let you read/write/modify the number of cycles left to run
  * while m68k_execute() is running.
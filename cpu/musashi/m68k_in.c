@@ -91,6 +91,8 @@ M68KMAKE_PROTOTYPE_HEADER
 #ifndef M68KOPS__HEADER
 #define M68KOPS__HEADER
 
+#include "m68kcpu.h"
+
 /* ======================================================================== */
 /* ============================ OPCODE HANDLERS =========================== */
 /* ======================================================================== */
@@ -104,7 +106,7 @@ M68KMAKE_PROTOTYPE_FOOTER
 /* Build the opcode handler table */
 void m68ki_build_opcode_table(void);
 
-extern void (*m68ki_instruction_jump_table[0x10000])(void); /* opcode handler jump table */
+extern void (*m68ki_instruction_jump_table[0x10000])(m68ki_cpu_core *m68ki_cpu_p); /* opcode handler jump table */
 extern unsigned char m68ki_cycles[][0x10000];
 
 
@@ -127,13 +129,13 @@ M68KMAKE_TABLE_HEADER
 
 #define NUM_CPU_TYPES 4
 
-void  (*m68ki_instruction_jump_table[0x10000])(void); /* opcode handler jump table */
+void  (*m68ki_instruction_jump_table[0x10000])(m68ki_cpu_core *m68ki_cpu_p); /* opcode handler jump table */
 unsigned char m68ki_cycles[NUM_CPU_TYPES][0x10000]; /* Cycles used by CPU type */
 
 /* This is used to generate the opcode handler jump table */
 typedef struct
 {
-	void (*opcode_handler)(void);        /* handler function */
+	void (*opcode_handler)(m68ki_cpu_core *m68ki_cpu_p); /* handler function */
 	unsigned int  mask;                  /* mask on opcode */
 	unsigned int  match;                 /* what to match after masking */
 	unsigned char cycles[NUM_CPU_TYPES]; /* cycles each cpu type takes */
@@ -879,13 +881,13 @@ M68KMAKE_OPCODE_HANDLER_BODY
 
 M68KMAKE_OP(1010, 0, ., .)
 {
-	m68ki_exception_1010();
+	m68ki_exception_1010(m68ki_cpu_p);
 }
 
 
 M68KMAKE_OP(1111, 0, ., .)
 {
-	m68ki_exception_1111();
+	m68ki_exception_1111(m68ki_cpu_p);
 }
 
 
@@ -896,7 +898,7 @@ M68KMAKE_OP(040fpu0, 32, ., .)
 		m68040_fpu_op0();
 		return;
 	}
-	m68ki_exception_1111();
+	m68ki_exception_1111(m68ki_cpu_p);
 }
 
 
@@ -907,7 +909,7 @@ M68KMAKE_OP(040fpu1, 32, ., .)
 		m68040_fpu_op1();
 		return;
 	}
-	m68ki_exception_1111();
+	m68ki_exception_1111(m68ki_cpu_p);
 }
 
 
@@ -942,7 +944,7 @@ M68KMAKE_OP(abcd, 8, rr, .)
 
 M68KMAKE_OP(abcd, 8, mm, ax7)
 {
-	uint src = OPER_AY_PD_8();
+	uint src = OPER_AY_PD_8(m68ki_cpu_p);
 	uint ea  = EA_A7_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = LOW_NIBBLE(src) + LOW_NIBBLE(dst) + XFLAG_AS_1();
@@ -970,7 +972,7 @@ M68KMAKE_OP(abcd, 8, mm, ax7)
 
 M68KMAKE_OP(abcd, 8, mm, ay7)
 {
-	uint src = OPER_A7_PD_8();
+	uint src = OPER_A7_PD_8(m68ki_cpu_p);
 	uint ea  = EA_AX_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = LOW_NIBBLE(src) + LOW_NIBBLE(dst) + XFLAG_AS_1();
@@ -998,7 +1000,7 @@ M68KMAKE_OP(abcd, 8, mm, ay7)
 
 M68KMAKE_OP(abcd, 8, mm, axy7)
 {
-	uint src = OPER_A7_PD_8();
+	uint src = OPER_A7_PD_8(m68ki_cpu_p);
 	uint ea  = EA_A7_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = LOW_NIBBLE(src) + LOW_NIBBLE(dst) + XFLAG_AS_1();
@@ -1026,7 +1028,7 @@ M68KMAKE_OP(abcd, 8, mm, axy7)
 
 M68KMAKE_OP(abcd, 8, mm, .)
 {
-	uint src = OPER_AY_PD_8();
+	uint src = OPER_AY_PD_8(m68ki_cpu_p);
 	uint ea  = EA_AX_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = LOW_NIBBLE(src) + LOW_NIBBLE(dst) + XFLAG_AS_1();
@@ -1543,7 +1545,7 @@ M68KMAKE_OP(addx, 32, rr, .)
 
 M68KMAKE_OP(addx, 8, mm, ax7)
 {
-	uint src = OPER_AY_PD_8();
+	uint src = OPER_AY_PD_8(m68ki_cpu_p);
 	uint ea  = EA_A7_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = src + dst + XFLAG_AS_1();
@@ -1561,7 +1563,7 @@ M68KMAKE_OP(addx, 8, mm, ax7)
 
 M68KMAKE_OP(addx, 8, mm, ay7)
 {
-	uint src = OPER_A7_PD_8();
+	uint src = OPER_A7_PD_8(m68ki_cpu_p);
 	uint ea  = EA_AX_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = src + dst + XFLAG_AS_1();
@@ -1579,7 +1581,7 @@ M68KMAKE_OP(addx, 8, mm, ay7)
 
 M68KMAKE_OP(addx, 8, mm, axy7)
 {
-	uint src = OPER_A7_PD_8();
+	uint src = OPER_A7_PD_8(m68ki_cpu_p);
 	uint ea  = EA_A7_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = src + dst + XFLAG_AS_1();
@@ -1597,7 +1599,7 @@ M68KMAKE_OP(addx, 8, mm, axy7)
 
 M68KMAKE_OP(addx, 8, mm, .)
 {
-	uint src = OPER_AY_PD_8();
+	uint src = OPER_AY_PD_8(m68ki_cpu_p);
 	uint ea  = EA_AX_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = src + dst + XFLAG_AS_1();
@@ -1615,7 +1617,7 @@ M68KMAKE_OP(addx, 8, mm, .)
 
 M68KMAKE_OP(addx, 16, mm, .)
 {
-	uint src = OPER_AY_PD_16();
+	uint src = OPER_AY_PD_16(m68ki_cpu_p);
 	uint ea  = EA_AX_PD_16();
 	uint dst = m68ki_read_16(ea);
 	uint res = src + dst + XFLAG_AS_1();
@@ -1633,7 +1635,7 @@ M68KMAKE_OP(addx, 16, mm, .)
 
 M68KMAKE_OP(addx, 32, mm, .)
 {
-	uint src = OPER_AY_PD_32();
+	uint src = OPER_AY_PD_32(m68ki_cpu_p);
 	uint ea  = EA_AX_PD_32();
 	uint dst = m68ki_read_32(ea);
 	uint res = src + dst + XFLAG_AS_1();
@@ -1828,7 +1830,7 @@ M68KMAKE_OP(andi, 32, ., .)
 
 M68KMAKE_OP(andi, 16, toc, .)
 {
-	m68ki_set_ccr(m68ki_get_ccr() & OPER_I_16());
+	m68ki_set_ccr(m68ki_cpu_p, m68ki_get_ccr() & OPER_I_16());
 }
 
 
@@ -1838,10 +1840,10 @@ M68KMAKE_OP(andi, 16, tos, .)
 	{
 		uint src = OPER_I_16();
 		m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
-		m68ki_set_sr(m68ki_get_sr() & src);
+		m68ki_set_sr(m68ki_cpu_p, m68ki_get_sr() & src);
 		return;
 	}
-	m68ki_exception_privilege_violation();
+	m68ki_exception_privilege_violation(m68ki_cpu_p);
 }
 
 
@@ -2277,7 +2279,7 @@ M68KMAKE_OP(bcc, 8, ., .)
 	if(M68KMAKE_CC)
 	{
 		m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
-		m68ki_branch_8(MASK_OUT_ABOVE_8(REG_IR));
+		m68ki_branch_8(m68ki_cpu_p, MASK_OUT_ABOVE_8(REG_IR));
 		return;
 	}
 	USE_CYCLES(CYC_BCC_NOTAKE_B);
@@ -2291,7 +2293,7 @@ M68KMAKE_OP(bcc, 16, ., .)
 		uint offset = OPER_I_16();
 		REG_PC -= 2;
 		m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
-		m68ki_branch_16(offset);
+		m68ki_branch_16(m68ki_cpu_p, offset);
 		return;
 	}
 	REG_PC += 2;
@@ -2308,7 +2310,7 @@ M68KMAKE_OP(bcc, 32, ., .)
 			uint offset = OPER_I_32();
 			REG_PC -= 4;
 			m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
-			m68ki_branch_32(offset);
+			m68ki_branch_32(m68ki_cpu_p, offset);
 			return;
 		}
 		REG_PC += 4;
@@ -2319,7 +2321,7 @@ M68KMAKE_OP(bcc, 32, ., .)
 		if(M68KMAKE_CC)
 		{
 			m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
-			m68ki_branch_8(MASK_OUT_ABOVE_8(REG_IR));
+			m68ki_branch_8(m68ki_cpu_p, MASK_OUT_ABOVE_8(REG_IR));
 			return;
 		}
 		USE_CYCLES(CYC_BCC_NOTAKE_B);
@@ -2442,7 +2444,7 @@ M68KMAKE_OP(bfchg, 32, ., d)
 
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -2496,7 +2498,7 @@ M68KMAKE_OP(bfchg, 32, ., .)
 		}
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -2533,7 +2535,7 @@ M68KMAKE_OP(bfclr, 32, ., d)
 
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -2587,7 +2589,7 @@ M68KMAKE_OP(bfclr, 32, ., .)
 		}
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -2621,7 +2623,7 @@ M68KMAKE_OP(bfexts, 32, ., d)
 
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -2669,7 +2671,7 @@ M68KMAKE_OP(bfexts, 32, ., .)
 
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -2703,7 +2705,7 @@ M68KMAKE_OP(bfextu, 32, ., d)
 
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -2750,7 +2752,7 @@ M68KMAKE_OP(bfextu, 32, ., .)
 
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -2788,7 +2790,7 @@ M68KMAKE_OP(bfffo, 32, ., d)
 
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -2840,7 +2842,7 @@ M68KMAKE_OP(bfffo, 32, ., .)
 
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -2882,7 +2884,7 @@ M68KMAKE_OP(bfins, 32, ., d)
 
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -2943,7 +2945,7 @@ M68KMAKE_OP(bfins, 32, ., .)
 		}
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -2980,7 +2982,7 @@ M68KMAKE_OP(bfset, 32, ., d)
 
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3035,7 +3037,7 @@ M68KMAKE_OP(bfset, 32, ., .)
 		}
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3070,7 +3072,7 @@ M68KMAKE_OP(bftst, 32, ., d)
 
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3121,7 +3123,7 @@ M68KMAKE_OP(bftst, 32, ., .)
 		}
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3131,14 +3133,14 @@ M68KMAKE_OP(bkpt, 0, ., .)
 	{
 		m68ki_bkpt_ack(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE) ? REG_IR & 7 : 0);	/* auto-disable (see m68kcpu.h) */
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
 M68KMAKE_OP(bra, 8, ., .)
 {
 	m68ki_trace_t0();				   /* auto-disable (see m68kcpu.h) */
-	m68ki_branch_8(MASK_OUT_ABOVE_8(REG_IR));
+	m68ki_branch_8(m68ki_cpu_p, MASK_OUT_ABOVE_8(REG_IR));
 	if(REG_PC == REG_PPC)
 		USE_ALL_CYCLES();
 }
@@ -3149,7 +3151,7 @@ M68KMAKE_OP(bra, 16, ., .)
 	uint offset = OPER_I_16();
 	REG_PC -= 2;
 	m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
-	m68ki_branch_16(offset);
+	m68ki_branch_16(m68ki_cpu_p, offset);
 	if(REG_PC == REG_PPC)
 		USE_ALL_CYCLES();
 }
@@ -3162,7 +3164,7 @@ M68KMAKE_OP(bra, 32, ., .)
 		uint offset = OPER_I_32();
 		REG_PC -= 4;
 		m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
-		m68ki_branch_32(offset);
+		m68ki_branch_32(m68ki_cpu_p, offset);
 		if(REG_PC == REG_PPC)
 			USE_ALL_CYCLES();
 		return;
@@ -3170,7 +3172,7 @@ M68KMAKE_OP(bra, 32, ., .)
 	else
 	{
 		m68ki_trace_t0();				   /* auto-disable (see m68kcpu.h) */
-		m68ki_branch_8(MASK_OUT_ABOVE_8(REG_IR));
+		m68ki_branch_8(m68ki_cpu_p, MASK_OUT_ABOVE_8(REG_IR));
 		if(REG_PC == REG_PPC)
 			USE_ALL_CYCLES();
 	}
@@ -3222,8 +3224,8 @@ M68KMAKE_OP(bset, 8, s, .)
 M68KMAKE_OP(bsr, 8, ., .)
 {
 	m68ki_trace_t0();				   /* auto-disable (see m68kcpu.h) */
-	m68ki_push_32(REG_PC);
-	m68ki_branch_8(MASK_OUT_ABOVE_8(REG_IR));
+	m68ki_push_32(m68ki_cpu_p, REG_PC);
+	m68ki_branch_8(m68ki_cpu_p, MASK_OUT_ABOVE_8(REG_IR));
 }
 
 
@@ -3231,9 +3233,9 @@ M68KMAKE_OP(bsr, 16, ., .)
 {
 	uint offset = OPER_I_16();
 	m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
-	m68ki_push_32(REG_PC);
+	m68ki_push_32(m68ki_cpu_p, REG_PC);
 	REG_PC -= 2;
-	m68ki_branch_16(offset);
+	m68ki_branch_16(m68ki_cpu_p, offset);
 }
 
 
@@ -3243,16 +3245,16 @@ M68KMAKE_OP(bsr, 32, ., .)
 	{
 		uint offset = OPER_I_32();
 		m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
-		m68ki_push_32(REG_PC);
+		m68ki_push_32(m68ki_cpu_p, REG_PC);
 		REG_PC -= 4;
-		m68ki_branch_32(offset);
+		m68ki_branch_32(m68ki_cpu_p, offset);
 		return;
 	}
 	else
 	{
 		m68ki_trace_t0();				   /* auto-disable (see m68kcpu.h) */
-		m68ki_push_32(REG_PC);
-		m68ki_branch_8(MASK_OUT_ABOVE_8(REG_IR));
+		m68ki_push_32(m68ki_cpu_p, REG_PC);
+		m68ki_branch_8(m68ki_cpu_p, MASK_OUT_ABOVE_8(REG_IR));
 	}
 }
 
@@ -3298,7 +3300,7 @@ M68KMAKE_OP(callm, 32, ., .)
 					 m68k_disassemble_quick(ADDRESS_68K(REG_PC - 2))));
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3327,7 +3329,7 @@ M68KMAKE_OP(cas, 8, ., .)
 		}
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3356,7 +3358,7 @@ M68KMAKE_OP(cas, 16, ., .)
 		}
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3385,7 +3387,7 @@ M68KMAKE_OP(cas, 32, ., .)
 		}
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3430,7 +3432,7 @@ M68KMAKE_OP(cas2, 16, ., .)
 		*compare2 = BIT_F(word2) ? MAKE_INT_16(dest2) : MASK_OUT_BELOW_16(*compare2) | dest2;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3475,7 +3477,7 @@ M68KMAKE_OP(cas2, 32, ., .)
 		*compare2 = dest2;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3493,7 +3495,7 @@ M68KMAKE_OP(chk, 16, ., d)
 		return;
 	}
 	FLAG_N = (src < 0)<<7;
-	m68ki_exception_trap(EXCEPTION_CHK);
+	m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 }
 
 
@@ -3511,7 +3513,7 @@ M68KMAKE_OP(chk, 16, ., .)
 		return;
 	}
 	FLAG_N = (src < 0)<<7;
-	m68ki_exception_trap(EXCEPTION_CHK);
+	m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 }
 
 
@@ -3531,10 +3533,10 @@ M68KMAKE_OP(chk, 32, ., d)
 			return;
 		}
 		FLAG_N = (src < 0)<<7;
-		m68ki_exception_trap(EXCEPTION_CHK);
+		m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3554,10 +3556,10 @@ M68KMAKE_OP(chk, 32, ., .)
 			return;
 		}
 		FLAG_N = (src < 0)<<7;
-		m68ki_exception_trap(EXCEPTION_CHK);
+		m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3579,16 +3581,16 @@ M68KMAKE_OP(chk2cmp2, 8, ., pcdi)
 		if(COND_CS())
 		{
 			if(BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 			return;
 		}
 
 		FLAG_C = upper_bound - compare;
 		if(COND_CS() && BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3610,16 +3612,16 @@ M68KMAKE_OP(chk2cmp2, 8, ., pcix)
 		if(COND_CS())
 		{
 			if(BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 			return;
 		}
 
 		FLAG_C = upper_bound - compare;
 		if(COND_CS() && BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3641,16 +3643,16 @@ M68KMAKE_OP(chk2cmp2, 8, ., .)
 		if(COND_CS())
 		{
 			if(BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 			return;
 		}
 
 		FLAG_C = upper_bound - compare;
 		if(COND_CS() && BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3673,7 +3675,7 @@ M68KMAKE_OP(chk2cmp2, 16, ., pcdi)
 		if(COND_CS())
 		{
 			if(BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 			return;
 		}
 
@@ -3683,10 +3685,10 @@ M68KMAKE_OP(chk2cmp2, 16, ., pcdi)
 			FLAG_C = upper_bound - compare;
 		FLAG_C = CFLAG_16(FLAG_C);
 		if(COND_CS() && BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3709,7 +3711,7 @@ M68KMAKE_OP(chk2cmp2, 16, ., pcix)
 		if(COND_CS())
 		{
 			if(BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 			return;
 		}
 
@@ -3719,10 +3721,10 @@ M68KMAKE_OP(chk2cmp2, 16, ., pcix)
 			FLAG_C = upper_bound - compare;
 		FLAG_C = CFLAG_16(FLAG_C);
 		if(COND_CS() && BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3746,7 +3748,7 @@ M68KMAKE_OP(chk2cmp2, 16, ., .)
 		if(COND_CS())
 		{
 			if(BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 			return;
 		}
 		if(!BIT_F(word2))
@@ -3756,10 +3758,10 @@ M68KMAKE_OP(chk2cmp2, 16, ., .)
 
 		FLAG_C = CFLAG_16(FLAG_C);
 		if(COND_CS() && BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3779,17 +3781,17 @@ M68KMAKE_OP(chk2cmp2, 32, ., pcdi)
 		if(COND_CS())
 		{
 			if(BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 			return;
 		}
 
 		FLAG_C = upper_bound - compare;
 		FLAG_C = CFLAG_SUB_32(compare, upper_bound, FLAG_C);
 		if(COND_CS() && BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3809,17 +3811,17 @@ M68KMAKE_OP(chk2cmp2, 32, ., pcix)
 		if(COND_CS())
 		{
 			if(BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 			return;
 		}
 
 		FLAG_C = upper_bound - compare;
 		FLAG_C = CFLAG_SUB_32(compare, upper_bound, FLAG_C);
 		if(COND_CS() && BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -3839,17 +3841,17 @@ M68KMAKE_OP(chk2cmp2, 32, ., .)
 		if(COND_CS())
 		{
 			if(BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 			return;
 		}
 
 		FLAG_C = upper_bound - compare;
 		FLAG_C = CFLAG_SUB_32(compare, upper_bound, FLAG_C);
 		if(COND_CS() && BIT_B(word2))
-				m68ki_exception_trap(EXCEPTION_CHK);
+				m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_CHK);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -4132,7 +4134,7 @@ M68KMAKE_OP(cmpi, 8, ., pcdi)
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
 		uint src = OPER_I_8();
-		uint dst = OPER_PCDI_8();
+		uint dst = OPER_PCDI_8(m68ki_cpu_p);
 		uint res = dst - src;
 
 		FLAG_N = NFLAG_8(res);
@@ -4141,7 +4143,7 @@ M68KMAKE_OP(cmpi, 8, ., pcdi)
 		FLAG_C = CFLAG_8(res);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -4150,7 +4152,7 @@ M68KMAKE_OP(cmpi, 8, ., pcix)
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
 		uint src = OPER_I_8();
-		uint dst = OPER_PCIX_8();
+		uint dst = OPER_PCIX_8(m68ki_cpu_p);
 		uint res = dst - src;
 
 		FLAG_N = NFLAG_8(res);
@@ -4159,7 +4161,7 @@ M68KMAKE_OP(cmpi, 8, ., pcix)
 		FLAG_C = CFLAG_8(res);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -4194,7 +4196,7 @@ M68KMAKE_OP(cmpi, 16, ., pcdi)
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
 		uint src = OPER_I_16();
-		uint dst = OPER_PCDI_16();
+		uint dst = OPER_PCDI_16(m68ki_cpu_p);
 		uint res = dst - src;
 
 		FLAG_N = NFLAG_16(res);
@@ -4203,7 +4205,7 @@ M68KMAKE_OP(cmpi, 16, ., pcdi)
 		FLAG_C = CFLAG_16(res);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -4212,7 +4214,7 @@ M68KMAKE_OP(cmpi, 16, ., pcix)
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
 		uint src = OPER_I_16();
-		uint dst = OPER_PCIX_16();
+		uint dst = OPER_PCIX_16(m68ki_cpu_p);
 		uint res = dst - src;
 
 		FLAG_N = NFLAG_16(res);
@@ -4221,7 +4223,7 @@ M68KMAKE_OP(cmpi, 16, ., pcix)
 		FLAG_C = CFLAG_16(res);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -4258,7 +4260,7 @@ M68KMAKE_OP(cmpi, 32, ., pcdi)
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
 		uint src = OPER_I_32();
-		uint dst = OPER_PCDI_32();
+		uint dst = OPER_PCDI_32(m68ki_cpu_p);
 		uint res = dst - src;
 
 		FLAG_N = NFLAG_32(res);
@@ -4267,7 +4269,7 @@ M68KMAKE_OP(cmpi, 32, ., pcdi)
 		FLAG_C = CFLAG_SUB_32(src, dst, res);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -4276,7 +4278,7 @@ M68KMAKE_OP(cmpi, 32, ., pcix)
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
 		uint src = OPER_I_32();
-		uint dst = OPER_PCIX_32();
+		uint dst = OPER_PCIX_32(m68ki_cpu_p);
 		uint res = dst - src;
 
 		FLAG_N = NFLAG_32(res);
@@ -4285,14 +4287,14 @@ M68KMAKE_OP(cmpi, 32, ., pcix)
 		FLAG_C = CFLAG_SUB_32(src, dst, res);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
 M68KMAKE_OP(cmpm, 8, ., ax7)
 {
-	uint src = OPER_AY_PI_8();
-	uint dst = OPER_A7_PI_8();
+	uint src = OPER_AY_PI_8(m68ki_cpu_p);
+	uint dst = OPER_A7_PI_8(m68ki_cpu_p);
 	uint res = dst - src;
 
 	FLAG_N = NFLAG_8(res);
@@ -4304,8 +4306,8 @@ M68KMAKE_OP(cmpm, 8, ., ax7)
 
 M68KMAKE_OP(cmpm, 8, ., ay7)
 {
-	uint src = OPER_A7_PI_8();
-	uint dst = OPER_AX_PI_8();
+	uint src = OPER_A7_PI_8(m68ki_cpu_p);
+	uint dst = OPER_AX_PI_8(m68ki_cpu_p);
 	uint res = dst - src;
 
 	FLAG_N = NFLAG_8(res);
@@ -4317,8 +4319,8 @@ M68KMAKE_OP(cmpm, 8, ., ay7)
 
 M68KMAKE_OP(cmpm, 8, ., axy7)
 {
-	uint src = OPER_A7_PI_8();
-	uint dst = OPER_A7_PI_8();
+	uint src = OPER_A7_PI_8(m68ki_cpu_p);
+	uint dst = OPER_A7_PI_8(m68ki_cpu_p);
 	uint res = dst - src;
 
 	FLAG_N = NFLAG_8(res);
@@ -4330,8 +4332,8 @@ M68KMAKE_OP(cmpm, 8, ., axy7)
 
 M68KMAKE_OP(cmpm, 8, ., .)
 {
-	uint src = OPER_AY_PI_8();
-	uint dst = OPER_AX_PI_8();
+	uint src = OPER_AY_PI_8(m68ki_cpu_p);
+	uint dst = OPER_AX_PI_8(m68ki_cpu_p);
 	uint res = dst - src;
 
 	FLAG_N = NFLAG_8(res);
@@ -4343,8 +4345,8 @@ M68KMAKE_OP(cmpm, 8, ., .)
 
 M68KMAKE_OP(cmpm, 16, ., .)
 {
-	uint src = OPER_AY_PI_16();
-	uint dst = OPER_AX_PI_16();
+	uint src = OPER_AY_PI_16(m68ki_cpu_p);
+	uint dst = OPER_AX_PI_16(m68ki_cpu_p);
 	uint res = dst - src;
 
 	FLAG_N = NFLAG_16(res);
@@ -4356,8 +4358,8 @@ M68KMAKE_OP(cmpm, 16, ., .)
 
 M68KMAKE_OP(cmpm, 32, ., .)
 {
-	uint src = OPER_AY_PI_32();
-	uint dst = OPER_AX_PI_32();
+	uint src = OPER_AY_PI_32(m68ki_cpu_p);
+	uint dst = OPER_AX_PI_32(m68ki_cpu_p);
 	uint res = dst - src;
 
 	FLAG_N = NFLAG_32(res);
@@ -4376,7 +4378,7 @@ M68KMAKE_OP(cpbcc, 32, ., .)
 					 m68k_disassemble_quick(ADDRESS_68K(REG_PC - 2))));
 		return;
 	}
-	m68ki_exception_1111();
+	m68ki_exception_1111(m68ki_cpu_p);
 }
 
 
@@ -4389,7 +4391,7 @@ M68KMAKE_OP(cpdbcc, 32, ., .)
 					 m68k_disassemble_quick(ADDRESS_68K(REG_PC - 2))));
 		return;
 	}
-	m68ki_exception_1111();
+	m68ki_exception_1111(m68ki_cpu_p);
 }
 
 
@@ -4402,7 +4404,7 @@ M68KMAKE_OP(cpgen, 32, ., .)
 					 m68k_disassemble_quick(ADDRESS_68K(REG_PC - 2))));
 		return;
 	}
-	m68ki_exception_1111();
+	m68ki_exception_1111(m68ki_cpu_p);
 }
 
 
@@ -4415,7 +4417,7 @@ M68KMAKE_OP(cpscc, 32, ., .)
 					 m68k_disassemble_quick(ADDRESS_68K(REG_PC - 2))));
 		return;
 	}
-	m68ki_exception_1111();
+	m68ki_exception_1111(m68ki_cpu_p);
 }
 
 
@@ -4428,7 +4430,7 @@ M68KMAKE_OP(cptrapcc, 32, ., .)
 					 m68k_disassemble_quick(ADDRESS_68K(REG_PC - 2))));
 		return;
 	}
-	m68ki_exception_1111();
+	m68ki_exception_1111(m68ki_cpu_p);
 }
 
 
@@ -4449,7 +4451,7 @@ M68KMAKE_OP(dbf, 16, ., .)
 		uint offset = OPER_I_16();
 		REG_PC -= 2;
 		m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
-		m68ki_branch_16(offset);
+		m68ki_branch_16(m68ki_cpu_p, offset);
 		USE_CYCLES(CYC_DBCC_F_NOEXP);
 		return;
 	}
@@ -4471,7 +4473,7 @@ M68KMAKE_OP(dbcc, 16, ., .)
 			uint offset = OPER_I_16();
 			REG_PC -= 2;
 			m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
-			m68ki_branch_16(offset);
+			m68ki_branch_16(m68ki_cpu_p, offset);
 			USE_CYCLES(CYC_DBCC_F_NOEXP);
 			return;
 		}
@@ -4517,7 +4519,7 @@ M68KMAKE_OP(divs, 16, ., d)
 		FLAG_V = VFLAG_SET;
 		return;
 	}
-	m68ki_exception_trap(EXCEPTION_ZERO_DIVIDE);
+	m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_ZERO_DIVIDE);
 }
 
 
@@ -4555,7 +4557,7 @@ M68KMAKE_OP(divs, 16, ., .)
 		FLAG_V = VFLAG_SET;
 		return;
 	}
-	m68ki_exception_trap(EXCEPTION_ZERO_DIVIDE);
+	m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_ZERO_DIVIDE);
 }
 
 
@@ -4581,7 +4583,7 @@ M68KMAKE_OP(divu, 16, ., d)
 		FLAG_V = VFLAG_SET;
 		return;
 	}
-	m68ki_exception_trap(EXCEPTION_ZERO_DIVIDE);
+	m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_ZERO_DIVIDE);
 }
 
 
@@ -4607,7 +4609,7 @@ M68KMAKE_OP(divu, 16, ., .)
 		FLAG_V = VFLAG_SET;
 		return;
 	}
-	m68ki_exception_trap(EXCEPTION_ZERO_DIVIDE);
+	m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_ZERO_DIVIDE);
 }
 
 
@@ -4676,10 +4678,10 @@ M68KMAKE_OP(divl, 32, ., d)
 			FLAG_C = CFLAG_CLEAR;
 			return;
 		}
-		m68ki_exception_trap(EXCEPTION_ZERO_DIVIDE);
+		m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_ZERO_DIVIDE);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 
 #else
 
@@ -4813,10 +4815,10 @@ M68KMAKE_OP(divl, 32, ., d)
 			FLAG_C = CFLAG_CLEAR;
 			return;
 		}
-		m68ki_exception_trap(EXCEPTION_ZERO_DIVIDE);
+		m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_ZERO_DIVIDE);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 
 #endif
 }
@@ -4887,10 +4889,10 @@ M68KMAKE_OP(divl, 32, ., .)
 			FLAG_C = CFLAG_CLEAR;
 			return;
 		}
-		m68ki_exception_trap(EXCEPTION_ZERO_DIVIDE);
+		m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_ZERO_DIVIDE);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 
 #else
 
@@ -5024,10 +5026,10 @@ M68KMAKE_OP(divl, 32, ., .)
 			FLAG_C = CFLAG_CLEAR;
 			return;
 		}
-		m68ki_exception_trap(EXCEPTION_ZERO_DIVIDE);
+		m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_ZERO_DIVIDE);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 
 #endif
 }
@@ -5188,7 +5190,7 @@ M68KMAKE_OP(eori, 32, ., .)
 
 M68KMAKE_OP(eori, 16, toc, .)
 {
-	m68ki_set_ccr(m68ki_get_ccr() ^ OPER_I_16());
+	m68ki_set_ccr(m68ki_cpu_p, m68ki_get_ccr() ^ OPER_I_16());
 }
 
 
@@ -5198,10 +5200,10 @@ M68KMAKE_OP(eori, 16, tos, .)
 	{
 		uint src = OPER_I_16();
 		m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
-		m68ki_set_sr(m68ki_get_sr() ^ src);
+		m68ki_set_sr(m68ki_cpu_p, m68ki_get_sr() ^ src);
 		return;
 	}
-	m68ki_exception_privilege_violation();
+	m68ki_exception_privilege_violation(m68ki_cpu_p);
 }
 
 
@@ -5275,18 +5277,18 @@ M68KMAKE_OP(extb, 32, ., .)
 		FLAG_C = CFLAG_CLEAR;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
 M68KMAKE_OP(illegal, 0, ., .)
 {
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 M68KMAKE_OP(jmp, 32, ., .)
 {
-	m68ki_jump(M68KMAKE_GET_EA_AY_32);
+	m68ki_jump(m68ki_cpu_p, M68KMAKE_GET_EA_AY_32);
 	m68ki_trace_t0();				   /* auto-disable (see m68kcpu.h) */
 	if(REG_PC == REG_PPC)
 		USE_ALL_CYCLES();
@@ -5297,8 +5299,8 @@ M68KMAKE_OP(jsr, 32, ., .)
 {
 	uint ea = M68KMAKE_GET_EA_AY_32;
 	m68ki_trace_t0();				   /* auto-disable (see m68kcpu.h) */
-	m68ki_push_32(REG_PC);
-	m68ki_jump(ea);
+	m68ki_push_32(m68ki_cpu_p, REG_PC);
+	m68ki_jump(m68ki_cpu_p, ea);
 }
 
 
@@ -5320,7 +5322,7 @@ M68KMAKE_OP(link, 16, ., .)
 {
 	uint* r_dst = &AY;
 
-	m68ki_push_32(*r_dst);
+	m68ki_push_32(m68ki_cpu_p, *r_dst);
 	*r_dst = REG_A[7];
 	REG_A[7] = MASK_OUT_ABOVE_32(REG_A[7] + MAKE_INT_16(OPER_I_16()));
 }
@@ -5335,7 +5337,7 @@ M68KMAKE_OP(link, 32, ., a7)
 		REG_A[7] = MASK_OUT_ABOVE_32(REG_A[7] + OPER_I_32());
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -5345,12 +5347,12 @@ M68KMAKE_OP(link, 32, ., .)
 	{
 		uint* r_dst = &AY;
 
-		m68ki_push_32(*r_dst);
+		m68ki_push_32(m68ki_cpu_p, *r_dst);
 		*r_dst = REG_A[7];
 		REG_A[7] = MASK_OUT_ABOVE_32(REG_A[7] + OPER_I_32());
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -6716,7 +6718,7 @@ M68KMAKE_OP(move, 16, frc, d)
 		DY = MASK_OUT_BELOW_16(DY) | m68ki_get_ccr();
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -6727,19 +6729,19 @@ M68KMAKE_OP(move, 16, frc, .)
 		m68ki_write_16(M68KMAKE_GET_EA_AY_16, m68ki_get_ccr());
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
 M68KMAKE_OP(move, 16, toc, d)
 {
-	m68ki_set_ccr(DY);
+	m68ki_set_ccr(m68ki_cpu_p, DY);
 }
 
 
 M68KMAKE_OP(move, 16, toc, .)
 {
-	m68ki_set_ccr(M68KMAKE_GET_OPER_AY_16);
+	m68ki_set_ccr(m68ki_cpu_p, M68KMAKE_GET_OPER_AY_16);
 }
 
 
@@ -6750,7 +6752,7 @@ M68KMAKE_OP(move, 16, frs, d)
 		DY = MASK_OUT_BELOW_16(DY) | m68ki_get_sr();
 		return;
 	}
-	m68ki_exception_privilege_violation();
+	m68ki_exception_privilege_violation(m68ki_cpu_p);
 }
 
 
@@ -6762,7 +6764,7 @@ M68KMAKE_OP(move, 16, frs, .)
 		m68ki_write_16(ea, m68ki_get_sr());
 		return;
 	}
-	m68ki_exception_privilege_violation();
+	m68ki_exception_privilege_violation(m68ki_cpu_p);
 }
 
 
@@ -6770,10 +6772,10 @@ M68KMAKE_OP(move, 16, tos, d)
 {
 	if(FLAG_S)
 	{
-		m68ki_set_sr(DY);
+		m68ki_set_sr(m68ki_cpu_p, DY);
 		return;
 	}
-	m68ki_exception_privilege_violation();
+	m68ki_exception_privilege_violation(m68ki_cpu_p);
 }
 
 
@@ -6783,10 +6785,10 @@ M68KMAKE_OP(move, 16, tos, .)
 	{
 		uint new_sr = M68KMAKE_GET_OPER_AY_16;
 		m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
-		m68ki_set_sr(new_sr);
+		m68ki_set_sr(m68ki_cpu_p, new_sr);
 		return;
 	}
-	m68ki_exception_privilege_violation();
+	m68ki_exception_privilege_violation(m68ki_cpu_p);
 }
 
 
@@ -6797,7 +6799,7 @@ M68KMAKE_OP(move, 32, fru, .)
 		AY = REG_USP;
 		return;
 	}
-	m68ki_exception_privilege_violation();
+	m68ki_exception_privilege_violation(m68ki_cpu_p);
 }
 
 
@@ -6809,7 +6811,7 @@ M68KMAKE_OP(move, 32, tou, .)
 		REG_USP = AY;
 		return;
 	}
-	m68ki_exception_privilege_violation();
+	m68ki_exception_privilege_violation(m68ki_cpu_p);
 }
 
 
@@ -6849,7 +6851,7 @@ M68KMAKE_OP(movec, 32, cr, .)
 					REG_DA[(word2 >> 12) & 15] = REG_CAAR;
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				break;
 			case 0x803:			   /* MSP */
 				if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
@@ -6857,7 +6859,7 @@ M68KMAKE_OP(movec, 32, cr, .)
 					REG_DA[(word2 >> 12) & 15] = FLAG_M ? REG_SP : REG_MSP;
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x804:			   /* ISP */
 				if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
@@ -6865,7 +6867,7 @@ M68KMAKE_OP(movec, 32, cr, .)
 					REG_DA[(word2 >> 12) & 15] = FLAG_M ? REG_ISP : REG_SP;
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x003:				/* TC */
 				if(CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -6873,7 +6875,7 @@ M68KMAKE_OP(movec, 32, cr, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x004:				/* ITT0 */
 				if(CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -6881,7 +6883,7 @@ M68KMAKE_OP(movec, 32, cr, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x005:				/* ITT1 */
 				if(CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -6889,7 +6891,7 @@ M68KMAKE_OP(movec, 32, cr, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x006:				/* DTT0 */
 				if(CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -6897,7 +6899,7 @@ M68KMAKE_OP(movec, 32, cr, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x007:				/* DTT1 */
 				if(CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -6905,7 +6907,7 @@ M68KMAKE_OP(movec, 32, cr, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x805:				/* MMUSR */
 				if(CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -6913,7 +6915,7 @@ M68KMAKE_OP(movec, 32, cr, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x806:				/* URP */
 				if(CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -6921,7 +6923,7 @@ M68KMAKE_OP(movec, 32, cr, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x807:				/* SRP */
 				if(CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -6929,17 +6931,17 @@ M68KMAKE_OP(movec, 32, cr, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			default:
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			}
 		}
-		m68ki_exception_privilege_violation();
+		m68ki_exception_privilege_violation(m68ki_cpu_p);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -6974,7 +6976,7 @@ M68KMAKE_OP(movec, 32, rc, .)
 					}
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x800:			   /* USP */
 				REG_USP = REG_DA[(word2 >> 12) & 15];
@@ -6988,7 +6990,7 @@ M68KMAKE_OP(movec, 32, rc, .)
 					REG_CAAR = REG_DA[(word2 >> 12) & 15];
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x803:			   /* MSP */
 				if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
@@ -7002,7 +7004,7 @@ M68KMAKE_OP(movec, 32, rc, .)
 					REG_SP = REG_DA[(word2 >> 12) & 15];
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x804:			   /* ISP */
 				if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
@@ -7015,7 +7017,7 @@ M68KMAKE_OP(movec, 32, rc, .)
 					REG_ISP = REG_DA[(word2 >> 12) & 15];
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x003:			/* TC */
 				if (CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -7023,7 +7025,7 @@ M68KMAKE_OP(movec, 32, rc, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x004:			/* ITT0 */
 				if (CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -7031,7 +7033,7 @@ M68KMAKE_OP(movec, 32, rc, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x005:			/* ITT1 */
 				if (CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -7039,7 +7041,7 @@ M68KMAKE_OP(movec, 32, rc, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x006:			/* DTT0 */
 				if (CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -7047,7 +7049,7 @@ M68KMAKE_OP(movec, 32, rc, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x007:			/* DTT1 */
 				if (CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -7055,7 +7057,7 @@ M68KMAKE_OP(movec, 32, rc, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x805:			/* MMUSR */
 				if (CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -7063,7 +7065,7 @@ M68KMAKE_OP(movec, 32, rc, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x806:			/* URP */
 				if (CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -7071,7 +7073,7 @@ M68KMAKE_OP(movec, 32, rc, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			case 0x807:			/* SRP */
 				if (CPU_TYPE_IS_040_PLUS(CPU_TYPE))
@@ -7079,17 +7081,17 @@ M68KMAKE_OP(movec, 32, rc, .)
 					/* TODO */
 					return;
 				}
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			default:
-				m68ki_exception_illegal();
+				m68ki_exception_illegal(m68ki_cpu_p);
 				return;
 			}
 		}
-		m68ki_exception_privilege_violation();
+		m68ki_exception_privilege_violation(m68ki_cpu_p);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -7382,26 +7384,26 @@ M68KMAKE_OP(moves, 8, ., .)
 			m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
 			if(BIT_B(word2))		   /* Register to memory */
 			{
-				m68ki_write_8_fc(ea, REG_DFC, MASK_OUT_ABOVE_8(REG_DA[(word2 >> 12) & 15]));
+				m68ki_write_8_fc(m68ki_cpu_p, ea, REG_DFC, MASK_OUT_ABOVE_8(REG_DA[(word2 >> 12) & 15]));
 				return;
 			}
 			if(BIT_F(word2))		   /* Memory to address register */
 			{
-				REG_A[(word2 >> 12) & 7] = MAKE_INT_8(m68ki_read_8_fc(ea, REG_SFC));
+				REG_A[(word2 >> 12) & 7] = MAKE_INT_8(m68ki_read_8_fc(m68ki_cpu_p, ea, REG_SFC));
 				if(CPU_TYPE_IS_020_VARIANT(CPU_TYPE))
 					USE_CYCLES(2);
 				return;
 			}
 			/* Memory to data register */
-			REG_D[(word2 >> 12) & 7] = MASK_OUT_BELOW_8(REG_D[(word2 >> 12) & 7]) | m68ki_read_8_fc(ea, REG_SFC);
+			REG_D[(word2 >> 12) & 7] = MASK_OUT_BELOW_8(REG_D[(word2 >> 12) & 7]) | m68ki_read_8_fc(m68ki_cpu_p, ea, REG_SFC);
 			if(CPU_TYPE_IS_020_VARIANT(CPU_TYPE))
 				USE_CYCLES(2);
 			return;
 		}
-		m68ki_exception_privilege_violation();
+		m68ki_exception_privilege_violation(m68ki_cpu_p);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -7417,26 +7419,26 @@ M68KMAKE_OP(moves, 16, ., .)
 			m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
 			if(BIT_B(word2))		   /* Register to memory */
 			{
-				m68ki_write_16_fc(ea, REG_DFC, MASK_OUT_ABOVE_16(REG_DA[(word2 >> 12) & 15]));
+				m68ki_write_16_fc(m68ki_cpu_p, ea, REG_DFC, MASK_OUT_ABOVE_16(REG_DA[(word2 >> 12) & 15]));
 				return;
 			}
 			if(BIT_F(word2))		   /* Memory to address register */
 			{
-				REG_A[(word2 >> 12) & 7] = MAKE_INT_16(m68ki_read_16_fc(ea, REG_SFC));
+				REG_A[(word2 >> 12) & 7] = MAKE_INT_16(m68ki_read_16_fc(m68ki_cpu_p, ea, REG_SFC));
 				if(CPU_TYPE_IS_020_VARIANT(CPU_TYPE))
 					USE_CYCLES(2);
 				return;
 			}
 			/* Memory to data register */
-			REG_D[(word2 >> 12) & 7] = MASK_OUT_BELOW_16(REG_D[(word2 >> 12) & 7]) | m68ki_read_16_fc(ea, REG_SFC);
+			REG_D[(word2 >> 12) & 7] = MASK_OUT_BELOW_16(REG_D[(word2 >> 12) & 7]) | m68ki_read_16_fc(m68ki_cpu_p, ea, REG_SFC);
 			if(CPU_TYPE_IS_020_VARIANT(CPU_TYPE))
 				USE_CYCLES(2);
 			return;
 		}
-		m68ki_exception_privilege_violation();
+		m68ki_exception_privilege_violation(m68ki_cpu_p);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -7452,21 +7454,21 @@ M68KMAKE_OP(moves, 32, ., .)
 			m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
 			if(BIT_B(word2))		   /* Register to memory */
 			{
-				m68ki_write_32_fc(ea, REG_DFC, REG_DA[(word2 >> 12) & 15]);
+				m68ki_write_32_fc(m68ki_cpu_p, ea, REG_DFC, REG_DA[(word2 >> 12) & 15]);
 				if(CPU_TYPE_IS_020_VARIANT(CPU_TYPE))
 					USE_CYCLES(2);
 				return;
 			}
 			/* Memory to register */
-			REG_DA[(word2 >> 12) & 15] = m68ki_read_32_fc(ea, REG_SFC);
+			REG_DA[(word2 >> 12) & 15] = m68ki_read_32_fc(m68ki_cpu_p, ea, REG_SFC);
 			if(CPU_TYPE_IS_020_VARIANT(CPU_TYPE))
 				USE_CYCLES(2);
 			return;
 		}
-		m68ki_exception_privilege_violation();
+		m68ki_exception_privilege_violation(m68ki_cpu_p);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -7601,7 +7603,7 @@ M68KMAKE_OP(mull, 32, ., d)
 		REG_D[(word2 >> 12) & 7] = MASK_OUT_ABOVE_32(res);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 
 #else
 
@@ -7671,7 +7673,7 @@ M68KMAKE_OP(mull, 32, ., d)
 			FLAG_V = (hi != 0) << 7;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 
 #endif
 }
@@ -7725,7 +7727,7 @@ M68KMAKE_OP(mull, 32, ., .)
 		REG_D[(word2 >> 12) & 7] = MASK_OUT_ABOVE_32(res);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 
 #else
 
@@ -7795,7 +7797,7 @@ M68KMAKE_OP(mull, 32, ., .)
 			FLAG_V = (hi != 0) << 7;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 
 #endif
 }
@@ -8329,7 +8331,7 @@ M68KMAKE_OP(ori, 32, ., .)
 
 M68KMAKE_OP(ori, 16, toc, .)
 {
-	m68ki_set_ccr(m68ki_get_ccr() | OPER_I_16());
+	m68ki_set_ccr(m68ki_cpu_p, m68ki_get_ccr() | OPER_I_16());
 }
 
 
@@ -8339,10 +8341,10 @@ M68KMAKE_OP(ori, 16, tos, .)
 	{
 		uint src = OPER_I_16();
 		m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
-		m68ki_set_sr(m68ki_get_sr() | src);
+		m68ki_set_sr(m68ki_cpu_p, m68ki_get_sr() | src);
 		return;
 	}
-	m68ki_exception_privilege_violation();
+	m68ki_exception_privilege_violation(m68ki_cpu_p);
 }
 
 
@@ -8357,7 +8359,7 @@ M68KMAKE_OP(pack, 16, rr, .)
 		*r_dst = MASK_OUT_BELOW_8(*r_dst) | ((src >> 4) & 0x00f0) | (src & 0x000f);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -8374,7 +8376,7 @@ M68KMAKE_OP(pack, 16, mm, ax7)
 		m68ki_write_8(EA_A7_PD_8(), ((src >> 4) & 0x00f0) | (src & 0x000f));
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -8391,7 +8393,7 @@ M68KMAKE_OP(pack, 16, mm, ay7)
 		m68ki_write_8(EA_AX_PD_8(), ((src >> 4) & 0x00f0) | (src & 0x000f));
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -8407,7 +8409,7 @@ M68KMAKE_OP(pack, 16, mm, axy7)
 		m68ki_write_8(EA_A7_PD_8(), ((src >> 4) & 0x00f0) | (src & 0x000f));
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -8424,7 +8426,7 @@ M68KMAKE_OP(pack, 16, mm, .)
 		m68ki_write_8(EA_AX_PD_8(), ((src >> 4) & 0x00f0) | (src & 0x000f));
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -8432,7 +8434,7 @@ M68KMAKE_OP(pea, 32, ., .)
 {
 	uint ea = M68KMAKE_GET_EA_AY_32;
 
-	m68ki_push_32(ea);
+	m68ki_push_32(m68ki_cpu_p, ea);
 }
 
 
@@ -8443,7 +8445,7 @@ M68KMAKE_OP(pflush, 32, ., .)
 		// Nothing to do, unless address translation cache is emulated
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -8455,7 +8457,7 @@ M68KMAKE_OP(reset, 0, ., .)
 		USE_CYCLES(CYC_RESET);
 		return;
 	}
-	m68ki_exception_privilege_violation();
+	m68ki_exception_privilege_violation(m68ki_cpu_p);
 }
 
 
@@ -9237,14 +9239,14 @@ M68KMAKE_OP(rtd, 32, ., .)
 {
 	if(CPU_TYPE_IS_010_PLUS(CPU_TYPE))
 	{
-		uint new_pc = m68ki_pull_32();
+		uint new_pc = m68ki_pull_32(m68ki_cpu_p);
 
 		m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
 		REG_A[7] = MASK_OUT_ABOVE_32(REG_A[7] + MAKE_INT_16(OPER_I_16()));
-		m68ki_jump(new_pc);
+		m68ki_jump(m68ki_cpu_p, new_pc);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -9261,10 +9263,10 @@ M68KMAKE_OP(rte, 32, ., .)
 
 		if(CPU_TYPE_IS_000(CPU_TYPE))
 		{
-			new_sr = m68ki_pull_16();
-			new_pc = m68ki_pull_32();
-			m68ki_jump(new_pc);
-			m68ki_set_sr(new_sr);
+			new_sr = m68ki_pull_16(m68ki_cpu_p);
+			new_pc = m68ki_pull_32(m68ki_cpu_p);
+			m68ki_jump(m68ki_cpu_p, new_pc);
+			m68ki_set_sr(m68ki_cpu_p, new_sr);
 
 			CPU_INSTR_MODE = INSTRUCTION_YES;
 			CPU_RUN_MODE = RUN_MODE_NORMAL;
@@ -9277,11 +9279,11 @@ M68KMAKE_OP(rte, 32, ., .)
 			format_word = m68ki_read_16(REG_A[7]+6) >> 12;
 			if(format_word == 0)
 			{
-				new_sr = m68ki_pull_16();
-				new_pc = m68ki_pull_32();
-				m68ki_fake_pull_16();	/* format word */
-				m68ki_jump(new_pc);
-				m68ki_set_sr(new_sr);
+				new_sr = m68ki_pull_16(m68ki_cpu_p);
+				new_pc = m68ki_pull_32(m68ki_cpu_p);
+				m68ki_fake_pull_16(m68ki_cpu_p);	/* format word */
+				m68ki_jump(m68ki_cpu_p, new_pc);
+				m68ki_set_sr(m68ki_cpu_p, new_sr);
 				CPU_INSTR_MODE = INSTRUCTION_YES;
 				CPU_RUN_MODE = RUN_MODE_NORMAL;
 				return;
@@ -9289,7 +9291,7 @@ M68KMAKE_OP(rte, 32, ., .)
 			CPU_INSTR_MODE = INSTRUCTION_YES;
 			CPU_RUN_MODE = RUN_MODE_NORMAL;
 			/* Not handling bus fault (9) */
-			m68ki_exception_format_error();
+			m68ki_exception_format_error(m68ki_cpu_p);
 			return;
 		}
 
@@ -9299,27 +9301,27 @@ rte_loop:
 		switch(format_word)
 		{
 			case 0: /* Normal */
-				new_sr = m68ki_pull_16();
-				new_pc = m68ki_pull_32();
-				m68ki_fake_pull_16();	/* format word */
-				m68ki_jump(new_pc);
-				m68ki_set_sr(new_sr);
+				new_sr = m68ki_pull_16(m68ki_cpu_p);
+				new_pc = m68ki_pull_32(m68ki_cpu_p);
+				m68ki_fake_pull_16(m68ki_cpu_p);	/* format word */
+				m68ki_jump(m68ki_cpu_p, new_pc);
+				m68ki_set_sr(m68ki_cpu_p, new_sr);
 				CPU_INSTR_MODE = INSTRUCTION_YES;
 				CPU_RUN_MODE = RUN_MODE_NORMAL;
 				return;
 			case 1: /* Throwaway */
-				new_sr = m68ki_pull_16();
-				m68ki_fake_pull_32();	/* program counter */
-				m68ki_fake_pull_16();	/* format word */
-				m68ki_set_sr_noint(new_sr);
+				new_sr = m68ki_pull_16(m68ki_cpu_p);
+				m68ki_fake_pull_32(m68ki_cpu_p);	/* program counter */
+				m68ki_fake_pull_16(m68ki_cpu_p);	/* format word */
+				m68ki_set_sr_noint(m68ki_cpu_p, new_sr);
 				goto rte_loop;
 			case 2: /* Trap */
-				new_sr = m68ki_pull_16();
-				new_pc = m68ki_pull_32();
-				m68ki_fake_pull_16();	/* format word */
-				m68ki_fake_pull_32();	/* address */
-				m68ki_jump(new_pc);
-				m68ki_set_sr(new_sr);
+				new_sr = m68ki_pull_16(m68ki_cpu_p);
+				new_pc = m68ki_pull_32(m68ki_cpu_p);
+				m68ki_fake_pull_16(m68ki_cpu_p);	/* format word */
+				m68ki_fake_pull_32(m68ki_cpu_p);	/* address */
+				m68ki_jump(m68ki_cpu_p, new_pc);
+				m68ki_set_sr(m68ki_cpu_p, new_sr);
 				CPU_INSTR_MODE = INSTRUCTION_YES;
 				CPU_RUN_MODE = RUN_MODE_NORMAL;
 				return;
@@ -9327,10 +9329,10 @@ rte_loop:
 		/* Not handling long or short bus fault */
 		CPU_INSTR_MODE = INSTRUCTION_YES;
 		CPU_RUN_MODE = RUN_MODE_NORMAL;
-		m68ki_exception_format_error();
+		m68ki_exception_format_error(m68ki_cpu_p);
 		return;
 	}
-	m68ki_exception_privilege_violation();
+	m68ki_exception_privilege_violation(m68ki_cpu_p);
 }
 
 
@@ -9344,22 +9346,22 @@ M68KMAKE_OP(rtm, 32, ., .)
 					 m68k_disassemble_quick(ADDRESS_68K(REG_PC - 2))));
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
 M68KMAKE_OP(rtr, 32, ., .)
 {
 	m68ki_trace_t0();				   /* auto-disable (see m68kcpu.h) */
-	m68ki_set_ccr(m68ki_pull_16());
-	m68ki_jump(m68ki_pull_32());
+	m68ki_set_ccr(m68ki_cpu_p, m68ki_pull_16(m68ki_cpu_p));
+	m68ki_jump(m68ki_cpu_p, m68ki_pull_32(m68ki_cpu_p));
 }
 
 
 M68KMAKE_OP(rts, 32, ., .)
 {
 	m68ki_trace_t0();				   /* auto-disable (see m68kcpu.h) */
-	m68ki_jump(m68ki_pull_32());
+	m68ki_jump(m68ki_cpu_p, m68ki_pull_32(m68ki_cpu_p));
 }
 
 
@@ -9397,7 +9399,7 @@ M68KMAKE_OP(sbcd, 8, rr, .)
 
 M68KMAKE_OP(sbcd, 8, mm, ax7)
 {
-	uint src = OPER_AY_PD_8();
+	uint src = OPER_AY_PD_8(m68ki_cpu_p);
 	uint ea  = EA_A7_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = LOW_NIBBLE(dst) - LOW_NIBBLE(src) - XFLAG_AS_1();
@@ -9429,7 +9431,7 @@ M68KMAKE_OP(sbcd, 8, mm, ax7)
 
 M68KMAKE_OP(sbcd, 8, mm, ay7)
 {
-	uint src = OPER_A7_PD_8();
+	uint src = OPER_A7_PD_8(m68ki_cpu_p);
 	uint ea  = EA_AX_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = LOW_NIBBLE(dst) - LOW_NIBBLE(src) - XFLAG_AS_1();
@@ -9461,7 +9463,7 @@ M68KMAKE_OP(sbcd, 8, mm, ay7)
 
 M68KMAKE_OP(sbcd, 8, mm, axy7)
 {
-	uint src = OPER_A7_PD_8();
+	uint src = OPER_A7_PD_8(m68ki_cpu_p);
 	uint ea  = EA_A7_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = LOW_NIBBLE(dst) - LOW_NIBBLE(src) - XFLAG_AS_1();
@@ -9493,7 +9495,7 @@ M68KMAKE_OP(sbcd, 8, mm, axy7)
 
 M68KMAKE_OP(sbcd, 8, mm, .)
 {
-	uint src = OPER_AY_PD_8();
+	uint src = OPER_AY_PD_8(m68ki_cpu_p);
 	uint ea  = EA_AX_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = LOW_NIBBLE(dst) - LOW_NIBBLE(src) - XFLAG_AS_1();
@@ -9572,11 +9574,11 @@ M68KMAKE_OP(stop, 0, ., .)
 		uint new_sr = OPER_I_16();
 		m68ki_trace_t0();			   /* auto-disable (see m68kcpu.h) */
 		CPU_STOPPED |= STOP_LEVEL_STOP;
-		m68ki_set_sr(new_sr);
+		m68ki_set_sr(m68ki_cpu_p, new_sr);
 		m68ki_remaining_cycles = 0;
 		return;
 	}
-	m68ki_exception_privilege_violation();
+	m68ki_exception_privilege_violation(m68ki_cpu_p);
 }
 
 
@@ -10070,7 +10072,7 @@ M68KMAKE_OP(subx, 32, rr, .)
 
 M68KMAKE_OP(subx, 8, mm, ax7)
 {
-	uint src = OPER_AY_PD_8();
+	uint src = OPER_AY_PD_8(m68ki_cpu_p);
 	uint ea  = EA_A7_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = dst - src - XFLAG_AS_1();
@@ -10088,7 +10090,7 @@ M68KMAKE_OP(subx, 8, mm, ax7)
 
 M68KMAKE_OP(subx, 8, mm, ay7)
 {
-	uint src = OPER_A7_PD_8();
+	uint src = OPER_A7_PD_8(m68ki_cpu_p);
 	uint ea  = EA_AX_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = dst - src - XFLAG_AS_1();
@@ -10106,7 +10108,7 @@ M68KMAKE_OP(subx, 8, mm, ay7)
 
 M68KMAKE_OP(subx, 8, mm, axy7)
 {
-	uint src = OPER_A7_PD_8();
+	uint src = OPER_A7_PD_8(m68ki_cpu_p);
 	uint ea  = EA_A7_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = dst - src - XFLAG_AS_1();
@@ -10124,7 +10126,7 @@ M68KMAKE_OP(subx, 8, mm, axy7)
 
 M68KMAKE_OP(subx, 8, mm, .)
 {
-	uint src = OPER_AY_PD_8();
+	uint src = OPER_AY_PD_8(m68ki_cpu_p);
 	uint ea  = EA_AX_PD_8();
 	uint dst = m68ki_read_8(ea);
 	uint res = dst - src - XFLAG_AS_1();
@@ -10142,7 +10144,7 @@ M68KMAKE_OP(subx, 8, mm, .)
 
 M68KMAKE_OP(subx, 16, mm, .)
 {
-	uint src = OPER_AY_PD_16();
+	uint src = OPER_AY_PD_16(m68ki_cpu_p);
 	uint ea  = EA_AX_PD_16();
 	uint dst = m68ki_read_16(ea);
 	uint res = dst - src - XFLAG_AS_1();
@@ -10160,7 +10162,7 @@ M68KMAKE_OP(subx, 16, mm, .)
 
 M68KMAKE_OP(subx, 32, mm, .)
 {
-	uint src = OPER_AY_PD_32();
+	uint src = OPER_AY_PD_32(m68ki_cpu_p);
 	uint ea  = EA_AX_PD_32();
 	uint dst = m68ki_read_32(ea);
 	uint res = dst - src - XFLAG_AS_1();
@@ -10226,7 +10228,7 @@ M68KMAKE_OP(tas, 8, ., .)
 M68KMAKE_OP(trap, 0, ., .)
 {
 	/* Trap#n stacks exception frame type 0 */
-	m68ki_exception_trapN(EXCEPTION_TRAP_BASE + (REG_IR & 0xf));	/* HJB 990403 */
+	m68ki_exception_trapN(m68ki_cpu_p, EXCEPTION_TRAP_BASE + (REG_IR & 0xf));	/* HJB 990403 */
 }
 
 
@@ -10234,10 +10236,10 @@ M68KMAKE_OP(trapt, 0, ., .)
 {
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
-		m68ki_exception_trap(EXCEPTION_TRAPV);	/* HJB 990403 */
+		m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_TRAPV);	/* HJB 990403 */
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10245,10 +10247,10 @@ M68KMAKE_OP(trapt, 16, ., .)
 {
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
-		m68ki_exception_trap(EXCEPTION_TRAPV);	/* HJB 990403 */
+		m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_TRAPV);	/* HJB 990403 */
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10256,10 +10258,10 @@ M68KMAKE_OP(trapt, 32, ., .)
 {
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
-		m68ki_exception_trap(EXCEPTION_TRAPV);	/* HJB 990403 */
+		m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_TRAPV);	/* HJB 990403 */
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10269,7 +10271,7 @@ M68KMAKE_OP(trapf, 0, ., .)
 	{
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10280,7 +10282,7 @@ M68KMAKE_OP(trapf, 16, ., .)
 		REG_PC += 2;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10291,7 +10293,7 @@ M68KMAKE_OP(trapf, 32, ., .)
 		REG_PC += 4;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10300,10 +10302,10 @@ M68KMAKE_OP(trapcc, 0, ., .)
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
 		if(M68KMAKE_CC)
-			m68ki_exception_trap(EXCEPTION_TRAPV);	/* HJB 990403 */
+			m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_TRAPV);	/* HJB 990403 */
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10313,13 +10315,13 @@ M68KMAKE_OP(trapcc, 16, ., .)
 	{
 		if(M68KMAKE_CC)
 		{
-			m68ki_exception_trap(EXCEPTION_TRAPV);	/* HJB 990403 */
+			m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_TRAPV);	/* HJB 990403 */
 			return;
 		}
 		REG_PC += 2;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10329,13 +10331,13 @@ M68KMAKE_OP(trapcc, 32, ., .)
 	{
 		if(M68KMAKE_CC)
 		{
-			m68ki_exception_trap(EXCEPTION_TRAPV);	/* HJB 990403 */
+			m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_TRAPV);	/* HJB 990403 */
 			return;
 		}
 		REG_PC += 4;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10345,7 +10347,7 @@ M68KMAKE_OP(trapv, 0, ., .)
 	{
 		return;
 	}
-	m68ki_exception_trap(EXCEPTION_TRAPV);  /* HJB 990403 */
+	m68ki_exception_trap(m68ki_cpu_p, EXCEPTION_TRAPV);  /* HJB 990403 */
 }
 
 
@@ -10375,7 +10377,7 @@ M68KMAKE_OP(tst, 8, ., pcdi)
 {
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
-		uint res = OPER_PCDI_8();
+		uint res = OPER_PCDI_8(m68ki_cpu_p);
 
 		FLAG_N = NFLAG_8(res);
 		FLAG_Z = res;
@@ -10383,7 +10385,7 @@ M68KMAKE_OP(tst, 8, ., pcdi)
 		FLAG_C = CFLAG_CLEAR;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10391,7 +10393,7 @@ M68KMAKE_OP(tst, 8, ., pcix)
 {
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
-		uint res = OPER_PCIX_8();
+		uint res = OPER_PCIX_8(m68ki_cpu_p);
 
 		FLAG_N = NFLAG_8(res);
 		FLAG_Z = res;
@@ -10399,7 +10401,7 @@ M68KMAKE_OP(tst, 8, ., pcix)
 		FLAG_C = CFLAG_CLEAR;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10415,7 +10417,7 @@ M68KMAKE_OP(tst, 8, ., i)
 		FLAG_C = CFLAG_CLEAR;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10442,7 +10444,7 @@ M68KMAKE_OP(tst, 16, ., a)
 		FLAG_C = CFLAG_CLEAR;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10461,7 +10463,7 @@ M68KMAKE_OP(tst, 16, ., pcdi)
 {
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
-		uint res = OPER_PCDI_16();
+		uint res = OPER_PCDI_16(m68ki_cpu_p);
 
 		FLAG_N = NFLAG_16(res);
 		FLAG_Z = res;
@@ -10469,7 +10471,7 @@ M68KMAKE_OP(tst, 16, ., pcdi)
 		FLAG_C = CFLAG_CLEAR;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10477,7 +10479,7 @@ M68KMAKE_OP(tst, 16, ., pcix)
 {
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
-		uint res = OPER_PCIX_16();
+		uint res = OPER_PCIX_16(m68ki_cpu_p);
 
 		FLAG_N = NFLAG_16(res);
 		FLAG_Z = res;
@@ -10485,7 +10487,7 @@ M68KMAKE_OP(tst, 16, ., pcix)
 		FLAG_C = CFLAG_CLEAR;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10501,7 +10503,7 @@ M68KMAKE_OP(tst, 16, ., i)
 		FLAG_C = CFLAG_CLEAR;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10528,7 +10530,7 @@ M68KMAKE_OP(tst, 32, ., a)
 		FLAG_C = CFLAG_CLEAR;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10547,7 +10549,7 @@ M68KMAKE_OP(tst, 32, ., pcdi)
 {
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
-		uint res = OPER_PCDI_32();
+		uint res = OPER_PCDI_32(m68ki_cpu_p);
 
 		FLAG_N = NFLAG_32(res);
 		FLAG_Z = res;
@@ -10555,7 +10557,7 @@ M68KMAKE_OP(tst, 32, ., pcdi)
 		FLAG_C = CFLAG_CLEAR;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10563,7 +10565,7 @@ M68KMAKE_OP(tst, 32, ., pcix)
 {
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
-		uint res = OPER_PCIX_32();
+		uint res = OPER_PCIX_32(m68ki_cpu_p);
 
 		FLAG_N = NFLAG_32(res);
 		FLAG_Z = res;
@@ -10571,7 +10573,7 @@ M68KMAKE_OP(tst, 32, ., pcix)
 		FLAG_C = CFLAG_CLEAR;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10587,7 +10589,7 @@ M68KMAKE_OP(tst, 32, ., i)
 		FLAG_C = CFLAG_CLEAR;
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10602,7 +10604,7 @@ M68KMAKE_OP(unlk, 32, ., .)
 	uint* r_dst = &AY;
 
 	REG_A[7] = *r_dst;
-	*r_dst = m68ki_pull_32();
+	*r_dst = m68ki_pull_32(m68ki_cpu_p);
 }
 
 
@@ -10617,7 +10619,7 @@ M68KMAKE_OP(unpk, 16, rr, .)
 		*r_dst = MASK_OUT_BELOW_16(*r_dst) | (((((src << 4) & 0x0f00) | (src & 0x000f)) + OPER_I_16()) & 0xffff);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10626,7 +10628,7 @@ M68KMAKE_OP(unpk, 16, mm, ax7)
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
 		/* Note: AX and AY are reversed in Motorola's docs */
-		uint src = OPER_AY_PD_8();
+		uint src = OPER_AY_PD_8(m68ki_cpu_p);
 		uint ea_dst;
 
 		src = (((src << 4) & 0x0f00) | (src & 0x000f)) + OPER_I_16();
@@ -10636,7 +10638,7 @@ M68KMAKE_OP(unpk, 16, mm, ax7)
 		m68ki_write_8(ea_dst, src & 0xff);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10645,7 +10647,7 @@ M68KMAKE_OP(unpk, 16, mm, ay7)
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
 		/* Note: AX and AY are reversed in Motorola's docs */
-		uint src = OPER_A7_PD_8();
+		uint src = OPER_A7_PD_8(m68ki_cpu_p);
 		uint ea_dst;
 
 		src = (((src << 4) & 0x0f00) | (src & 0x000f)) + OPER_I_16();
@@ -10655,7 +10657,7 @@ M68KMAKE_OP(unpk, 16, mm, ay7)
 		m68ki_write_8(ea_dst, src & 0xff);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10663,7 +10665,7 @@ M68KMAKE_OP(unpk, 16, mm, axy7)
 {
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
-		uint src = OPER_A7_PD_8();
+		uint src = OPER_A7_PD_8(m68ki_cpu_p);
 		uint ea_dst;
 
 		src = (((src << 4) & 0x0f00) | (src & 0x000f)) + OPER_I_16();
@@ -10673,7 +10675,7 @@ M68KMAKE_OP(unpk, 16, mm, axy7)
 		m68ki_write_8(ea_dst, src & 0xff);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
@@ -10682,7 +10684,7 @@ M68KMAKE_OP(unpk, 16, mm, .)
 	if(CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
 		/* Note: AX and AY are reversed in Motorola's docs */
-		uint src = OPER_AY_PD_8();
+		uint src = OPER_AY_PD_8(m68ki_cpu_p);
 		uint ea_dst;
 
 		src = (((src << 4) & 0x0f00) | (src & 0x000f)) + OPER_I_16();
@@ -10692,7 +10694,7 @@ M68KMAKE_OP(unpk, 16, mm, .)
 		m68ki_write_8(ea_dst, src & 0xff);
 		return;
 	}
-	m68ki_exception_illegal();
+	m68ki_exception_illegal(m68ki_cpu_p);
 }
 
 
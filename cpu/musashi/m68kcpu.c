@@ -601,8 +601,8 @@ void m68k_set_reg(m68k_register_t regnum, unsigned int value)
 		case M68K_REG_A5:	REG_A[5] = MASK_OUT_ABOVE_32(value); return;
 		case M68K_REG_A6:	REG_A[6] = MASK_OUT_ABOVE_32(value); return;
 		case M68K_REG_A7:	REG_A[7] = MASK_OUT_ABOVE_32(value); return;
-		case M68K_REG_PC:	m68ki_jump(MASK_OUT_ABOVE_32(value)); return;
-		case M68K_REG_SR:	m68ki_set_sr(value); return;
+		case M68K_REG_PC:	m68ki_jump(m68ki_cpu_p, MASK_OUT_ABOVE_32(value)); return;
+		case M68K_REG_SR:	m68ki_set_sr(m68ki_cpu_p, value); return;
 		case M68K_REG_SP:	REG_SP = MASK_OUT_ABOVE_32(value); return;
 		case M68K_REG_USP:	if(FLAG_S)
 								REG_USP = MASK_OUT_ABOVE_32(value);
@@ -785,13 +785,13 @@ void m68k_set_cpu_type(unsigned int cpu_type)
 
 /* Execute some instructions until we use up num_cycles clock cycles */
 /* ASG: removed per-instruction interrupt checks */
-int m68k_execute(int num_cycles)
+static int m68ki_execute(m68ki_cpu_core *m68ki_cpu_p, int num_cycles)
 {
 	/* Make sure we're not stopped */
 	if(!CPU_STOPPED)
 	{
 		// notaz
-		m68ki_check_interrupts();
+		m68ki_check_interrupts(m68ki_cpu_p);
 
 		/* Set our pool of clock cycles available */
 		SET_CYCLES(num_cycles);
@@ -824,8 +824,8 @@ int m68k_execute(int num_cycles)
 			REG_PPC = REG_PC;
 
 			/* Read an instruction and call its handler */
-			REG_IR = m68ki_read_imm_16();
-			m68ki_instruction_jump_table[REG_IR]();
+			REG_IR = m68ki_read_imm_16(m68ki_cpu_p);
+			m68ki_instruction_jump_table[REG_IR](m68ki_cpu_p);
 			USE_CYCLES(CYC_INSTRUCTION[REG_IR]); // moving this up may cause a deadlock
 
 			/* Trace m68k_exception, if necessary */
@@ -854,6 +854,21 @@ int m68k_execute(int num_cycles)
 	return num_cycles;
 }
 
+// the context is passed to the core directly, the global is only
+// switched for the host callbacks
+int m68k_execute(void* context, int num_cycles)
+{
+	m68ki_cpu_core *prev = m68ki_cpu_p;
+	int cycles;
+
+	if(context)
+		m68ki_cpu_p = context;
+	cycles = m68ki_execute(m68ki_cpu_p, num_cycles);
+	m68ki_cpu_p = prev;
+
+	return cycles;
+}
+
 
 int m68k_cycles_run(void)
 {
@@ -892,9 +907,9 @@ void m68k_set_irq(unsigned int int_level)
 	/* A transition from < 7 to 7 always interrupts (NMI) */
 	/* Note: Level 7 can also level trigger like a normal IRQ */
 	if(old_level != 0x0700 && CPU_INT_LEVEL == 0x0700)
-		m68ki_exception_interrupt(7); /* Edge triggered level 7 (NMI) */
+		m68ki_exception_interrupt(m68ki_cpu_p, 7); /* Edge triggered level 7 (NMI) */
 	else
-		m68ki_check_interrupts(); /* Level triggered (IRQ) */
+		m68ki_check_interrupts(m68ki_cpu_p); /* Level triggered (IRQ) */
 }
 
 void m68k_init(void)
@@ -936,7 +951,7 @@ void m68k_pulse_reset(void)
 	/* Reset VBR */
 	REG_VBR = 0;
 	/* Go to supervisor mode */
-	m68ki_set_sm_flag(SFLAG_SET | MFLAG_CLEAR);
+	m68ki_set_sm_flag(m68ki_cpu_p, SFLAG_SET | MFLAG_CLEAR);
 
 	/* Invalidate the prefetch queue */
 #if M68K_EMULATE_PREFETCH
@@ -945,10 +960,10 @@ void m68k_pulse_reset(void)
 #endif /* M68K_EMULATE_PREFETCH */
 
 	/* Read the initial stack pointer and program counter */
-	m68ki_jump(0);
-	REG_SP = m68ki_read_imm_32();
-	REG_PC = m68ki_read_imm_32();
-	m68ki_jump(REG_PC);
+	m68ki_jump(m68ki_cpu_p, 0);
+	REG_SP = m68ki_read_imm_32(m68ki_cpu_p);
+	REG_PC = m68ki_read_imm_32(m68ki_cpu_p);
+	m68ki_jump(m68ki_cpu_p, REG_PC);
 
 	CPU_RUN_MODE = RUN_MODE_NORMAL;
 }
@@ -1003,10 +1018,10 @@ static void m68k_prepare_substate(void)
 
 static void m68k_post_load(void)
 {
-	m68ki_set_sr_noint_nosp(m68k_substate.sr);
+	m68ki_set_sr_noint_nosp(m68ki_cpu_p, m68k_substate.sr);
 	CPU_STOPPED = m68k_substate.stopped ? STOP_LEVEL_STOP : 0
 		        | m68k_substate.halted  ? STOP_LEVEL_HALT : 0;
-	m68ki_jump(REG_PC);
+	m68ki_jump(m68ki_cpu_p, REG_PC);
 }
 
 void m68k_state_register(const char *type, int index)
@@ -551,7 +551,7 @@
 	/* Clear all tracing */
 	#define m68ki_clear_trace() m68ki_tracing = 0
 	/* Cause a trace exception if we are tracing */
-	#define m68ki_exception_if_trace() if(m68ki_tracing) m68ki_exception_trace()
+	#define m68ki_exception_if_trace() if(m68ki_tracing) m68ki_exception_trace(m68ki_cpu_p)
 #else
 	#define m68ki_trace_t1()
 	#define m68ki_trace_t0()
@@ -569,7 +569,7 @@
 	#define m68ki_set_address_error_trap() \
 		if(setjmp(m68ki_aerr_trap) != 0) \
 		{ \
-			m68ki_exception_address_error(); \
+			m68ki_exception_address_error(m68ki_cpu_p); \
 			if(CPU_STOPPED) \
 			{ \
 				SET_CYCLES(0); \
@@ -642,10 +642,10 @@
 #define EA_AY_PD_8()   (--AY)                                /* predecrement (size = byte) */
 #define EA_AY_PD_16()  (AY-=2)                               /* predecrement (size = word) */
 #define EA_AY_PD_32()  (AY-=4)                               /* predecrement (size = long) */
-#define EA_AY_DI_8()   (AY+MAKE_INT_16(m68ki_read_imm_16())) /* displacement */
+#define EA_AY_DI_8()   (AY+MAKE_INT_16(m68ki_read_imm_16(m68ki_cpu_p))) /* displacement */
 #define EA_AY_DI_16()  EA_AY_DI_8()
 #define EA_AY_DI_32()  EA_AY_DI_8()
-#define EA_AY_IX_8()   m68ki_get_ea_ix(AY)                   /* indirect + index */
+#define EA_AY_IX_8()   m68ki_get_ea_ix(m68ki_cpu_p, AY)                   /* indirect + index */
 #define EA_AY_IX_16()  EA_AY_IX_8()
 #define EA_AY_IX_32()  EA_AY_IX_8()
 
@@ -658,33 +658,33 @@
 #define EA_AX_PD_8()   (--AX)
 #define EA_AX_PD_16()  (AX-=2)
 #define EA_AX_PD_32()  (AX-=4)
-#define EA_AX_DI_8()   (AX+MAKE_INT_16(m68ki_read_imm_16()))
+#define EA_AX_DI_8()   (AX+MAKE_INT_16(m68ki_read_imm_16(m68ki_cpu_p)))
 #define EA_AX_DI_16()  EA_AX_DI_8()
 #define EA_AX_DI_32()  EA_AX_DI_8()
-#define EA_AX_IX_8()   m68ki_get_ea_ix(AX)
+#define EA_AX_IX_8()   m68ki_get_ea_ix(m68ki_cpu_p, AX)
 #define EA_AX_IX_16()  EA_AX_IX_8()
 #define EA_AX_IX_32()  EA_AX_IX_8()
 
 #define EA_A7_PI_8()   ((REG_A[7]+=2)-2)
 #define EA_A7_PD_8()   (REG_A[7]-=2)
 
-#define EA_AW_8()      MAKE_INT_16(m68ki_read_imm_16())      /* absolute word */
+#define EA_AW_8()      MAKE_INT_16(m68ki_read_imm_16(m68ki_cpu_p))      /* absolute word */
 #define EA_AW_16()     EA_AW_8()
 #define EA_AW_32()     EA_AW_8()
-#define EA_AL_8()      m68ki_read_imm_32()                   /* absolute long */
+#define EA_AL_8()      m68ki_read_imm_32(m68ki_cpu_p)                   /* absolute long */
 #define EA_AL_16()     EA_AL_8()
 #define EA_AL_32()     EA_AL_8()
-#define EA_PCDI_8()    m68ki_get_ea_pcdi()                   /* pc indirect + displacement */
+#define EA_PCDI_8()    m68ki_get_ea_pcdi(m68ki_cpu_p)                   /* pc indirect + displacement */
 #define EA_PCDI_16()   EA_PCDI_8()
 #define EA_PCDI_32()   EA_PCDI_8()
-#define EA_PCIX_8()    m68ki_get_ea_pcix()                   /* pc indirect + index */
+#define EA_PCIX_8()    m68ki_get_ea_pcix(m68ki_cpu_p)                   /* pc indirect + index */
 #define EA_PCIX_16()   EA_PCIX_8()
 #define EA_PCIX_32()   EA_PCIX_8()
 
 
 #define OPER_I_8()     m68ki_read_imm_8()
-#define OPER_I_16()    m68ki_read_imm_16()
-#define OPER_I_32()    m68ki_read_imm_32()
+#define OPER_I_16()    m68ki_read_imm_16(m68ki_cpu_p)
+#define OPER_I_32()    m68ki_read_imm_32(m68ki_cpu_p)
 
 
 
@@ -812,23 +812,23 @@
 /* ----------------------------- Read / Write ----------------------------- */
 
 /* Read from the current address space */
-#define m68ki_read_8(A)  m68ki_read_8_fc (A, FLAG_S | m68ki_get_address_space())
-#define m68ki_read_16(A) m68ki_read_16_fc(A, FLAG_S | m68ki_get_address_space())
-#define m68ki_read_32(A) m68ki_read_32_fc(A, FLAG_S | m68ki_get_address_space())
+#define m68ki_read_8(A)  m68ki_read_8_fc (m68ki_cpu_p, A, FLAG_S | m68ki_get_address_space())
+#define m68ki_read_16(A) m68ki_read_16_fc(m68ki_cpu_p, A, FLAG_S | m68ki_get_address_space())
+#define m68ki_read_32(A) m68ki_read_32_fc(m68ki_cpu_p, A, FLAG_S | m68ki_get_address_space())
 
 /* Write to the current data space */
-#define m68ki_write_8(A, V)  m68ki_write_8_fc (A, FLAG_S | FUNCTION_CODE_USER_DATA, V)
-#define m68ki_write_16(A, V) m68ki_write_16_fc(A, FLAG_S | FUNCTION_CODE_USER_DATA, V)
-#define m68ki_write_32(A, V) m68ki_write_32_fc(A, FLAG_S | FUNCTION_CODE_USER_DATA, V)
+#define m68ki_write_8(A, V)  m68ki_write_8_fc (m68ki_cpu_p, A, FLAG_S | FUNCTION_CODE_USER_DATA, V)
+#define m68ki_write_16(A, V) m68ki_write_16_fc(m68ki_cpu_p, A, FLAG_S | FUNCTION_CODE_USER_DATA, V)
+#define m68ki_write_32(A, V) m68ki_write_32_fc(m68ki_cpu_p, A, FLAG_S | FUNCTION_CODE_USER_DATA, V)
 
 #if M68K_SIMULATE_PD_WRITES
-#define m68ki_write_32_pd(A, V) m68ki_write_32_pd_fc(A, FLAG_S | FUNCTION_CODE_USER_DATA, V)
+#define m68ki_write_32_pd(A, V) m68ki_write_32_pd_fc(m68ki_cpu_p, A, FLAG_S | FUNCTION_CODE_USER_DATA, V)
 #else
-#define m68ki_write_32_pd(A, V) m68ki_write_32_fc(A, FLAG_S | FUNCTION_CODE_USER_DATA, V)
+#define m68ki_write_32_pd(A, V) m68ki_write_32_fc(m68ki_cpu_p, A, FLAG_S | FUNCTION_CODE_USER_DATA, V)
 #endif
 
 /* map read immediate 8 to read immediate 16 */
-#define m68ki_read_imm_8() MASK_OUT_ABOVE_8(m68ki_read_imm_16())
+#define m68ki_read_imm_8() MASK_OUT_ABOVE_8(m68ki_read_imm_16(m68ki_cpu_p))
 
 /* Map PC-relative reads */
 #define m68ki_read_pcrel_8(A) m68k_read_pcrelative_8(A)
@@ -836,14 +836,14 @@
 #define m68ki_read_pcrel_32(A) m68k_read_pcrelative_32(A)
 
 /* Read from the program space */
-#define m68ki_read_program_8(A) 	m68ki_read_8_fc(A, FLAG_S | FUNCTION_CODE_USER_PROGRAM)
-#define m68ki_read_program_16(A) 	m68ki_read_16_fc(A, FLAG_S | FUNCTION_CODE_USER_PROGRAM)
-#define m68ki_read_program_32(A) 	m68ki_read_32_fc(A, FLAG_S | FUNCTION_CODE_USER_PROGRAM)
+#define m68ki_read_program_8(A) 	m68ki_read_8_fc(m68ki_cpu_p, A, FLAG_S | FUNCTION_CODE_USER_PROGRAM)
+#define m68ki_read_program_16(A) 	m68ki_read_16_fc(m68ki_cpu_p, A, FLAG_S | FUNCTION_CODE_USER_PROGRAM)
+#define m68ki_read_program_32(A) 	m68ki_read_32_fc(m68ki_cpu_p, A, FLAG_S | FUNCTION_CODE_USER_PROGRAM)
 
 /* Read from the data space */
-#define m68ki_read_data_8(A) 	m68ki_read_8_fc(A, FLAG_S | FUNCTION_CODE_USER_DATA)
-#define m68ki_read_data_16(A) 	m68ki_read_16_fc(A, FLAG_S | FUNCTION_CODE_USER_DATA)
-#define m68ki_read_data_32(A) 	m68ki_read_32_fc(A, FLAG_S | FUNCTION_CODE_USER_DATA)
+#define m68ki_read_data_8(A) 	m68ki_read_8_fc(m68ki_cpu_p, A, FLAG_S | FUNCTION_CODE_USER_DATA)
+#define m68ki_read_data_16(A) 	m68ki_read_16_fc(m68ki_cpu_p, A, FLAG_S | FUNCTION_CODE_USER_DATA)
+#define m68ki_read_data_32(A) 	m68ki_read_32_fc(m68ki_cpu_p, A, FLAG_S | FUNCTION_CODE_USER_DATA)
 
 
 
@@ -921,9 +921,21 @@ typedef struct
 	// notaz
 	sint cyc_remaining_cycles;
 	sint not_polling;
+
+	/* Memory handlers, per cpu so that each one can have its own map */
+	unsigned int (*read_memory_8) (unsigned int address);
+	unsigned int (*read_memory_16)(unsigned int address);
+	unsigned int (*read_memory_32)(unsigned int address);
+	void (*write_memory_8) (unsigned int address, unsigned char  value);
+	void (*write_memory_16)(unsigned int address, unsigned short value);
+	void (*write_memory_32)(unsigned int address, unsigned int   value);
 } m68ki_cpu_core;
 
 // notaz
+// All internal functions and opcode handlers take the core they work on as
+// m68ki_cpu_p argument, which the register/flag macros below pick up. The
+// global of the same name is only used by the public API and is valid in
+// host callbacks while m68k_execute() runs.
 extern m68ki_cpu_core *m68ki_cpu_p;
 #define m68ki_cpu (*m68ki_cpu_p)
 #define m68ki_remaining_cycles m68ki_cpu_p->cyc_remaining_cycles
@@ -944,120 +956,120 @@ extern uint           m68ki_aerr_write_mode;
 extern uint           m68ki_aerr_fc;
 
 /* Read data immediately after the program counter */
-INLINE uint m68ki_read_imm_16(void);
-INLINE uint m68ki_read_imm_32(void);
+INLINE uint m68ki_read_imm_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint m68ki_read_imm_32(m68ki_cpu_core *m68ki_cpu_p);
 
 /* Read data with specific function code */
-INLINE uint m68ki_read_8_fc  (uint address, uint fc);
-INLINE uint m68ki_read_16_fc (uint address, uint fc);
-INLINE uint m68ki_read_32_fc (uint address, uint fc);
+INLINE uint m68ki_read_8_fc  (m68ki_cpu_core *m68ki_cpu_p, uint address, uint fc);
+INLINE uint m68ki_read_16_fc (m68ki_cpu_core *m68ki_cpu_p, uint address, uint fc);
+INLINE uint m68ki_read_32_fc (m68ki_cpu_core *m68ki_cpu_p, uint address, uint fc);
 
 /* Write data with specific function code */
-INLINE void m68ki_write_8_fc (uint address, uint fc, uint value);
-INLINE void m68ki_write_16_fc(uint address, uint fc, uint value);
-INLINE void m68ki_write_32_fc(uint address, uint fc, uint value);
+INLINE void m68ki_write_8_fc (m68ki_cpu_core *m68ki_cpu_p, uint address, uint fc, uint value);
+INLINE void m68ki_write_16_fc(m68ki_cpu_core *m68ki_cpu_p, uint address, uint fc, uint value);
+INLINE void m68ki_write_32_fc(m68ki_cpu_core *m68ki_cpu_p, uint address, uint fc, uint value);
 #if M68K_SIMULATE_PD_WRITES
-INLINE void m68ki_write_32_pd_fc(uint address, uint fc, uint value);
+INLINE void m68ki_write_32_pd_fc(m68ki_cpu_core *m68ki_cpu_p, uint address, uint fc, uint value);
 #endif /* M68K_SIMULATE_PD_WRITES */
 
 /* Indexed and PC-relative ea fetching */
-INLINE uint m68ki_get_ea_pcdi(void);
-INLINE uint m68ki_get_ea_pcix(void);
-INLINE uint m68ki_get_ea_ix(uint An);
+INLINE uint m68ki_get_ea_pcdi(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint m68ki_get_ea_pcix(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint m68ki_get_ea_ix(m68ki_cpu_core *m68ki_cpu_p, uint An);
 
 /* Operand fetching */
-INLINE uint OPER_AY_AI_8(void);
-INLINE uint OPER_AY_AI_16(void);
-INLINE uint OPER_AY_AI_32(void);
-INLINE uint OPER_AY_PI_8(void);
-INLINE uint OPER_AY_PI_16(void);
-INLINE uint OPER_AY_PI_32(void);
-INLINE uint OPER_AY_PD_8(void);
-INLINE uint OPER_AY_PD_16(void);
-INLINE uint OPER_AY_PD_32(void);
-INLINE uint OPER_AY_DI_8(void);
-INLINE uint OPER_AY_DI_16(void);
-INLINE uint OPER_AY_DI_32(void);
-INLINE uint OPER_AY_IX_8(void);
-INLINE uint OPER_AY_IX_16(void);
-INLINE uint OPER_AY_IX_32(void);
-
-INLINE uint OPER_AX_AI_8(void);
-INLINE uint OPER_AX_AI_16(void);
-INLINE uint OPER_AX_AI_32(void);
-INLINE uint OPER_AX_PI_8(void);
-INLINE uint OPER_AX_PI_16(void);
-INLINE uint OPER_AX_PI_32(void);
-INLINE uint OPER_AX_PD_8(void);
-INLINE uint OPER_AX_PD_16(void);
-INLINE uint OPER_AX_PD_32(void);
-INLINE uint OPER_AX_DI_8(void);
-INLINE uint OPER_AX_DI_16(void);
-INLINE uint OPER_AX_DI_32(void);
-INLINE uint OPER_AX_IX_8(void);
-INLINE uint OPER_AX_IX_16(void);
-INLINE uint OPER_AX_IX_32(void);
-
-INLINE uint OPER_A7_PI_8(void);
-INLINE uint OPER_A7_PD_8(void);
-
-INLINE uint OPER_AW_8(void);
-INLINE uint OPER_AW_16(void);
-INLINE uint OPER_AW_32(void);
-INLINE uint OPER_AL_8(void);
-INLINE uint OPER_AL_16(void);
-INLINE uint OPER_AL_32(void);
-INLINE uint OPER_PCDI_8(void);
-INLINE uint OPER_PCDI_16(void);
-INLINE uint OPER_PCDI_32(void);
-INLINE uint OPER_PCIX_8(void);
-INLINE uint OPER_PCIX_16(void);
-INLINE uint OPER_PCIX_32(void);
+INLINE uint OPER_AY_AI_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AY_AI_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AY_AI_32(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AY_PI_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AY_PI_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AY_PI_32(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AY_PD_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AY_PD_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AY_PD_32(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AY_DI_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AY_DI_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AY_DI_32(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AY_IX_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AY_IX_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AY_IX_32(m68ki_cpu_core *m68ki_cpu_p);
+
+INLINE uint OPER_AX_AI_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AX_AI_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AX_AI_32(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AX_PI_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AX_PI_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AX_PI_32(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AX_PD_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AX_PD_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AX_PD_32(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AX_DI_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AX_DI_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AX_DI_32(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AX_IX_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AX_IX_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AX_IX_32(m68ki_cpu_core *m68ki_cpu_p);
+
+INLINE uint OPER_A7_PI_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_A7_PD_8(m68ki_cpu_core *m68ki_cpu_p);
+
+INLINE uint OPER_AW_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AW_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AW_32(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AL_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AL_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_AL_32(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_PCDI_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_PCDI_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_PCDI_32(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_PCIX_8(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_PCIX_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint OPER_PCIX_32(m68ki_cpu_core *m68ki_cpu_p);
 
 /* Stack operations */
-INLINE void m68ki_push_16(uint value);
-INLINE void m68ki_push_32(uint value);
-INLINE uint m68ki_pull_16(void);
-INLINE uint m68ki_pull_32(void);
+INLINE void m68ki_push_16(m68ki_cpu_core *m68ki_cpu_p, uint value);
+INLINE void m68ki_push_32(m68ki_cpu_core *m68ki_cpu_p, uint value);
+INLINE uint m68ki_pull_16(m68ki_cpu_core *m68ki_cpu_p);
+INLINE uint m68ki_pull_32(m68ki_cpu_core *m68ki_cpu_p);
 
 /* Program flow operations */
-INLINE void m68ki_jump(uint new_pc);
-INLINE void m68ki_jump_vector(uint vector);
-INLINE void m68ki_branch_8(uint offset);
-INLINE void m68ki_branch_16(uint offset);
-INLINE void m68ki_branch_32(uint offset);
+INLINE void m68ki_jump(m68ki_cpu_core *m68ki_cpu_p, uint new_pc);
+INLINE void m68ki_jump_vector(m68ki_cpu_core *m68ki_cpu_p, uint vector);
+INLINE void m68ki_branch_8(m68ki_cpu_core *m68ki_cpu_p, uint offset);
+INLINE void m68ki_branch_16(m68ki_cpu_core *m68ki_cpu_p, uint offset);
+INLINE void m68ki_branch_32(m68ki_cpu_core *m68ki_cpu_p, uint offset);
 
 /* Status register operations. */
-INLINE void m68ki_set_s_flag(uint value);            /* Only bit 2 of value should be set (i.e. 4 or 0) */
-INLINE void m68ki_set_sm_flag(uint value);           /* only bits 1 and 2 of value should be set */
-INLINE void m68ki_set_ccr(uint value);               /* set the condition code register */
-INLINE void m68ki_set_sr(uint value);                /* set the status register */
-INLINE void m68ki_set_sr_noint(uint value);          /* set the status register */
+INLINE void m68ki_set_s_flag(m68ki_cpu_core *m68ki_cpu_p, uint value);            /* Only bit 2 of value should be set (i.e. 4 or 0) */
+INLINE void m68ki_set_sm_flag(m68ki_cpu_core *m68ki_cpu_p, uint value);           /* only bits 1 and 2 of value should be set */
+INLINE void m68ki_set_ccr(m68ki_cpu_core *m68ki_cpu_p, uint value);               /* set the condition code register */
+INLINE void m68ki_set_sr(m68ki_cpu_core *m68ki_cpu_p, uint value);                /* set the status register */
+INLINE void m68ki_set_sr_noint(m68ki_cpu_core *m68ki_cpu_p, uint value);          /* set the status register */
 
 /* Exception processing */
-INLINE uint m68ki_init_exception(void);              /* Initial exception processing */
-
-INLINE void m68ki_stack_frame_3word(uint pc, uint sr); /* Stack various frame types */
-INLINE void m68ki_stack_frame_buserr(uint sr);
-
-INLINE void m68ki_stack_frame_0000(uint pc, uint sr, uint vector);
-INLINE void m68ki_stack_frame_0001(uint pc, uint sr, uint vector);
-INLINE void m68ki_stack_frame_0010(uint sr, uint vector);
-INLINE void m68ki_stack_frame_1000(uint pc, uint sr, uint vector);
-INLINE void m68ki_stack_frame_1010(uint sr, uint vector, uint pc);
-INLINE void m68ki_stack_frame_1011(uint sr, uint vector, uint pc);
-
-INLINE void m68ki_exception_trap(uint vector);
-INLINE void m68ki_exception_trapN(uint vector);
-INLINE void m68ki_exception_trace(void);
-INLINE void m68ki_exception_privilege_violation(void);
-INLINE void m68ki_exception_1010(void);
-INLINE void m68ki_exception_1111(void);
-INLINE void m68ki_exception_illegal(void);
-INLINE void m68ki_exception_format_error(void);
-INLINE void m68ki_exception_address_error(void);
-INLINE void m68ki_exception_interrupt(uint int_level);
-INLINE void m68ki_check_interrupts(void);            /* ASG: check for interrupts */
+INLINE uint m68ki_init_exception(m68ki_cpu_core *m68ki_cpu_p);              /* Initial exception processing */
+
+INLINE void m68ki_stack_frame_3word(m68ki_cpu_core *m68ki_cpu_p, uint pc, uint sr); /* Stack various frame types */
+INLINE void m68ki_stack_frame_buserr(m68ki_cpu_core *m68ki_cpu_p, uint sr);
+
+INLINE void m68ki_stack_frame_0000(m68ki_cpu_core *m68ki_cpu_p, uint pc, uint sr, uint vector);
+INLINE void m68ki_stack_frame_0001(m68ki_cpu_core *m68ki_cpu_p, uint pc, uint sr, uint vector);
+INLINE void m68ki_stack_frame_0010(m68ki_cpu_core *m68ki_cpu_p, uint sr, uint vector);
+INLINE void m68ki_stack_frame_1000(m68ki_cpu_core *m68ki_cpu_p, uint pc, uint sr, uint vector);
+INLINE void m68ki_stack_frame_1010(m68ki_cpu_core *m68ki_cpu_p, uint sr, uint vector, uint pc);
+INLINE void m68ki_stack_frame_1011(m68ki_cpu_core *m68ki_cpu_p, uint sr, uint vector, uint pc);
+
+INLINE void m68ki_exception_trap(m68ki_cpu_core *m68ki_cpu_p, uint vector);
+INLINE void m68ki_exception_trapN(m68ki_cpu_core *m68ki_cpu_p, uint vector);
+INLINE void m68ki_exception_trace(m68ki_cpu_core *m68ki_cpu_p);
+INLINE void m68ki_exception_privilege_violation(m68ki_cpu_core *m68ki_cpu_p);
+INLINE void m68ki_exception_1010(m68ki_cpu_core *m68ki_cpu_p);
+INLINE void m68ki_exception_1111(m68ki_cpu_core *m68ki_cpu_p);
+INLINE void m68ki_exception_illegal(m68ki_cpu_core *m68ki_cpu_p);
+INLINE void m68ki_exception_format_error(m68ki_cpu_core *m68ki_cpu_p);
+INLINE void m68ki_exception_address_error(m68ki_cpu_core *m68ki_cpu_p);
+INLINE void m68ki_exception_interrupt(m68ki_cpu_core *m68ki_cpu_p, uint int_level);
+INLINE void m68ki_check_interrupts(m68ki_cpu_core *m68ki_cpu_p);            /* ASG: check for interrupts */
 
 /* quick disassembly (used for logging) */
 char* m68ki_disassemble_quick(unsigned int pc, unsigned int cpu_type);
@@ -1073,7 +1085,7 @@ char* m68ki_disassemble_quick(unsigned int pc, unsigned int cpu_type);
 /* Handles all immediate reads, does address error check, function code setting,
  * and prefetching if they are enabled in m68kconf.h
  */
-INLINE uint m68ki_read_imm_16(void)
+INLINE uint m68ki_read_imm_16(m68ki_cpu_core *m68ki_cpu_p)
 {
 	m68ki_set_fc(FLAG_S | FUNCTION_CODE_USER_PROGRAM); /* auto-disable (see m68kcpu.h) */
 	m68ki_check_address_error(REG_PC, MODE_READ, FLAG_S | FUNCTION_CODE_USER_PROGRAM); /* auto-disable (see m68kcpu.h) */
@@ -1090,7 +1102,7 @@ INLINE uint m68ki_read_imm_16(void)
 	return m68k_read_immediate_16(ADDRESS_68K(REG_PC-2));
 #endif /* M68K_EMULATE_PREFETCH */
 }
-INLINE uint m68ki_read_imm_32(void)
+INLINE uint m68ki_read_imm_32(m68ki_cpu_core *m68ki_cpu_p)
 {
 #if M68K_EMULATE_PREFETCH
 	uint temp_val;
@@ -1131,44 +1143,44 @@ INLINE uint m68ki_read_imm_32(void)
  * These functions will also check for address error and set the function
  * code if they are enabled in m68kconf.h.
  */
-INLINE uint m68ki_read_8_fc(uint address, uint fc)
+INLINE uint m68ki_read_8_fc(m68ki_cpu_core *m68ki_cpu_p, uint address, uint fc)
 {
 	m68ki_set_fc(fc); /* auto-disable (see m68kcpu.h) */
-	return m68k_read_memory_8(ADDRESS_68K(address));
+	return m68ki_cpu.read_memory_8(ADDRESS_68K(address)) & 0xff;
 }
-INLINE uint m68ki_read_16_fc(uint address, uint fc)
+INLINE uint m68ki_read_16_fc(m68ki_cpu_core *m68ki_cpu_p, uint address, uint fc)
 {
 	m68ki_set_fc(fc); /* auto-disable (see m68kcpu.h) */
 	m68ki_check_address_error_010_less(address, MODE_READ, fc); /* auto-disable (see m68kcpu.h) */
-	return m68k_read_memory_16(ADDRESS_68K(address));
+	return m68ki_cpu.read_memory_16(ADDRESS_68K(address)) & 0xffff;
 }
-INLINE uint m68ki_read_32_fc(uint address, uint fc)
+INLINE uint m68ki_read_32_fc(m68ki_cpu_core *m68ki_cpu_p, uint address, uint fc)
 {
 	m68ki_set_fc(fc); /* auto-disable (see m68kcpu.h) */
 	m68ki_check_address_error_010_less(address, MODE_READ, fc); /* auto-disable (see m68kcpu.h) */
-	return m68k_read_memory_32(ADDRESS_68K(address));
+	return m68ki_cpu.read_memory_32(ADDRESS_68K(address));
 }
 
-INLINE void m68ki_write_8_fc(uint address, uint fc, uint value)
+INLINE void m68ki_write_8_fc(m68ki_cpu_core *m68ki_cpu_p, uint address, uint fc, uint value)
 {
 	m68ki_set_fc(fc); /* auto-disable (see m68kcpu.h) */
-	m68k_write_memory_8(ADDRESS_68K(address), value);
+	m68ki_cpu.write_memory_8(ADDRESS_68K(address), value);
 }
-INLINE void m68ki_write_16_fc(uint address, uint fc, uint value)
+INLINE void m68ki_write_16_fc(m68ki_cpu_core *m68ki_cpu_p, uint address, uint fc, uint value)
 {
 	m68ki_set_fc(fc); /* auto-disable (see m68kcpu.h) */
 	m68ki_check_address_error_010_less(address, MODE_WRITE, fc); /* auto-disable (see m68kcpu.h) */
-	m68k_write_memory_16(ADDRESS_68K(address), value);
+	m68ki_cpu.write_memory_16(ADDRESS_68K(address), value);
 }
-INLINE void m68ki_write_32_fc(uint address, uint fc, uint value)
+INLINE void m68ki_write_32_fc(m68ki_cpu_core *m68ki_cpu_p, uint address, uint fc, uint value)
 {
 	m68ki_set_fc(fc); /* auto-disable (see m68kcpu.h) */
 	m68ki_check_address_error_010_less(address, MODE_WRITE, fc); /* auto-disable (see m68kcpu.h) */
-	m68k_write_memory_32(ADDRESS_68K(address), value);
+	m68ki_cpu.write_memory_32(ADDRESS_68K(address), value);
 }
 
 #if M68K_SIMULATE_PD_WRITES
-INLINE void m68ki_write_32_pd_fc(uint address, uint fc, uint value)
+INLINE void m68ki_write_32_pd_fc(m68ki_cpu_core *m68ki_cpu_p, uint address, uint fc, uint value)
 {
 	m68ki_set_fc(fc); /* auto-disable (see m68kcpu.h) */
 	m68ki_check_address_error_010_less(address, MODE_WRITE, fc); /* auto-disable (see m68kcpu.h) */
@@ -1182,18 +1194,18 @@ INLINE void m68ki_write_32_pd_fc(uint address, uint fc, uint value)
 /* The program counter relative addressing modes cause operands to be
  * retrieved from program space, not data space.
  */
-INLINE uint m68ki_get_ea_pcdi(void)
+INLINE uint m68ki_get_ea_pcdi(m68ki_cpu_core *m68ki_cpu_p)
 {
 	uint old_pc = REG_PC;
 	m68ki_use_program_space(); /* auto-disable */
-	return old_pc + MAKE_INT_16(m68ki_read_imm_16());
+	return old_pc + MAKE_INT_16(m68ki_read_imm_16(m68ki_cpu_p));
 }
 
 
-INLINE uint m68ki_get_ea_pcix(void)
+INLINE uint m68ki_get_ea_pcix(m68ki_cpu_core *m68ki_cpu_p)
 {
 	m68ki_use_program_space(); /* auto-disable */
-	return m68ki_get_ea_ix(REG_PC);
+	return m68ki_get_ea_ix(m68ki_cpu_p, REG_PC);
 }
 
 /* Indexed addressing modes are encoded as follows:
@@ -1238,10 +1250,10 @@ INLINE uint m68ki_get_ea_pcix(void)
  * 1  011  mem indir with long outer
  * 1  100-111  reserved
  */
-INLINE uint m68ki_get_ea_ix(uint An)
+INLINE uint m68ki_get_ea_ix(m68ki_cpu_core *m68ki_cpu_p, uint An)
 {
 	/* An = base register */
-	uint extension = m68ki_read_imm_16();
+	uint extension = m68ki_read_imm_16(m68ki_cpu_p);
 	uint Xn = 0;                        /* Index register */
 	uint bd = 0;                        /* Base Displacement */
 	uint od = 0;                        /* Outer Displacement */
@@ -1291,7 +1303,7 @@ INLINE uint m68ki_get_ea_ix(uint An)
 
 	/* Check if base displacement is present */
 	if(BIT_5(extension))                /* BD SIZE */
-		bd = BIT_4(extension) ? m68ki_read_imm_32() : MAKE_INT_16(m68ki_read_imm_16());
+		bd = BIT_4(extension) ? m68ki_read_imm_32(m68ki_cpu_p) : MAKE_INT_16(m68ki_read_imm_16(m68ki_cpu_p));
 
 	/* If no indirect action, we are done */
 	if(!(extension&7))                  /* No Memory Indirect */
@@ -1299,7 +1311,7 @@ INLINE uint m68ki_get_ea_ix(uint An)
 
 	/* Check if outer displacement is present */
 	if(BIT_1(extension))                /* I/IS:  od */
-		od = BIT_0(extension) ? m68ki_read_imm_32() : MAKE_INT_16(m68ki_read_imm_16());
+		od = BIT_0(extension) ? m68ki_read_imm_32(m68ki_cpu_p) : MAKE_INT_16(m68ki_read_imm_16(m68ki_cpu_p));
 
 	/* Postindex */
 	if(BIT_2(extension))                /* I/IS:  0 = preindex, 1 = postindex */
@@ -1311,78 +1323,78 @@ INLINE uint m68ki_get_ea_ix(uint An)
 
 
 /* Fetch operands */
-INLINE uint OPER_AY_AI_8(void)  {uint ea = EA_AY_AI_8();  return m68ki_read_8(ea); }
-INLINE uint OPER_AY_AI_16(void) {uint ea = EA_AY_AI_16(); return m68ki_read_16(ea);}
-INLINE uint OPER_AY_AI_32(void) {uint ea = EA_AY_AI_32(); return m68ki_read_32(ea);}
-INLINE uint OPER_AY_PI_8(void)  {uint ea = EA_AY_PI_8();  return m68ki_read_8(ea); }
-INLINE uint OPER_AY_PI_16(void) {uint ea = EA_AY_PI_16(); return m68ki_read_16(ea);}
-INLINE uint OPER_AY_PI_32(void) {uint ea = EA_AY_PI_32(); return m68ki_read_32(ea);}
-INLINE uint OPER_AY_PD_8(void)  {uint ea = EA_AY_PD_8();  return m68ki_read_8(ea); }
-INLINE uint OPER_AY_PD_16(void) {uint ea = EA_AY_PD_16(); return m68ki_read_16(ea);}
-INLINE uint OPER_AY_PD_32(void) {uint ea = EA_AY_PD_32(); return m68ki_read_32(ea);}
-INLINE uint OPER_AY_DI_8(void)  {uint ea = EA_AY_DI_8();  return m68ki_read_8(ea); }
-INLINE uint OPER_AY_DI_16(void) {uint ea = EA_AY_DI_16(); return m68ki_read_16(ea);}
-INLINE uint OPER_AY_DI_32(void) {uint ea = EA_AY_DI_32(); return m68ki_read_32(ea);}
-INLINE uint OPER_AY_IX_8(void)  {uint ea = EA_AY_IX_8();  return m68ki_read_8(ea); }
-INLINE uint OPER_AY_IX_16(void) {uint ea = EA_AY_IX_16(); return m68ki_read_16(ea);}
-INLINE uint OPER_AY_IX_32(void) {uint ea = EA_AY_IX_32(); return m68ki_read_32(ea);}
-
-INLINE uint OPER_AX_AI_8(void)  {uint ea = EA_AX_AI_8();  return m68ki_read_8(ea); }
-INLINE uint OPER_AX_AI_16(void) {uint ea = EA_AX_AI_16(); return m68ki_read_16(ea);}
-INLINE uint OPER_AX_AI_32(void) {uint ea = EA_AX_AI_32(); return m68ki_read_32(ea);}
-INLINE uint OPER_AX_PI_8(void)  {uint ea = EA_AX_PI_8();  return m68ki_read_8(ea); }
-INLINE uint OPER_AX_PI_16(void) {uint ea = EA_AX_PI_16(); return m68ki_read_16(ea);}
-INLINE uint OPER_AX_PI_32(void) {uint ea = EA_AX_PI_32(); return m68ki_read_32(ea);}
-INLINE uint OPER_AX_PD_8(void)  {uint ea = EA_AX_PD_8();  return m68ki_read_8(ea); }
-INLINE uint OPER_AX_PD_16(void) {uint ea = EA_AX_PD_16(); return m68ki_read_16(ea);}
-INLINE uint OPER_AX_PD_32(void) {uint ea = EA_AX_PD_32(); return m68ki_read_32(ea);}
-INLINE uint OPER_AX_DI_8(void)  {uint ea = EA_AX_DI_8();  return m68ki_read_8(ea); }
-INLINE uint OPER_AX_DI_16(void) {uint ea = EA_AX_DI_16(); return m68ki_read_16(ea);}
-INLINE uint OPER_AX_DI_32(void) {uint ea = EA_AX_DI_32(); return m68ki_read_32(ea);}
-INLINE uint OPER_AX_IX_8(void)  {uint ea = EA_AX_IX_8();  return m68ki_read_8(ea); }
-INLINE uint OPER_AX_IX_16(void) {uint ea = EA_AX_IX_16(); return m68ki_read_16(ea);}
-INLINE uint OPER_AX_IX_32(void) {uint ea = EA_AX_IX_32(); return m68ki_read_32(ea);}
-
-INLINE uint OPER_A7_PI_8(void)  {uint ea = EA_A7_PI_8();  return m68ki_read_8(ea); }
-INLINE uint OPER_A7_PD_8(void)  {uint ea = EA_A7_PD_8();  return m68ki_read_8(ea); }
-
-INLINE uint OPER_AW_8(void)     {uint ea = EA_AW_8();     return m68ki_read_8(ea); }
-INLINE uint OPER_AW_16(void)    {uint ea = EA_AW_16();    return m68ki_read_16(ea);}
-INLINE uint OPER_AW_32(void)    {uint ea = EA_AW_32();    return m68ki_read_32(ea);}
-INLINE uint OPER_AL_8(void)     {uint ea = EA_AL_8();     return m68ki_read_8(ea); }
-INLINE uint OPER_AL_16(void)    {uint ea = EA_AL_16();    return m68ki_read_16(ea);}
-INLINE uint OPER_AL_32(void)    {uint ea = EA_AL_32();    return m68ki_read_32(ea);}
-INLINE uint OPER_PCDI_8(void)   {uint ea = EA_PCDI_8();   return m68ki_read_pcrel_8(ea); }
-INLINE uint OPER_PCDI_16(void)  {uint ea = EA_PCDI_16();  return m68ki_read_pcrel_16(ea);}
-INLINE uint OPER_PCDI_32(void)  {uint ea = EA_PCDI_32();  return m68ki_read_pcrel_32(ea);}
-INLINE uint OPER_PCIX_8(void)   {uint ea = EA_PCIX_8();   return m68ki_read_pcrel_8(ea); }
-INLINE uint OPER_PCIX_16(void)  {uint ea = EA_PCIX_16();  return m68ki_read_pcrel_16(ea);}
-INLINE uint OPER_PCIX_32(void)  {uint ea = EA_PCIX_32();  return m68ki_read_pcrel_32(ea);}
+INLINE uint OPER_AY_AI_8(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_AY_AI_8();  return m68ki_read_8(ea); }
+INLINE uint OPER_AY_AI_16(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AY_AI_16(); return m68ki_read_16(ea);}
+INLINE uint OPER_AY_AI_32(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AY_AI_32(); return m68ki_read_32(ea);}
+INLINE uint OPER_AY_PI_8(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_AY_PI_8();  return m68ki_read_8(ea); }
+INLINE uint OPER_AY_PI_16(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AY_PI_16(); return m68ki_read_16(ea);}
+INLINE uint OPER_AY_PI_32(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AY_PI_32(); return m68ki_read_32(ea);}
+INLINE uint OPER_AY_PD_8(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_AY_PD_8();  return m68ki_read_8(ea); }
+INLINE uint OPER_AY_PD_16(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AY_PD_16(); return m68ki_read_16(ea);}
+INLINE uint OPER_AY_PD_32(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AY_PD_32(); return m68ki_read_32(ea);}
+INLINE uint OPER_AY_DI_8(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_AY_DI_8();  return m68ki_read_8(ea); }
+INLINE uint OPER_AY_DI_16(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AY_DI_16(); return m68ki_read_16(ea);}
+INLINE uint OPER_AY_DI_32(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AY_DI_32(); return m68ki_read_32(ea);}
+INLINE uint OPER_AY_IX_8(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_AY_IX_8();  return m68ki_read_8(ea); }
+INLINE uint OPER_AY_IX_16(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AY_IX_16(); return m68ki_read_16(ea);}
+INLINE uint OPER_AY_IX_32(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AY_IX_32(); return m68ki_read_32(ea);}
+
+INLINE uint OPER_AX_AI_8(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_AX_AI_8();  return m68ki_read_8(ea); }
+INLINE uint OPER_AX_AI_16(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AX_AI_16(); return m68ki_read_16(ea);}
+INLINE uint OPER_AX_AI_32(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AX_AI_32(); return m68ki_read_32(ea);}
+INLINE uint OPER_AX_PI_8(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_AX_PI_8();  return m68ki_read_8(ea); }
+INLINE uint OPER_AX_PI_16(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AX_PI_16(); return m68ki_read_16(ea);}
+INLINE uint OPER_AX_PI_32(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AX_PI_32(); return m68ki_read_32(ea);}
+INLINE uint OPER_AX_PD_8(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_AX_PD_8();  return m68ki_read_8(ea); }
+INLINE uint OPER_AX_PD_16(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AX_PD_16(); return m68ki_read_16(ea);}
+INLINE uint OPER_AX_PD_32(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AX_PD_32(); return m68ki_read_32(ea);}
+INLINE uint OPER_AX_DI_8(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_AX_DI_8();  return m68ki_read_8(ea); }
+INLINE uint OPER_AX_DI_16(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AX_DI_16(); return m68ki_read_16(ea);}
+INLINE uint OPER_AX_DI_32(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AX_DI_32(); return m68ki_read_32(ea);}
+INLINE uint OPER_AX_IX_8(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_AX_IX_8();  return m68ki_read_8(ea); }
+INLINE uint OPER_AX_IX_16(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AX_IX_16(); return m68ki_read_16(ea);}
+INLINE uint OPER_AX_IX_32(m68ki_cpu_core *m68ki_cpu_p) {uint ea = EA_AX_IX_32(); return m68ki_read_32(ea);}
+
+INLINE uint OPER_A7_PI_8(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_A7_PI_8();  return m68ki_read_8(ea); }
+INLINE uint OPER_A7_PD_8(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_A7_PD_8();  return m68ki_read_8(ea); }
+
+INLINE uint OPER_AW_8(m68ki_cpu_core *m68ki_cpu_p)     {uint ea = EA_AW_8();     return m68ki_read_8(ea); }
+INLINE uint OPER_AW_16(m68ki_cpu_core *m68ki_cpu_p)    {uint ea = EA_AW_16();    return m68ki_read_16(ea);}
+INLINE uint OPER_AW_32(m68ki_cpu_core *m68ki_cpu_p)    {uint ea = EA_AW_32();    return m68ki_read_32(ea);}
+INLINE uint OPER_AL_8(m68ki_cpu_core *m68ki_cpu_p)     {uint ea = EA_AL_8();     return m68ki_read_8(ea); }
+INLINE uint OPER_AL_16(m68ki_cpu_core *m68ki_cpu_p)    {uint ea = EA_AL_16();    return m68ki_read_16(ea);}
+INLINE uint OPER_AL_32(m68ki_cpu_core *m68ki_cpu_p)    {uint ea = EA_AL_32();    return m68ki_read_32(ea);}
+INLINE uint OPER_PCDI_8(m68ki_cpu_core *m68ki_cpu_p)   {uint ea = EA_PCDI_8();   return m68ki_read_pcrel_8(ea); }
+INLINE uint OPER_PCDI_16(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_PCDI_16();  return m68ki_read_pcrel_16(ea);}
+INLINE uint OPER_PCDI_32(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_PCDI_32();  return m68ki_read_pcrel_32(ea);}
+INLINE uint OPER_PCIX_8(m68ki_cpu_core *m68ki_cpu_p)   {uint ea = EA_PCIX_8();   return m68ki_read_pcrel_8(ea); }
+INLINE uint OPER_PCIX_16(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_PCIX_16();  return m68ki_read_pcrel_16(ea);}
+INLINE uint OPER_PCIX_32(m68ki_cpu_core *m68ki_cpu_p)  {uint ea = EA_PCIX_32();  return m68ki_read_pcrel_32(ea);}
 
 
 
 /* ---------------------------- Stack Functions --------------------------- */
 
 /* Push/pull data from the stack */
-INLINE void m68ki_push_16(uint value)
+INLINE void m68ki_push_16(m68ki_cpu_core *m68ki_cpu_p, uint value)
 {
 	REG_SP = MASK_OUT_ABOVE_32(REG_SP - 2);
 	m68ki_write_16(REG_SP, value);
 }
 
-INLINE void m68ki_push_32(uint value)
+INLINE void m68ki_push_32(m68ki_cpu_core *m68ki_cpu_p, uint value)
 {
 	REG_SP = MASK_OUT_ABOVE_32(REG_SP - 4);
 	m68ki_write_32(REG_SP, value);
 }
 
-INLINE uint m68ki_pull_16(void)
+INLINE uint m68ki_pull_16(m68ki_cpu_core *m68ki_cpu_p)
 {
 	REG_SP = MASK_OUT_ABOVE_32(REG_SP + 2);
 	return m68ki_read_16(REG_SP-2);
 }
 
-INLINE uint m68ki_pull_32(void)
+INLINE uint m68ki_pull_32(m68ki_cpu_core *m68ki_cpu_p)
 {
 	REG_SP = MASK_OUT_ABOVE_32(REG_SP + 4);
 	return m68ki_read_32(REG_SP-4);
@@ -1392,22 +1404,22 @@ INLINE uint m68ki_pull_32(void)
 /* Increment/decrement the stack as if doing a push/pull but
  * don't do any memory access.
  */
-INLINE void m68ki_fake_push_16(void)
+INLINE void m68ki_fake_push_16(m68ki_cpu_core *m68ki_cpu_p)
 {
 	REG_SP = MASK_OUT_ABOVE_32(REG_SP - 2);
 }
 
-INLINE void m68ki_fake_push_32(void)
+INLINE void m68ki_fake_push_32(m68ki_cpu_core *m68ki_cpu_p)
 {
 	REG_SP = MASK_OUT_ABOVE_32(REG_SP - 4);
 }
 
-INLINE void m68ki_fake_pull_16(void)
+INLINE void m68ki_fake_pull_16(m68ki_cpu_core *m68ki_cpu_p)
 {
 	REG_SP = MASK_OUT_ABOVE_32(REG_SP + 2);
 }
 
-INLINE void m68ki_fake_pull_32(void)
+INLINE void m68ki_fake_pull_32(m68ki_cpu_core *m68ki_cpu_p)
 {
 	REG_SP = MASK_OUT_ABOVE_32(REG_SP + 4);
 }
@@ -1419,13 +1431,13 @@ INLINE void m68ki_fake_pull_32(void)
  * These functions will also call the pc_changed callback if it was enabled
  * in m68kconf.h.
  */
-INLINE void m68ki_jump(uint new_pc)
+INLINE void m68ki_jump(m68ki_cpu_core *m68ki_cpu_p, uint new_pc)
 {
 	REG_PC = new_pc;
 	m68ki_pc_changed(REG_PC);
 }
 
-INLINE void m68ki_jump_vector(uint vector)
+INLINE void m68ki_jump_vector(m68ki_cpu_core *m68ki_cpu_p, uint vector)
 {
 	REG_PC = (vector<<2) + REG_VBR;
 	REG_PC = m68ki_read_data_32(REG_PC);
@@ -1438,17 +1450,17 @@ INLINE void m68ki_jump_vector(uint vector)
  * So far I've found no problems with not calling pc_changed for 8 or 16
  * bit branches.
  */
-INLINE void m68ki_branch_8(uint offset)
+INLINE void m68ki_branch_8(m68ki_cpu_core *m68ki_cpu_p, uint offset)
 {
 	REG_PC += MAKE_INT_8(offset);
 }
 
-INLINE void m68ki_branch_16(uint offset)
+INLINE void m68ki_branch_16(m68ki_cpu_core *m68ki_cpu_p, uint offset)
 {
 	REG_PC += MAKE_INT_16(offset);
 }
 
-INLINE void m68ki_branch_32(uint offset)
+INLINE void m68ki_branch_32(m68ki_cpu_core *m68ki_cpu_p, uint offset)
 {
 	REG_PC += offset;
 	m68ki_pc_changed(REG_PC);
@@ -1461,7 +1473,7 @@ INLINE void m68ki_branch_32(uint offset)
 /* Set the S flag and change the active stack pointer.
  * Note that value MUST be 4 or 0.
  */
-INLINE void m68ki_set_s_flag(uint value)
+INLINE void m68ki_set_s_flag(m68ki_cpu_core *m68ki_cpu_p, uint value)
 {
 	/* Backup the old stack pointer */
 	REG_SP_BASE[FLAG_S | ((FLAG_S>>1) & FLAG_M)] = REG_SP;
@@ -1474,7 +1486,7 @@ INLINE void m68ki_set_s_flag(uint value)
 /* Set the S and M flags and change the active stack pointer.
  * Note that value MUST be 0, 2, 4, or 6 (bit2 = S, bit1 = M).
  */
-INLINE void m68ki_set_sm_flag(uint value)
+INLINE void m68ki_set_sm_flag(m68ki_cpu_core *m68ki_cpu_p, uint value)
 {
 	/* Backup the old stack pointer */
 	REG_SP_BASE[FLAG_S | ((FLAG_S>>1) & FLAG_M)] = REG_SP;
@@ -1486,7 +1498,7 @@ INLINE void m68ki_set_sm_flag(uint value)
 }
 
 /* Set the S and M flags.  Don't touch the stack pointer. */
-INLINE void m68ki_set_sm_flag_nosp(uint value)
+INLINE void m68ki_set_sm_flag_nosp(m68ki_cpu_core *m68ki_cpu_p, uint value)
 {
 	/* Set the S and M flags */
 	FLAG_S = value & SFLAG_SET;
@@ -1495,7 +1507,7 @@ INLINE void m68ki_set_sm_flag_nosp(uint value)
 
 
 /* Set the condition code register */
-INLINE void m68ki_set_ccr(uint value)
+INLINE void m68ki_set_ccr(m68ki_cpu_core *m68ki_cpu_p, uint value)
 {
 	FLAG_X = BIT_4(value)  << 4;
 	FLAG_N = BIT_3(value)  << 4;
@@ -1505,7 +1517,7 @@ INLINE void m68ki_set_ccr(uint value)
 }
 
 /* Set the status register but don't check for interrupts */
-INLINE void m68ki_set_sr_noint(uint value)
+INLINE void m68ki_set_sr_noint(m68ki_cpu_core *m68ki_cpu_p, uint value)
 {
 	/* Mask out the "unimplemented" bits */
 	value &= CPU_SR_MASK;
@@ -1514,14 +1526,14 @@ INLINE void m68ki_set_sr_noint(uint value)
 	FLAG_T1 = BIT_F(value);
 	FLAG_T0 = BIT_E(value);
 	FLAG_INT_MASK = value & 0x0700;
-	m68ki_set_ccr(value);
-	m68ki_set_sm_flag((value >> 11) & 6);
+	m68ki_set_ccr(m68ki_cpu_p, value);
+	m68ki_set_sm_flag(m68ki_cpu_p, (value >> 11) & 6);
 }
 
 /* Set the status register but don't check for interrupts nor
  * change the stack pointer
  */
-INLINE void m68ki_set_sr_noint_nosp(uint value)
+INLINE void m68ki_set_sr_noint_nosp(m68ki_cpu_core *m68ki_cpu_p, uint value)
 {
 	/* Mask out the "unimplemented" bits */
 	value &= CPU_SR_MASK;
@@ -1530,23 +1542,23 @@ INLINE void m68ki_set_sr_noint_nosp(uint value)
 	FLAG_T1 = BIT_F(value);
 	FLAG_T0 = BIT_E(value);
 	FLAG_INT_MASK = value & 0x0700;
-	m68ki_set_ccr(value);
-	m68ki_set_sm_flag_nosp((value >> 11) & 6);
+	m68ki_set_ccr(m68ki_cpu_p, value);
+	m68ki_set_sm_flag_nosp(m68ki_cpu_p, (value >> 11) & 6);
 }
 
 /* Set the status register and check for interrupts */
-INLINE void m68ki_set_sr(uint value)
+INLINE void m68ki_set_sr(m68ki_cpu_core *m68ki_cpu_p, uint value)
 {
-	m68ki_set_sr_noint(value);
+	m68ki_set_sr_noint(m68ki_cpu_p, value);
 	if (GET_CYCLES() >= 0) // notaz
-		m68ki_check_interrupts();
+		m68ki_check_interrupts(m68ki_cpu_p);
 }
 
 
 /* ------------------------- Exception Processing ------------------------- */
 
 /* Initiate exception processing */
-INLINE uint m68ki_init_exception(void)
+INLINE uint m68ki_init_exception(m68ki_cpu_core *m68ki_cpu_p)
 {
 	/* Save the old status register */
 	uint sr = m68ki_get_sr();
@@ -1555,122 +1567,122 @@ INLINE uint m68ki_init_exception(void)
 	FLAG_T1 = FLAG_T0 = 0;
 	m68ki_clear_trace();
 	/* Enter supervisor mode */
-	m68ki_set_s_flag(SFLAG_SET);
+	m68ki_set_s_flag(m68ki_cpu_p, SFLAG_SET);
 
 	return sr;
 }
 
 /* 3 word stack frame (68000 only) */
-INLINE void m68ki_stack_frame_3word(uint pc, uint sr)
+INLINE void m68ki_stack_frame_3word(m68ki_cpu_core *m68ki_cpu_p, uint pc, uint sr)
 {
-	m68ki_push_32(pc);
-	m68ki_push_16(sr);
+	m68ki_push_32(m68ki_cpu_p, pc);
+	m68ki_push_16(m68ki_cpu_p, sr);
 }
 
 /* Format 0 stack frame.
  * This is the standard stack frame for 68010+.
  */
-INLINE void m68ki_stack_frame_0000(uint pc, uint sr, uint vector)
+INLINE void m68ki_stack_frame_0000(m68ki_cpu_core *m68ki_cpu_p, uint pc, uint sr, uint vector)
 {
 	/* Stack a 3-word frame if we are 68000 */
 	if(CPU_TYPE == CPU_TYPE_000 || CPU_TYPE == CPU_TYPE_008)
 	{
-		m68ki_stack_frame_3word(pc, sr);
+		m68ki_stack_frame_3word(m68ki_cpu_p, pc, sr);
 		return;
 	}
-	m68ki_push_16(vector<<2);
-	m68ki_push_32(pc);
-	m68ki_push_16(sr);
+	m68ki_push_16(m68ki_cpu_p, vector<<2);
+	m68ki_push_32(m68ki_cpu_p, pc);
+	m68ki_push_16(m68ki_cpu_p, sr);
 }
 
 /* Format 1 stack frame (68020).
  * For 68020, this is the 4 word throwaway frame.
  */
-INLINE void m68ki_stack_frame_0001(uint pc, uint sr, uint vector)
+INLINE void m68ki_stack_frame_0001(m68ki_cpu_core *m68ki_cpu_p, uint pc, uint sr, uint vector)
 {
-	m68ki_push_16(0x1000 | (vector<<2));
-	m68ki_push_32(pc);
-	m68ki_push_16(sr);
+	m68ki_push_16(m68ki_cpu_p, 0x1000 | (vector<<2));
+	m68ki_push_32(m68ki_cpu_p, pc);
+	m68ki_push_16(m68ki_cpu_p, sr);
 }
 
 /* Format 2 stack frame.
  * This is used only by 68020 for trap exceptions.
  */
-INLINE void m68ki_stack_frame_0010(uint sr, uint vector)
+INLINE void m68ki_stack_frame_0010(m68ki_cpu_core *m68ki_cpu_p, uint sr, uint vector)
 {
-	m68ki_push_32(REG_PPC);
-	m68ki_push_16(0x2000 | (vector<<2));
-	m68ki_push_32(REG_PC);
-	m68ki_push_16(sr);
+	m68ki_push_32(m68ki_cpu_p, REG_PPC);
+	m68ki_push_16(m68ki_cpu_p, 0x2000 | (vector<<2));
+	m68ki_push_32(m68ki_cpu_p, REG_PC);
+	m68ki_push_16(m68ki_cpu_p, sr);
 }
 
 
 /* Bus error stack frame (68000 only).
  */
-INLINE void m68ki_stack_frame_buserr(uint sr)
+INLINE void m68ki_stack_frame_buserr(m68ki_cpu_core *m68ki_cpu_p, uint sr)
 {
-	m68ki_push_32(REG_PC);
-	m68ki_push_16(sr);
-	m68ki_push_16(REG_IR);
-	m68ki_push_32(m68ki_aerr_address);	/* access address */
+	m68ki_push_32(m68ki_cpu_p, REG_PC);
+	m68ki_push_16(m68ki_cpu_p, sr);
+	m68ki_push_16(m68ki_cpu_p, REG_IR);
+	m68ki_push_32(m68ki_cpu_p, m68ki_aerr_address);	/* access address */
 	/* 0 0 0 0 0 0 0 0 0 0 0 R/W I/N FC
      * R/W  0 = write, 1 = read
      * I/N  0 = instruction, 1 = not
      * FC   3-bit function code
      */
-	m68ki_push_16(m68ki_aerr_write_mode | CPU_INSTR_MODE | m68ki_aerr_fc);
+	m68ki_push_16(m68ki_cpu_p, m68ki_aerr_write_mode | CPU_INSTR_MODE | m68ki_aerr_fc);
 }
 
 /* Format 8 stack frame (68010).
  * 68010 only.  This is the 29 word bus/address error frame.
  */
-INLINE void m68ki_stack_frame_1000(uint pc, uint sr, uint vector)
+INLINE void m68ki_stack_frame_1000(m68ki_cpu_core *m68ki_cpu_p, uint pc, uint sr, uint vector)
 {
 	/* VERSION
      * NUMBER
      * INTERNAL INFORMATION, 16 WORDS
      */
-	m68ki_fake_push_32();
-	m68ki_fake_push_32();
-	m68ki_fake_push_32();
-	m68ki_fake_push_32();
-	m68ki_fake_push_32();
-	m68ki_fake_push_32();
-	m68ki_fake_push_32();
-	m68ki_fake_push_32();
+	m68ki_fake_push_32(m68ki_cpu_p);
+	m68ki_fake_push_32(m68ki_cpu_p);
+	m68ki_fake_push_32(m68ki_cpu_p);
+	m68ki_fake_push_32(m68ki_cpu_p);
+	m68ki_fake_push_32(m68ki_cpu_p);
+	m68ki_fake_push_32(m68ki_cpu_p);
+	m68ki_fake_push_32(m68ki_cpu_p);
+	m68ki_fake_push_32(m68ki_cpu_p);
 
 	/* INSTRUCTION INPUT BUFFER */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* UNUSED, RESERVED (not written) */
-	m68ki_fake_push_16();
+	m68ki_fake_push_16(m68ki_cpu_p);
 
 	/* DATA INPUT BUFFER */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* UNUSED, RESERVED (not written) */
-	m68ki_fake_push_16();
+	m68ki_fake_push_16(m68ki_cpu_p);
 
 	/* DATA OUTPUT BUFFER */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* UNUSED, RESERVED (not written) */
-	m68ki_fake_push_16();
+	m68ki_fake_push_16(m68ki_cpu_p);
 
 	/* FAULT ADDRESS */
-	m68ki_push_32(0);
+	m68ki_push_32(m68ki_cpu_p, 0);
 
 	/* SPECIAL STATUS WORD */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* 1000, VECTOR OFFSET */
-	m68ki_push_16(0x8000 | (vector<<2));
+	m68ki_push_16(m68ki_cpu_p, 0x8000 | (vector<<2));
 
 	/* PROGRAM COUNTER */
-	m68ki_push_32(pc);
+	m68ki_push_32(m68ki_cpu_p, pc);
 
 	/* STATUS REGISTER */
-	m68ki_push_16(sr);
+	m68ki_push_16(m68ki_cpu_p, sr);
 }
 
 /* Format A stack frame (short bus fault).
@@ -1678,46 +1690,46 @@ INLINE void m68ki_stack_frame_1000(uint pc, uint sr, uint vector)
  * if the error happens at an instruction boundary.
  * PC stacked is address of next instruction.
  */
-INLINE void m68ki_stack_frame_1010(uint sr, uint vector, uint pc)
+INLINE void m68ki_stack_frame_1010(m68ki_cpu_core *m68ki_cpu_p, uint sr, uint vector, uint pc)
 {
 	/* INTERNAL REGISTER */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* INTERNAL REGISTER */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* DATA OUTPUT BUFFER (2 words) */
-	m68ki_push_32(0);
+	m68ki_push_32(m68ki_cpu_p, 0);
 
 	/* INTERNAL REGISTER */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* INTERNAL REGISTER */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* DATA CYCLE FAULT ADDRESS (2 words) */
-	m68ki_push_32(0);
+	m68ki_push_32(m68ki_cpu_p, 0);
 
 	/* INSTRUCTION PIPE STAGE B */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* INSTRUCTION PIPE STAGE C */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* SPECIAL STATUS REGISTER */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* INTERNAL REGISTER */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* 1010, VECTOR OFFSET */
-	m68ki_push_16(0xa000 | (vector<<2));
+	m68ki_push_16(m68ki_cpu_p, 0xa000 | (vector<<2));
 
 	/* PROGRAM COUNTER */
-	m68ki_push_32(pc);
+	m68ki_push_32(m68ki_cpu_p, pc);
 
 	/* STATUS REGISTER */
-	m68ki_push_16(sr);
+	m68ki_push_16(m68ki_cpu_p, sr);
 }
 
 /* Format B stack frame (long bus fault).
@@ -1725,107 +1737,107 @@ INLINE void m68ki_stack_frame_1010(uint sr, uint vector, uint pc)
  * if the error happens during instruction execution.
  * PC stacked is address of instruction in progress.
  */
-INLINE void m68ki_stack_frame_1011(uint sr, uint vector, uint pc)
+INLINE void m68ki_stack_frame_1011(m68ki_cpu_core *m68ki_cpu_p, uint sr, uint vector, uint pc)
 {
 	/* INTERNAL REGISTERS (18 words) */
-	m68ki_push_32(0);
-	m68ki_push_32(0);
-	m68ki_push_32(0);
-	m68ki_push_32(0);
-	m68ki_push_32(0);
-	m68ki_push_32(0);
-	m68ki_push_32(0);
-	m68ki_push_32(0);
-	m68ki_push_32(0);
+	m68ki_push_32(m68ki_cpu_p, 0);
+	m68ki_push_32(m68ki_cpu_p, 0);
+	m68ki_push_32(m68ki_cpu_p, 0);
+	m68ki_push_32(m68ki_cpu_p, 0);
+	m68ki_push_32(m68ki_cpu_p, 0);
+	m68ki_push_32(m68ki_cpu_p, 0);
+	m68ki_push_32(m68ki_cpu_p, 0);
+	m68ki_push_32(m68ki_cpu_p, 0);
+	m68ki_push_32(m68ki_cpu_p, 0);
 
 	/* VERSION# (4 bits), INTERNAL INFORMATION */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* INTERNAL REGISTERS (3 words) */
-	m68ki_push_32(0);
-	m68ki_push_16(0);
+	m68ki_push_32(m68ki_cpu_p, 0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* DATA INTPUT BUFFER (2 words) */
-	m68ki_push_32(0);
+	m68ki_push_32(m68ki_cpu_p, 0);
 
 	/* INTERNAL REGISTERS (2 words) */
-	m68ki_push_32(0);
+	m68ki_push_32(m68ki_cpu_p, 0);
 
 	/* STAGE B ADDRESS (2 words) */
-	m68ki_push_32(0);
+	m68ki_push_32(m68ki_cpu_p, 0);
 
 	/* INTERNAL REGISTER (4 words) */
-	m68ki_push_32(0);
-	m68ki_push_32(0);
+	m68ki_push_32(m68ki_cpu_p, 0);
+	m68ki_push_32(m68ki_cpu_p, 0);
 
 	/* DATA OUTPUT BUFFER (2 words) */
-	m68ki_push_32(0);
+	m68ki_push_32(m68ki_cpu_p, 0);
 
 	/* INTERNAL REGISTER */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* INTERNAL REGISTER */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* DATA CYCLE FAULT ADDRESS (2 words) */
-	m68ki_push_32(0);
+	m68ki_push_32(m68ki_cpu_p, 0);
 
 	/* INSTRUCTION PIPE STAGE B */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* INSTRUCTION PIPE STAGE C */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* SPECIAL STATUS REGISTER */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* INTERNAL REGISTER */
-	m68ki_push_16(0);
+	m68ki_push_16(m68ki_cpu_p, 0);
 
 	/* 1011, VECTOR OFFSET */
-	m68ki_push_16(0xb000 | (vector<<2));
+	m68ki_push_16(m68ki_cpu_p, 0xb000 | (vector<<2));
 
 	/* PROGRAM COUNTER */
-	m68ki_push_32(pc);
+	m68ki_push_32(m68ki_cpu_p, pc);
 
 	/* STATUS REGISTER */
-	m68ki_push_16(sr);
+	m68ki_push_16(m68ki_cpu_p, sr);
 }
 
 
 /* Used for Group 2 exceptions.
  * These stack a type 2 frame on the 020.
  */
-INLINE void m68ki_exception_trap(uint vector)
+INLINE void m68ki_exception_trap(m68ki_cpu_core *m68ki_cpu_p, uint vector)
 {
-	uint sr = m68ki_init_exception();
+	uint sr = m68ki_init_exception(m68ki_cpu_p);
 
 	if(CPU_TYPE_IS_010_LESS(CPU_TYPE))
-		m68ki_stack_frame_0000(REG_PC, sr, vector);
+		m68ki_stack_frame_0000(m68ki_cpu_p, REG_PC, sr, vector);
 	else
-		m68ki_stack_frame_0010(sr, vector);
+		m68ki_stack_frame_0010(m68ki_cpu_p, sr, vector);
 
-	m68ki_jump_vector(vector);
+	m68ki_jump_vector(m68ki_cpu_p, vector);
 
 	/* Use up some clock cycles */
 	USE_CYCLES(CYC_EXCEPTION[vector]);
 }
 
 /* Trap#n stacks a 0 frame but behaves like group2 otherwise */
-INLINE void m68ki_exception_trapN(uint vector)
+INLINE void m68ki_exception_trapN(m68ki_cpu_core *m68ki_cpu_p, uint vector)
 {
-	uint sr = m68ki_init_exception();
-	m68ki_stack_frame_0000(REG_PC, sr, vector);
-	m68ki_jump_vector(vector);
+	uint sr = m68ki_init_exception(m68ki_cpu_p);
+	m68ki_stack_frame_0000(m68ki_cpu_p, REG_PC, sr, vector);
+	m68ki_jump_vector(m68ki_cpu_p, vector);
 
 	/* Use up some clock cycles */
 	USE_CYCLES(CYC_EXCEPTION[vector]);
 }
 
 /* Exception for trace mode */
-INLINE void m68ki_exception_trace(void)
+INLINE void m68ki_exception_trace(m68ki_cpu_core *m68ki_cpu_p)
 {
-	uint sr = m68ki_init_exception();
+	uint sr = m68ki_init_exception(m68ki_cpu_p);
 
 	if(CPU_TYPE_IS_010_LESS(CPU_TYPE))
 	{
@@ -1835,12 +1847,12 @@ INLINE void m68ki_exception_trace(void)
 			CPU_INSTR_MODE = INSTRUCTION_NO;
 		}
 		#endif /* M68K_EMULATE_ADDRESS_ERROR */
-		m68ki_stack_frame_0000(REG_PC, sr, EXCEPTION_TRACE);
+		m68ki_stack_frame_0000(m68ki_cpu_p, REG_PC, sr, EXCEPTION_TRACE);
 	}
 	else
-		m68ki_stack_frame_0010(sr, EXCEPTION_TRACE);
+		m68ki_stack_frame_0010(m68ki_cpu_p, sr, EXCEPTION_TRACE);
 
-	m68ki_jump_vector(EXCEPTION_TRACE);
+	m68ki_jump_vector(m68ki_cpu_p, EXCEPTION_TRACE);
 
 	/* Trace nullifies a STOP instruction */
 	CPU_STOPPED &= ~STOP_LEVEL_STOP;
@@ -1850,9 +1862,9 @@ INLINE void m68ki_exception_trace(void)
 }
 
 /* Exception for privilege violation */
-INLINE void m68ki_exception_privilege_violation(void)
+INLINE void m68ki_exception_privilege_violation(m68ki_cpu_core *m68ki_cpu_p)
 {
-	uint sr = m68ki_init_exception();
+	uint sr = m68ki_init_exception(m68ki_cpu_p);
 
 	#if M68K_EMULATE_ADDRESS_ERROR == OPT_ON
 	if(CPU_TYPE_IS_000(CPU_TYPE))
@@ -1861,15 +1873,15 @@ INLINE void m68ki_exception_privilege_violation(void)
 	}
 	#endif /* M68K_EMULATE_ADDRESS_ERROR */
 
-	m68ki_stack_frame_0000(REG_PPC, sr, EXCEPTION_PRIVILEGE_VIOLATION);
-	m68ki_jump_vector(EXCEPTION_PRIVILEGE_VIOLATION);
+	m68ki_stack_frame_0000(m68ki_cpu_p, REG_PPC, sr, EXCEPTION_PRIVILEGE_VIOLATION);
+	m68ki_jump_vector(m68ki_cpu_p, EXCEPTION_PRIVILEGE_VIOLATION);
 
 	/* Use up some clock cycles and undo the instruction's cycles */
 	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_PRIVILEGE_VIOLATION] - CYC_INSTRUCTION[REG_IR]);
 }
 
 /* Exception for A-Line instructions */
-INLINE void m68ki_exception_1010(void)
+INLINE void m68ki_exception_1010(m68ki_cpu_core *m68ki_cpu_p)
 {
 	uint sr;
 #if M68K_LOG_1010_1111 == OPT_ON
@@ -1878,16 +1890,16 @@ INLINE void m68ki_exception_1010(void)
 					 m68ki_disassemble_quick(ADDRESS_68K(REG_PPC))));
 #endif
 
-	sr = m68ki_init_exception();
-	m68ki_stack_frame_0000(REG_PPC, sr, EXCEPTION_1010);
-	m68ki_jump_vector(EXCEPTION_1010);
+	sr = m68ki_init_exception(m68ki_cpu_p);
+	m68ki_stack_frame_0000(m68ki_cpu_p, REG_PPC, sr, EXCEPTION_1010);
+	m68ki_jump_vector(m68ki_cpu_p, EXCEPTION_1010);
 
 	/* Use up some clock cycles and undo the instruction's cycles */
 	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_1010] - CYC_INSTRUCTION[REG_IR]);
 }
 
 /* Exception for F-Line instructions */
-INLINE void m68ki_exception_1111(void)
+INLINE void m68ki_exception_1111(m68ki_cpu_core *m68ki_cpu_p)
 {
 	uint sr;
 
@@ -1897,16 +1909,16 @@ INLINE void m68ki_exception_1111(void)
 					 m68ki_disassemble_quick(ADDRESS_68K(REG_PPC))));
 #endif
 
-	sr = m68ki_init_exception();
-	m68ki_stack_frame_0000(REG_PPC, sr, EXCEPTION_1111);
-	m68ki_jump_vector(EXCEPTION_1111);
+	sr = m68ki_init_exception(m68ki_cpu_p);
+	m68ki_stack_frame_0000(m68ki_cpu_p, REG_PPC, sr, EXCEPTION_1111);
+	m68ki_jump_vector(m68ki_cpu_p, EXCEPTION_1111);
 
 	/* Use up some clock cycles and undo the instruction's cycles */
 	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_1111] - CYC_INSTRUCTION[REG_IR]);
 }
 
 /* Exception for illegal instructions */
-INLINE void m68ki_exception_illegal(void)
+INLINE void m68ki_exception_illegal(m68ki_cpu_core *m68ki_cpu_p)
 {
 	uint sr;
 
@@ -1914,7 +1926,7 @@ INLINE void m68ki_exception_illegal(void)
 				 m68ki_cpu_names[CPU_TYPE], ADDRESS_68K(REG_PPC), REG_IR,
 				 m68ki_disassemble_quick(ADDRESS_68K(REG_PPC))));
 
-	sr = m68ki_init_exception();
+	sr = m68ki_init_exception(m68ki_cpu_p);
 
 	#if M68K_EMULATE_ADDRESS_ERROR == OPT_ON
 	if(CPU_TYPE_IS_000(CPU_TYPE))
@@ -1923,28 +1935,28 @@ INLINE void m68ki_exception_illegal(void)
 	}
 	#endif /* M68K_EMULATE_ADDRESS_ERROR */
 
-	m68ki_stack_frame_0000(REG_PPC, sr, EXCEPTION_ILLEGAL_INSTRUCTION);
-	m68ki_jump_vector(EXCEPTION_ILLEGAL_INSTRUCTION);
+	m68ki_stack_frame_0000(m68ki_cpu_p, REG_PPC, sr, EXCEPTION_ILLEGAL_INSTRUCTION);
+	m68ki_jump_vector(m68ki_cpu_p, EXCEPTION_ILLEGAL_INSTRUCTION);
 
 	/* Use up some clock cycles and undo the instruction's cycles */
 	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_ILLEGAL_INSTRUCTION] - CYC_INSTRUCTION[REG_IR]);
 }
 
 /* Exception for format errror in RTE */
-INLINE void m68ki_exception_format_error(void)
+INLINE void m68ki_exception_format_error(m68ki_cpu_core *m68ki_cpu_p)
 {
-	uint sr = m68ki_init_exception();
-	m68ki_stack_frame_0000(REG_PC, sr, EXCEPTION_FORMAT_ERROR);
-	m68ki_jump_vector(EXCEPTION_FORMAT_ERROR);
+	uint sr = m68ki_init_exception(m68ki_cpu_p);
+	m68ki_stack_frame_0000(m68ki_cpu_p, REG_PC, sr, EXCEPTION_FORMAT_ERROR);
+	m68ki_jump_vector(m68ki_cpu_p, EXCEPTION_FORMAT_ERROR);
 
 	/* Use up some clock cycles and undo the instruction's cycles */
 	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_FORMAT_ERROR] - CYC_INSTRUCTION[REG_IR]);
 }
 
 /* Exception for address error */
-INLINE void m68ki_exception_address_error(void)
+INLINE void m68ki_exception_address_error(m68ki_cpu_core *m68ki_cpu_p)
 {
-	uint sr = m68ki_init_exception();
+	uint sr = m68ki_init_exception(m68ki_cpu_p);
 
 	/* If we were processing a bus error, address error, or reset,
      * this is a catastrophic failure.
@@ -1959,9 +1971,9 @@ m68k_read_memory_8(0x00ffff01);
 	CPU_RUN_MODE = RUN_MODE_BERR_AERR_RESET;
 
 	/* Note: This is implemented for 68000 only! */
-	m68ki_stack_frame_buserr(sr);
+	m68ki_stack_frame_buserr(m68ki_cpu_p, sr);
 
-	m68ki_jump_vector(EXCEPTION_ADDRESS_ERROR);
+	m68ki_jump_vector(m68ki_cpu_p, EXCEPTION_ADDRESS_ERROR);
 
 	/* Use up some clock cycles and undo the instruction's cycles */
 	USE_CYCLES(CYC_EXCEPTION[EXCEPTION_ADDRESS_ERROR] - CYC_INSTRUCTION[REG_IR]);
@@ -1969,7 +1981,7 @@ m68k_read_memory_8(0x00ffff01);
 
 
 /* Service an interrupt request and start exception processing */
-INLINE void m68ki_exception_interrupt(uint int_level)
+INLINE void m68ki_exception_interrupt(m68ki_cpu_core *m68ki_cpu_p, uint int_level)
 {
 	uint vector;
 	uint sr;
@@ -2007,7 +2019,7 @@ INLINE void m68ki_exception_interrupt(uint int_level)
 	}
 
 	/* Start exception processing */
-	sr = m68ki_init_exception();
+	sr = m68ki_init_exception(m68ki_cpu_p);
 
 	/* Set the interrupt mask to the level of the one being serviced */
 	FLAG_INT_MASK = int_level<<8;
@@ -2021,16 +2033,16 @@ INLINE void m68ki_exception_interrupt(uint int_level)
 		new_pc = m68ki_read_data_32((EXCEPTION_UNINITIALIZED_INTERRUPT<<2) + REG_VBR);
 
 	/* Generate a stack frame */
-	m68ki_stack_frame_0000(REG_PC, sr, vector);
+	m68ki_stack_frame_0000(m68ki_cpu_p, REG_PC, sr, vector);
 	if(FLAG_M && CPU_TYPE_IS_EC020_PLUS(CPU_TYPE))
 	{
 		/* Create throwaway frame */
-		m68ki_set_sm_flag(FLAG_S);	/* clear M */
+		m68ki_set_sm_flag(m68ki_cpu_p, FLAG_S);	/* clear M */
 		sr |= 0x2000; /* Same as SR in master stack frame except S is forced high */
-		m68ki_stack_frame_0001(REG_PC, sr, vector);
+		m68ki_stack_frame_0001(m68ki_cpu_p, REG_PC, sr, vector);
 	}
 
-	m68ki_jump(new_pc);
+	m68ki_jump(m68ki_cpu_p, new_pc);
 
 	/* Defer cycle counting until later */
 	CPU_INT_CYCLES += CYC_EXCEPTION[vector];
@@ -2043,10 +2055,10 @@ INLINE void m68ki_exception_interrupt(uint int_level)
 
 
 /* ASG: Check for interrupts */
-INLINE void m68ki_check_interrupts(void)
+INLINE void m68ki_check_interrupts(m68ki_cpu_core *m68ki_cpu_p)
 {
 	if(CPU_INT_LEVEL > FLAG_INT_MASK)
-		m68ki_exception_interrupt(CPU_INT_LEVEL>>8);
+		m68ki_exception_interrupt(m68ki_cpu_p, CPU_INT_LEVEL>>8);
 }
 
 
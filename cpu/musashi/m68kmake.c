@@ -781,13 +781,13 @@ void get_base_name(char* base_name, opcode_struct* op)
 /* Write the prototype of an opcode handler function */
 void write_prototype(FILE* filep, char* base_name)
 {
-	fprintf(filep, "void %s(void);\n", base_name);
+	fprintf(filep, "void %s(m68ki_cpu_core *m68ki_cpu_p);\n", base_name);
 }
 
 /* Write the name of an opcode handler function */
 void write_function_name(FILE* filep, char* base_name)
 {
-	fprintf(filep, "void %s(void)\n", base_name);
+	fprintf(filep, "void %s(m68ki_cpu_core *m68ki_cpu_p)\n", base_name);
 }
 
 void add_opcode_output_table_entry(opcode_struct* op, char* name)
@@ -877,17 +877,20 @@ void generate_opcode_handler(FILE* filep, body_struct* body, replace_struct* rep
 	/* Add any replace strings needed */
 	if(ea_mode != EA_MODE_NONE)
 	{
+		/* operand fetchers take the cpu, except for the immediate macros */
+		const char* arg = ea_mode == EA_MODE_I ? "" : "m68ki_cpu_p";
+
 		sprintf(str, "EA_%s_8()", g_ea_info_table[ea_mode].ea_add);
 		add_replace_string(replace, ID_OPHANDLER_EA_AY_8, str);
 		sprintf(str, "EA_%s_16()", g_ea_info_table[ea_mode].ea_add);
 		add_replace_string(replace, ID_OPHANDLER_EA_AY_16, str);
 		sprintf(str, "EA_%s_32()", g_ea_info_table[ea_mode].ea_add);
 		add_replace_string(replace, ID_OPHANDLER_EA_AY_32, str);
-		sprintf(str, "OPER_%s_8()", g_ea_info_table[ea_mode].ea_add);
+		sprintf(str, "OPER_%s_8(%s)", g_ea_info_table[ea_mode].ea_add, arg);
 		add_replace_string(replace, ID_OPHANDLER_OPER_AY_8, str);
-		sprintf(str, "OPER_%s_16()", g_ea_info_table[ea_mode].ea_add);
+		sprintf(str, "OPER_%s_16(%s)", g_ea_info_table[ea_mode].ea_add, arg);
 		add_replace_string(replace, ID_OPHANDLER_OPER_AY_16, str);
-		sprintf(str, "OPER_%s_32()", g_ea_info_table[ea_mode].ea_add);
+		sprintf(str, "OPER_%s_32(%s)", g_ea_info_table[ea_mode].ea_add, arg);
 		add_replace_string(replace, ID_OPHANDLER_OPER_AY_32, str);
 	}
 
@@ -246,6 +246,14 @@ static struct block_entry **hash_tables[TCACHE_BUFFERS];
 #define HASH_FUNC(hash_tab, addr, mask) \
   (hash_tab)[(((addr) >> 20) ^ ((addr) >> 2)) & (mask)]
 
+// start addresses of ROM and BIOS blocks compiled since the cart was
+// loaded (pc | is_slave), for the frontend to keep between runs
+#define WARM_MAX  0x2000
+#define WARM_HASH (WARM_MAX * 2)
+static u32 warm_pcs[WARM_MAX];
+static u16 warm_hash[WARM_HASH]; // index + 1
+static int warm_count;
+
 // host register tracking
 enum {
   HR_FREE,
@@ -435,6 +443,20 @@ static struct block_entry *dr_get_entry(u32 pc, int is_slave, int *tcache_id)
   return NULL;
 }
 
+static void warm_add(u32 pc, int is_slave)
+{
+  u32 v = pc | is_slave;
+  int h = (v >> 1) & (WARM_HASH - 1);
+
+  for (; warm_hash[h] != 0; h = (h + 1) & (WARM_HASH - 1))
+    if (warm_pcs[warm_hash[h] - 1] == v)
+      return;
+  if (warm_count >= WARM_MAX)
+    return;
+  warm_pcs[warm_count++] = v;
+  warm_hash[h] = warm_count;
+}
+
 // ---------------------------------------------------------------
 
 // block management
@@ -2915,7 +2937,10 @@ end_op:
   if ((sh2->pc & 0xc6000000) == 0x02000000) { // ROM
     dbg(2, "  hash collisions %d/%d", hash_collisions, block_counts[tcache_id]);
     Pico32x.emu_flags |= P32XF_DRC_ROM_C;
+    warm_add(base_pc, sh2->is_slave);
   }
+  else if ((base_pc & ~0x7ff) == 0) // BIOS
+    warm_add(base_pc, sh2->is_slave);
 /*
  printf("~~~\n");
  tcache_dsm_ptrs[tcache_id] = block_entry_ptr;
@@ -3297,6 +3322,42 @@ void sh2_drc_flush_all(void)
   Pico32x.emu_flags &= ~P32XF_DRC_ROM_C;
 }
 
+int sh2_drc_warm_list(const unsigned int **pcs)
+{
+  *pcs = warm_pcs;
+  return warm_count;
+}
+
+// compile the blocks at given addresses ahead of time, skipping those for
+// a cache once it's full, the rest is done on demand
+void sh2_drc_prewarm(const unsigned int *pcs, int count)
+{
+  u32 pc_saved[2] = { sh2s[0].pc, sh2s[1].pc };
+  int full[TCACHE_BUFFERS] = { 0, };
+  int i, is_slave, tcid;
+  u32 pc;
+
+  for (i = 0; i < count; i++) {
+    pc = pcs[i] & ~1;
+    is_slave = pcs[i] & 1;
+    if ((pc & ~0x7ff) != 0 && (pc & 0xc6000000) != 0x02000000)
+      continue;
+    if (dr_get_pc_base(pc, is_slave) == (void *)-1)
+      continue;
+    // keep them listed even if they don't fit now
+    warm_add(pc, is_slave);
+    if (dr_get_entry(pc, is_slave, &tcid) != NULL || full[tcid])
+      continue;
+
+    sh2s[is_slave].pc = pc;
+    if (sh2_translate(&sh2s[is_slave], tcid) == NULL)
+      full[tcid] = 1;
+  }
+
+  sh2s[0].pc = pc_saved[0];
+  sh2s[1].pc = pc_saved[1];
+}
+
 void sh2_drc_mem_setup(SH2 *sh2)
 {
   // fill the convenience pointers
@@ -3403,6 +3464,9 @@ void sh2_drc_finish(SH2 *sh2)
   }
 
   drc_cmn_cleanup();
+
+  warm_count = 0;
+  memset(warm_hash, 0, sizeof(warm_hash));
 }
 
 #endif /* DRC_SH2 */
@@ -7,6 +7,8 @@ void sh2_drc_wcheck_da(unsigned int a, int val, int cpuid);
 void sh2_drc_mem_setup(SH2 *sh2);
 void sh2_drc_flush_all(void);
 void sh2_drc_frame(void);
+int  sh2_drc_warm_list(const unsigned int **pcs);
+void sh2_drc_prewarm(const unsigned int *pcs, int count);
 #else
 #define sh2_drc_mem_setup(x)
 #define sh2_drc_flush_all()
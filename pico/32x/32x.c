@@ -50,6 +50,12 @@ void p32x_update_irls(SH2 *active_sh2, int m68k_cycles)
     slvl++;
   slvl *= 2;
 
+  // can't tell when the other cpu would have seen this
+  if (p32x_spec_active && active_sh2 != NULL) {
+    if (active_sh2->other_sh2->pending_irl != (active_sh2->is_slave ? mlvl : slvl))
+      p32x_spec_conflict(active_sh2);
+  }
+
   mrun = sh2_irl_irq(&msh2, mlvl, active_sh2 == &msh2);
   if (mrun) {
     p32x_sh2_poll_event(&msh2, SH2_IDLE_STATES, m68k_cycles);
@@ -117,6 +123,7 @@ void Pico32xStartup(void)
     Pico32x.vdp_regs[0] |= P32XV_nPAL;
 
   rendstatus_old = -1;
+  p32x_drc_cache_load();
 
   emu_32x_startup();
 }
@@ -194,11 +201,13 @@ void PicoPower32x(void)
 
 void PicoUnload32x(void)
 {
+  p32x_drc_cache_save();
   if (Pico32xMem != NULL)
     plat_munmap(Pico32xMem, sizeof(*Pico32xMem));
   Pico32xMem = NULL;
   sh2_finish(&msh2);
   sh2_finish(&ssh2);
+  p32x_spec_finish();
 
   PicoIn.AHW &= ~PAHW_32X;
 }
@@ -424,6 +433,33 @@ void p32x_sync_other_sh2(SH2 *sh2, unsigned int m68k_target)
 
 #define STEP_LS 24
 #define STEP_N 440
+#define STEP_SPEC (STEP_N * 16)
+
+// speculation backoff, in steps
+static int spec_fails, spec_skip;
+
+static int spec_allowed(void)
+{
+  // WDT irqs are only generated between steps
+  if ((PREG8(msh2.peri_regs, 0x80) | PREG8(ssh2.peri_regs, 0x80)) & 0x20)
+    return 0;
+  if (spec_skip > 0) {
+    spec_skip--;
+    return 0;
+  }
+  return 1;
+}
+
+static void spec_done(int failed)
+{
+  if (failed) {
+    if (spec_fails < 6)
+      spec_fails++;
+    spec_skip = 1 << spec_fails;
+  }
+  else if (spec_fails > 0)
+    spec_fails--;
+}
 
 #define sync_sh2s_normal p32x_sync_sh2s
 //#define sync_sh2s_lockstep p32x_sync_sh2s
@@ -432,7 +468,8 @@ void p32x_sync_other_sh2(SH2 *sh2, unsigned int m68k_target)
 void sync_sh2s_normal(unsigned int m68k_target)
 {
   unsigned int now, target, timer_cycles;
-  int cycles;
+  unsigned int spec_now = 0, spec_event = 0;
+  int cycles, spec;
 
   elprintf(EL_32X, "sh2 sync to %u", m68k_target);
 
@@ -454,7 +491,19 @@ void sync_sh2s_normal(unsigned int m68k_target)
     target = m68k_target;
     if (event_time_next && CYCLES_GT(target, event_time_next))
       target = event_time_next;
-    if (CYCLES_GT(target, now + STEP_N))
+
+    // try to run the whole stretch at once, see spec.c
+    spec = 0;
+    if ((PicoIn.opt & POPT_EN_32X_SPEC) && CYCLES_GT(target, now + STEP_N)
+        && spec_allowed() && p32x_spec_begin() == 0)
+    {
+      spec = 1;
+      spec_now = now;
+      spec_event = event_time_next;
+      if (CYCLES_GT(target, now + STEP_SPEC))
+        target = now + STEP_SPEC;
+    }
+    else if (CYCLES_GT(target, now + STEP_N))
       target = now + STEP_N;
 
     while (CYCLES_GT(target, now))
@@ -492,6 +541,30 @@ void sync_sh2s_normal(unsigned int m68k_target)
         if (CYCLES_GT(now, ssh2.m68krcycles_done))
           now = ssh2.m68krcycles_done;
       }
+
+      if (spec && p32x_spec_conflicted)
+        break;
+    }
+
+    if (spec) {
+      // an event that came up must not have been overrun by more
+      // than the normal stepping would allow
+      if (!p32x_spec_conflicted && event_time_next && event_time_next != spec_event) {
+        if (CYCLES_GT(msh2.m68krcycles_done, event_time_next + STEP_N)
+            || CYCLES_GT(ssh2.m68krcycles_done, event_time_next + STEP_N))
+          p32x_spec_conflicted = 1;
+      }
+      if ((PREG8(msh2.peri_regs, 0x80) | PREG8(ssh2.peri_regs, 0x80)) & 0x20)
+        p32x_spec_conflicted = 1;
+
+      spec_done(p32x_spec_conflicted);
+      if (p32x_spec_conflicted) {
+        p32x_spec_rollback();
+        event_time_next = spec_event;
+        now = spec_now;
+        continue;
+      }
+      p32x_spec_commit();
     }
 
     p32x_timers_do(now - timer_cycles);
@@ -558,6 +631,8 @@ void PicoFrame32x(void)
 
   if (PicoIn.AHW & PAHW_MCD)
     pcd_prepare_frame();
+  if (p32x_drc_warm_pending)
+    p32x_drc_cache_warm();
 
   PicoFrameStart();
   PicoFrameHints();
@@ -0,0 +1,138 @@
+/*
+ * PicoDrive
+ * SH2 drc block list cache
+ *
+ * This work is licensed under the terms of MAME license.
+ * See COPYING file in the top-level directory.
+ *
+ * Translating all the blocks a game runs through takes a while, which
+ * shows as stutter whenever a new part of the game is reached. The
+ * translated code itself can't be kept (it has absolute host addresses
+ * and links to other blocks all over it), so instead the start addresses
+ * of ROM and BIOS blocks are saved when the cart is unloaded, and
+ * translated again right before the first 32X frame of the next run.
+ * Files are named by ROM crc and also check the ROM size and BIOS crc.
+ * SDRAM blocks are left out, what's there depends on the game state.
+ */
+#include "../pico_int.h"
+#include "../../cpu/sh2/compiler.h"
+
+#ifdef DRC_SH2
+#include <zlib.h>
+
+#define DRCC_MAGIC   "PDSH2BLK"
+#define DRCC_VERSION 1
+
+struct drcc_header {
+  char magic[8];
+  unsigned int version;
+  unsigned int rom_crc;
+  unsigned int rom_size;
+  unsigned int bios_crc;
+  unsigned int count;
+};
+
+int p32x_drc_warm_pending;
+
+static unsigned int *file_pcs;
+static int file_count;
+static int file_loaded; // looked for the file with this cart already
+static char file_path[512];
+
+static void drcc_header_fill(struct drcc_header *h, int count)
+{
+  memset(h, 0, sizeof(*h));
+  memcpy(h->magic, DRCC_MAGIC, sizeof(h->magic));
+  h->version = DRCC_VERSION;
+  h->rom_crc = rom_crc32();
+  h->rom_size = Pico.romsize;
+  h->bios_crc = crc32(0, Pico32xMem->sh2_rom_m.b, sizeof(Pico32xMem->sh2_rom_m));
+  h->bios_crc = crc32(h->bios_crc, Pico32xMem->sh2_rom_s.b, sizeof(Pico32xMem->sh2_rom_s));
+  h->count = count;
+}
+
+// called on 32X startup, Pico32xMem must be set up
+void p32x_drc_cache_load(void)
+{
+  struct drcc_header h, fh;
+  FILE *f;
+
+  if (file_loaded || PicoDrcCacheDir == NULL || !(PicoIn.opt & POPT_EN_DRC))
+    return;
+  file_loaded = 1;
+
+  drcc_header_fill(&h, 0);
+  snprintf(file_path, sizeof(file_path), "%s/%08x.sh2", PicoDrcCacheDir, h.rom_crc);
+
+  f = fopen(file_path, "rb");
+  if (f == NULL)
+    return;
+  if (fread(&fh, 1, sizeof(fh), f) != sizeof(fh)
+      || memcmp(fh.magic, h.magic, sizeof(h.magic)) || fh.version != h.version
+      || fh.rom_crc != h.rom_crc || fh.rom_size != h.rom_size || fh.bios_crc != h.bios_crc
+      || fh.count > 0x10000)
+  {
+    elprintf(EL_STATUS, "drc cache: ignoring %s", file_path);
+    goto out;
+  }
+
+  file_pcs = malloc(fh.count * sizeof(file_pcs[0]));
+  if (file_pcs == NULL)
+    goto out;
+  file_count = fread(file_pcs, sizeof(file_pcs[0]), fh.count, f);
+  elprintf(EL_STATUS, "drc cache: %d blocks from %s", file_count, file_path);
+  p32x_drc_warm_pending = 1;
+
+out:
+  fclose(f);
+}
+
+// translate everything known so far, after startup or a cache flush
+void p32x_drc_cache_warm(void)
+{
+  const unsigned int *pcs;
+  int count;
+
+  p32x_drc_warm_pending = 0;
+  if (!(PicoIn.opt & POPT_EN_DRC))
+    return;
+
+  if (file_pcs != NULL) {
+    sh2_drc_prewarm(file_pcs, file_count);
+    free(file_pcs);
+    file_pcs = NULL;
+  }
+  count = sh2_drc_warm_list(&pcs);
+  sh2_drc_prewarm(pcs, count);
+}
+
+// called on unload, before the drc is shut down
+void p32x_drc_cache_save(void)
+{
+  struct drcc_header h;
+  const unsigned int *pcs;
+  int count;
+  FILE *f;
+
+  count = sh2_drc_warm_list(&pcs);
+  if (file_loaded && count > file_count && Pico32xMem != NULL) {
+    drcc_header_fill(&h, count);
+    f = fopen(file_path, "wb");
+    if (f != NULL) {
+      if (fwrite(&h, 1, sizeof(h), f) != sizeof(h)
+          || fwrite(pcs, sizeof(pcs[0]), count, f) != count)
+        elprintf(EL_STATUS, "drc cache: write to %s failed", file_path);
+      fclose(f);
+    }
+  }
+
+  free(file_pcs);
+  file_pcs = NULL;
+  file_count = 0;
+  file_loaded = 0;
+  p32x_drc_warm_pending = 0;
+}
+
+#endif // DRC_SH2
+
+// vim:shiftwidth=2:ts=2:expandtab
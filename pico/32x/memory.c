@@ -58,33 +58,26 @@ static void (*m68k_write16_io)(u32 a, u32 d);
 // poll detection
 #define POLL_THRESHOLD 3
 
-static struct {
-  u32 addr, cycles;
-  int cnt;
-} m68k_poll;
+static struct poll_det m68k_poll;
 
 static int m68k_poll_detect(u32 a, u32 cycles, u32 flags)
 {
   int ret = 0;
 
-  if (a - 2 <= m68k_poll.addr && m68k_poll.addr <= a + 2
-    && cycles - m68k_poll.cycles <= 64 && !SekNotPolling)
-  {
-    if (m68k_poll.cnt++ > POLL_THRESHOLD) {
-      if (!(Pico32x.emu_flags & flags)) {
-        elprintf(EL_32X, "m68k poll addr %08x, cyc %u",
-          a, cycles - m68k_poll.cycles);
-        ret = 1;
-      }
-      Pico32x.emu_flags |= flags;
-    }
-  }
-  else {
-    m68k_poll.cnt = 0;
-    m68k_poll.addr = a;
+  if (SekNotPolling) {
+    poll_reset(&m68k_poll);
     SekNotPolling = 0;
   }
-  m68k_poll.cycles = cycles;
+
+  // comm regs are often polled in pairs, so allow a word either side
+  if (poll_detect(&m68k_poll, a, cycles, 2, 64) > POLL_THRESHOLD) {
+    if (!(Pico32x.emu_flags & flags)) {
+      elprintf(EL_32X, "m68k poll addr %08x", a);
+      PicoIdleHit(IDLE_M68K, SekPc);
+      ret = 1;
+    }
+    Pico32x.emu_flags |= flags;
+  }
 
   return ret;
 }
@@ -97,7 +90,7 @@ void p32x_m68k_poll_event(u32 flags)
     Pico32x.emu_flags &= ~flags;
     SekSetStop(0);
   }
-  m68k_poll.addr = m68k_poll.cnt = 0;
+  poll_reset(&m68k_poll);
 }
 
 static void sh2_poll_detect(SH2 *sh2, u32 a, u32 flags, int maxcnt)
@@ -106,10 +99,11 @@ static void sh2_poll_detect(SH2 *sh2, u32 a, u32 flags, int maxcnt)
 
   if (a == sh2->poll_addr && sh2->poll_cycles - cycles_left <= 10) {
     if (sh2->poll_cnt++ > maxcnt) {
-      if (!(sh2->state & flags))
+      if (!(sh2->state & flags)) {
         elprintf_sh2(sh2, EL_32X, "state: %02x->%02x",
           sh2->state, sh2->state | flags);
-
+        PicoIdleHit(IDLE_MSH2 + sh2->is_slave, sh2_pc(sh2));
+      }
       sh2->state |= flags;
       sh2_end_run(sh2, 1);
       pevt_log_sh2(sh2, EVT_POLL_START);
@@ -535,6 +529,7 @@ static void p32x_vdp_write16(u32 a, u32 d, SH2 *sh2)
     int len = Pico32x.vdp_regs[4 / 2] + 1;
     int len1 = len;
     a = Pico32x.vdp_regs[6 / 2];
+    p32x_spec_write(&dram[a]); // stays within a 512 byte line
     while (len1--) {
       dram[a] = d;
       a = (a & 0xff00) | ((a + 1) & 0xff);
@@ -1067,6 +1062,7 @@ void PicoWrite16_32x(u32 a, u32 d)
 #define sh2_write8_dramN(n) \
   if ((d & 0xff) != 0) { \
     u8 *dram = (u8 *)Pico32xMem->dram[n]; \
+    p32x_spec_write(&dram[a & 0x1ffff]); \
     dram[(a & 0x1ffff) ^ 1] = d; \
   }
 
@@ -1082,6 +1078,7 @@ static void m68k_write8_dram1_ow(u32 a, u32 d)
 
 #define sh2_write16_dramN(n) \
   u16 *pd = &Pico32xMem->dram[n][(a & 0x1ffff) / 2]; \
+  p32x_spec_write(pd); \
   if (!(a & 0x20000)) { \
     *pd = d; \
     return; \
@@ -1242,11 +1239,15 @@ static u32 sh2_read8_cs0(u32 a, SH2 *sh2)
 
   // 0x3ffc0 is veridied
   if ((a & 0x3ffc0) == 0x4000) {
+    if (p32x_spec_active)
+      p32x_spec_reg_access(sh2, a, 0);
     d = p32x_sh2reg_read16(a, sh2);
     goto out_16to8;
   }
 
   if ((a & 0x3fff0) == 0x4100) {
+    if (p32x_spec_active)
+      p32x_spec_reg_access(sh2, a, 0);
     d = p32x_vdp_read16(a);
     sh2_poll_detect(sh2, a, SH2_STATE_VPOLL, 7);
     goto out_16to8;
@@ -1303,6 +1304,8 @@ static u32 sh2_read16_cs0(u32 a, SH2 *sh2)
   sh2_burn_cycles(sh2, 1*2);
 
   if ((a & 0x3ffc0) == 0x4000) {
+    if (p32x_spec_active)
+      p32x_spec_reg_access(sh2, a, 0);
     d = p32x_sh2reg_read16(a, sh2);
     if (!(EL_LOGMASK & EL_PWM) && (a & 0x30) == 0x30) // hide PWM
       return d;
@@ -1310,6 +1313,8 @@ static u32 sh2_read16_cs0(u32 a, SH2 *sh2)
   }
 
   if ((a & 0x3fff0) == 0x4100) {
+    if (p32x_spec_active)
+      p32x_spec_reg_access(sh2, a, 0);
     d = p32x_vdp_read16(a);
     sh2_poll_detect(sh2, a, SH2_STATE_VPOLL, 7);
     goto out;
@@ -1363,6 +1368,8 @@ static void REGPARM(3) sh2_write8_cs0(u32 a, u32 d, SH2 *sh2)
 
   if (Pico32x.regs[0] & P32XS_FM) {
     if ((a & 0x3fff0) == 0x4100) {
+      if (p32x_spec_active)
+        p32x_spec_reg_access(sh2, a, 1);
       sh2->poll_addr = 0;
       p32x_vdp_write8(a, d);
       return;
@@ -1370,6 +1377,8 @@ static void REGPARM(3) sh2_write8_cs0(u32 a, u32 d, SH2 *sh2)
   }
 
   if ((a & 0x3ffc0) == 0x4000) {
+    if (p32x_spec_active)
+      p32x_spec_reg_access(sh2, a, 1);
     p32x_sh2reg_write8(a, d, sh2);
     return;
   }
@@ -1395,6 +1404,7 @@ static void REGPARM(3) sh2_write8_sdram(u32 a, u32 d, SH2 *sh2)
   if (t)
     sh2_drc_wcheck_ram(a, t, sh2->is_slave);
 #endif
+  p32x_spec_write(&Pico32xMem->sdram[a1]);
   Pico32xMem->sdram[a1 ^ 1] = d;
 }
 
@@ -1434,6 +1444,8 @@ static void REGPARM(3) sh2_write16_cs0(u32 a, u32 d, SH2 *sh2)
 
   if (Pico32x.regs[0] & P32XS_FM) {
     if ((a & 0x3fff0) == 0x4100) {
+      if (p32x_spec_active)
+        p32x_spec_reg_access(sh2, a, 1);
       sh2->poll_addr = 0;
       p32x_vdp_write16(a, d, sh2);
       return;
@@ -1447,6 +1459,8 @@ static void REGPARM(3) sh2_write16_cs0(u32 a, u32 d, SH2 *sh2)
   }
 
   if ((a & 0x3ffc0) == 0x4000) {
+    if (p32x_spec_active)
+      p32x_spec_reg_access(sh2, a, 1);
     p32x_sh2reg_write16(a, d, sh2);
     return;
   }
@@ -1472,6 +1486,7 @@ static void REGPARM(3) sh2_write16_sdram(u32 a, u32 d, SH2 *sh2)
   if (t)
     sh2_drc_wcheck_ram(a, t, sh2->is_slave);
 #endif
+  p32x_spec_write(&Pico32xMem->sdram[a1]);
   ((u16 *)Pico32xMem->sdram)[a1 / 2] = d;
 }
 
@@ -1971,6 +1986,7 @@ void Pico32xMemStateLoaded(void)
   ssh2.poll_addr = ssh2.poll_cycles = ssh2.poll_cnt = 0;
 
   sh2_drc_flush_all();
+  p32x_drc_warm_pending = 1;
 }
 
 // vim:shiftwidth=2:ts=2:expandtab
@@ -6,6 +6,7 @@
  * See COPYING file in the top-level directory.
  */
 #include "../pico_int.h"
+#include "../sound/resampler.h"
 
 static int pwm_cycles;
 static int pwm_mult;
@@ -14,6 +15,9 @@ static int pwm_irq_reload;
 static int pwm_doing_fifo;
 static int pwm_silent;
 
+static struct resampler pwm_rs;
+static int pwm_in[2*PWM_BUFF_LEN];
+
 void p32x_pwm_ctl_changed(void)
 {
   int control = Pico32x.regs[0x30 / 2];
@@ -243,75 +247,47 @@ void p32x_pwm_write16(unsigned int a, unsigned int d,
 void p32x_pwm_update(int *buf32, int length, int stereo)
 {
   short *pwmb;
-  int step;
-  int p = 0;
-  int xmd;
+  int *in;
+  int i, xmd;
 
   consume_fifo(NULL, SekCyclesDone());
 
   xmd = Pico32x.regs[0x30 / 2] & 0x0f;
   if (xmd == 0 || xmd == 0x06 || xmd == 0x09 || xmd == 0x0f)
     goto out; // invalid?
-  if (pwm_silent)
+  if (pwm_silent) {
+    resampler_reset(&pwm_rs);
     return;
+  }
 
-  step = (pwm_ptr << 16) / length;
   pwmb = Pico32xMem->pwm;
+  in = pwm_in;
 
-  if (stereo)
-  {
-    if (xmd == 0x05) {
-      // normal
-      while (length-- > 0) {
-        *buf32++ += pwmb[0];
-        *buf32++ += pwmb[1];
-
-        p += step;
-        pwmb += (p >> 16) * 2;
-        p &= 0xffff;
-      }
-    }
-    else if (xmd == 0x0a) {
-      // channel swap
-      while (length-- > 0) {
-        *buf32++ += pwmb[1];
-        *buf32++ += pwmb[0];
-
-        p += step;
-        pwmb += (p >> 16) * 2;
-        p &= 0xffff;
-      }
-    }
-    else {
-      // mono - LMD, RMD specify dst
-      if (xmd & 0x06) // src is R
-        pwmb++;
-      if (xmd & 0x0c) // dst is R
-        buf32++;
-      while (length-- > 0) {
-        *buf32 += *pwmb;
-
-        p += step;
-        pwmb += (p >> 16) * 2;
-        p &= 0xffff;
-        buf32 += 2;
-      }
+  // route to output channels, then resample
+  if (xmd == 0x05 || !stereo) {
+    // normal (mono output takes L)
+    for (i = 0; i < pwm_ptr * 2; i++)
+      in[i] = pwmb[i];
+  }
+  else if (xmd == 0x0a) {
+    // channel swap
+    for (i = 0; i < pwm_ptr * 2; i += 2) {
+      in[i] = pwmb[i + 1];
+      in[i + 1] = pwmb[i];
     }
   }
-  else
-  {
-    // mostly unused
-    while (length-- > 0) {
-      *buf32++ += pwmb[0];
-
-      p += step;
-      pwmb += (p >> 16) * 2;
-      p &= 0xffff;
+  else {
+    // mono - LMD, RMD specify dst
+    int src = (xmd & 0x06) ? 1 : 0; // src is R
+    int dst = (xmd & 0x0c) ? 1 : 0; // dst is R
+    for (i = 0; i < pwm_ptr * 2; i += 2) {
+      in[i + dst] = pwmb[i + src];
+      in[i + (dst ^ 1)] = 0;
     }
   }
+  resampler_run(&pwm_rs, buf32, length, stereo, in, pwm_ptr);
 
-  elprintf(EL_PWM, "pwm_update: pwm_ptr %d, len %d, step %04x, done %d",
-    pwm_ptr, length, step, (pwmb - Pico32xMem->pwm) / 2);
+  elprintf(EL_PWM, "pwm_update: pwm_ptr %d, len %d", pwm_ptr, length);
 
 out:
   pwm_ptr = 0;
@@ -319,6 +295,27 @@ out:
     && Pico32xMem->pwm_current[1] == 0;
 }
 
+// for rollback of speculative sh2 runs
+void p32x_pwm_save_vars(int *vars)
+{
+  vars[0] = pwm_cycles;
+  vars[1] = pwm_mult;
+  vars[2] = pwm_ptr;
+  vars[3] = pwm_irq_reload;
+  vars[4] = pwm_doing_fifo;
+  vars[5] = pwm_silent;
+}
+
+void p32x_pwm_load_vars(const int *vars)
+{
+  pwm_cycles = vars[0];
+  pwm_mult = vars[1];
+  pwm_ptr = vars[2];
+  pwm_irq_reload = vars[3];
+  pwm_doing_fifo = vars[4];
+  pwm_silent = vars[5];
+}
+
 void p32x_pwm_state_loaded(void)
 {
   int cycles_diff_sh2;
@@ -275,6 +275,10 @@ static void sci_trigger(SH2 *sh2, u8 *r)
   if (!(PREG8(oregs, 2) & 0x10))
     return; // receiver not enabled
 
+  // the other sh2 may have looked at its SCI regs already
+  if (p32x_spec_active)
+    p32x_spec_conflict(sh2);
+
   PREG8(oregs, 5) = PREG8(r, 3); // other.RDR = this.TDR
   PREG8(r, 4) |= 0x80;     // TDRE - TDR empty
   PREG8(oregs, 4) |= 0x40; // RDRF - RDR Full
@@ -0,0 +1,256 @@
+/*
+ * PicoDrive
+ * speculative SH2 sync with rollback
+ *
+ * This work is licensed under the terms of MAME license.
+ * See COPYING file in the top-level directory.
+ *
+ * Normally both SH2s are stepped in short slices (STEP_N m68k cycles)
+ * so that one of them never gets too far ahead of the other. With
+ * speculation enabled, 32x.c lets them run a much longer stretch and this
+ * module checks afterwards whether the result could be told apart from
+ * the normal one:
+ * - state touched by the SH2s is checkpointed at the start of the stretch;
+ *   SDRAM and framebuffer are saved in pages on first write,
+ * - accesses to the shared system/VDP registers are logged with the time
+ *   of access, a read of something the other cpu wrote "later" (or a
+ *   write of something it already read "later") is a conflict,
+ * - irq lines of the other cpu changing is also a conflict.
+ * On conflict the running cpu is stopped and everything is restored, the
+ * caller then redoes the stretch with the normal stepping.
+ *
+ * Plain SDRAM reads are not tracked (the drc reads constant addresses
+ * directly), so games that sync through SDRAM alone are only as safe as
+ * with the old scheduler's ~440 cycle slices, which they did not get
+ * either. The m68k is not running while the SH2s are synced, so its side
+ * needs no checkpoint.
+ */
+#include "../pico_int.h"
+#include "../../cpu/sh2/compiler.h"
+
+#define SPEC_PAGE_SHIFT 10
+#define SPEC_PAGE_SIZE  (1 << SPEC_PAGE_SHIFT)
+#define SPEC_PAGES_SDRAM (sizeof(Pico32xMem->sdram) >> SPEC_PAGE_SHIFT)
+#define SPEC_PAGES (SPEC_PAGES_SDRAM + (sizeof(Pico32xMem->dram) >> SPEC_PAGE_SHIFT))
+
+// 32 system regs, 8 vdp regs
+#define SPEC_SLOTS 40
+
+int p32x_spec_active;
+int p32x_spec_conflicted;
+
+static struct {
+  SH2 sh2s[2];
+  struct Pico32x p32x;
+  unsigned int event_times[P32X_EVENT_COUNT];
+  unsigned short pal[0x100];
+  signed short pwm_current[2];
+  unsigned short pwm_fifo[2][4];
+  int pwm_vars[P32X_PWM_VARS];
+} cp;
+
+static unsigned char  (*page_data)[SPEC_PAGE_SIZE];
+static unsigned short page_list[SPEC_PAGES];
+static unsigned char  page_saved[SPEC_PAGES];
+static int page_cnt;
+
+static unsigned int  wr_time[SPEC_SLOTS];
+static unsigned int  rd_time[2][SPEC_SLOTS];
+static unsigned char wr_cpu[SPEC_SLOTS]; // 0 - none, else cpu + 1
+static unsigned char rd_seen[2][SPEC_SLOTS];
+
+static unsigned char *page_ptr(int page)
+{
+  if (page < SPEC_PAGES_SDRAM)
+    return Pico32xMem->sdram + (page << SPEC_PAGE_SHIFT);
+  page -= SPEC_PAGES_SDRAM;
+  return (unsigned char *)Pico32xMem->dram + (page << SPEC_PAGE_SHIFT);
+}
+
+int p32x_spec_begin(void)
+{
+  if (page_data == NULL) {
+    page_data = malloc(SPEC_PAGES * SPEC_PAGE_SIZE);
+    if (page_data == NULL)
+      return -1;
+  }
+
+  memcpy(cp.sh2s, sh2s, sizeof(cp.sh2s));
+  memcpy(&cp.p32x, &Pico32x, sizeof(cp.p32x));
+  memcpy(cp.event_times, p32x_event_times, sizeof(cp.event_times));
+  memcpy(cp.pal, Pico32xMem->pal, sizeof(cp.pal));
+  memcpy(cp.pwm_current, Pico32xMem->pwm_current, sizeof(cp.pwm_current));
+  memcpy(cp.pwm_fifo, Pico32xMem->pwm_fifo, sizeof(cp.pwm_fifo));
+  p32x_pwm_save_vars(cp.pwm_vars);
+
+  memset(wr_cpu, 0, sizeof(wr_cpu));
+  memset(rd_seen, 0, sizeof(rd_seen));
+
+  p32x_spec_conflicted = 0;
+  p32x_spec_active = 1;
+  return 0;
+}
+
+void p32x_spec_save_page(const void *p)
+{
+  uintptr_t o = (const unsigned char *)p - Pico32xMem->sdram;
+  int page;
+
+  if (o < sizeof(Pico32xMem->sdram))
+    page = o >> SPEC_PAGE_SHIFT;
+  else {
+    o = (const unsigned char *)p - (unsigned char *)Pico32xMem->dram;
+    page = SPEC_PAGES_SDRAM + (o >> SPEC_PAGE_SHIFT);
+  }
+
+  if (page_saved[page])
+    return;
+  page_saved[page] = 1;
+  page_list[page_cnt] = page;
+  memcpy(page_data[page_cnt++], page_ptr(page), SPEC_PAGE_SIZE);
+}
+
+void p32x_spec_conflict(SH2 *sh2)
+{
+  elprintf_sh2(sh2, EL_32X, "spec: conflict @%08x", sh2_pc(sh2));
+  p32x_spec_conflicted = 1;
+  if (sh2->state & SH2_STATE_RUN)
+    sh2_end_run(sh2, 1);
+}
+
+// a is a cs0 address in the system or vdp register range
+void p32x_spec_reg_access(SH2 *sh2, unsigned int a, int is_write)
+{
+  int c = sh2->is_slave, o = c ^ 1;
+  unsigned int t;
+  int slot;
+
+  if (!(sh2->state & SH2_STATE_RUN))
+    return;
+
+  if ((a & 0x3ffc0) == 0x4000) {
+    slot = (a & 0x3e) / 2;
+    if (0x14/2 <= slot && slot <= 0x1c/2)
+      return; // irq clear regs, per cpu
+  }
+  else if ((a & 0x3fff0) == 0x4100)
+    slot = 32 + (a & 0x0e) / 2;
+  else
+    return;
+
+  t = sh2_cycles_done_m68k(sh2);
+
+  // the other cpu wrote here at a time we haven't reached yet
+  if (wr_cpu[slot] == o + 1 && CYCLES_GT(wr_time[slot], t)) {
+    p32x_spec_conflict(sh2);
+    return;
+  }
+
+  if (is_write) {
+    // ..or has already read a value we are only now writing
+    if (rd_seen[o][slot] && CYCLES_GT(rd_time[o][slot], t)) {
+      p32x_spec_conflict(sh2);
+      return;
+    }
+    wr_cpu[slot] = c + 1;
+    wr_time[slot] = t;
+  }
+  else if (!rd_seen[c][slot] || CYCLES_GT(t, rd_time[c][slot])) {
+    rd_seen[c][slot] = 1;
+    rd_time[c][slot] = t;
+  }
+}
+
+static void spec_pages_clear(void)
+{
+  int i;
+
+  for (i = 0; i < page_cnt; i++)
+    page_saved[page_list[i]] = 0;
+  page_cnt = 0;
+}
+
+void p32x_spec_commit(void)
+{
+  p32x_spec_active = 0;
+  spec_pages_clear();
+}
+
+#ifdef DRC_SH2
+// drop blocks that were compiled from (or over) data that is going away
+static void spec_drc_check(void)
+{
+  unsigned short *cur, *old;
+  unsigned int o;
+  int i, j, k;
+
+  for (i = 0; i < page_cnt; i++) {
+    if (page_list[i] >= SPEC_PAGES_SDRAM)
+      continue;
+    o = page_list[i] << SPEC_PAGE_SHIFT;
+    cur = (unsigned short *)(Pico32xMem->sdram + o);
+    old = (unsigned short *)page_data[i];
+    for (j = 0; j < SPEC_PAGE_SIZE / 2; j++) {
+      unsigned int a = o + j * 2;
+      int t = Pico32xMem->drcblk_ram[a >> SH2_DRCBLK_RAM_SHIFT];
+      if (t && cur[j] != old[j])
+        sh2_drc_wcheck_ram(0x06000000 | a, t, 0);
+    }
+  }
+
+  for (k = 0; k < 2; k++) {
+    cur = (unsigned short *)sh2s[k].data_array;
+    old = (unsigned short *)cp.sh2s[k].data_array;
+    for (j = 0; j < sizeof(sh2s[k].data_array) / 2; j++) {
+      int t = Pico32xMem->drcblk_da[k][(j * 2) >> SH2_DRCBLK_DA_SHIFT];
+      if (t && cur[j] != old[j])
+        sh2_drc_wcheck_da(0xc0000000 | (j * 2), t, k);
+    }
+  }
+}
+#endif
+
+void p32x_spec_rollback(void)
+{
+  int fs_changed;
+  int i;
+
+  p32x_spec_active = 0;
+
+#ifdef DRC_SH2
+  if (PicoIn.opt & POPT_EN_DRC)
+    spec_drc_check();
+#endif
+  for (i = 0; i < page_cnt; i++)
+    memcpy(page_ptr(page_list[i]), page_data[i], SPEC_PAGE_SIZE);
+  spec_pages_clear();
+
+  fs_changed = (Pico32x.vdp_regs[0x0a / 2] ^ cp.p32x.vdp_regs[0x0a / 2]) & P32XV_FS;
+
+  memcpy(sh2s, cp.sh2s, sizeof(cp.sh2s));
+  memcpy(&Pico32x, &cp.p32x, sizeof(Pico32x));
+  memcpy(p32x_event_times, cp.event_times, sizeof(cp.event_times));
+  memcpy(Pico32xMem->pal, cp.pal, sizeof(cp.pal));
+  memcpy(Pico32xMem->pwm_current, cp.pwm_current, sizeof(cp.pwm_current));
+  memcpy(Pico32xMem->pwm_fifo, cp.pwm_fifo, sizeof(cp.pwm_fifo));
+  p32x_pwm_load_vars(cp.pwm_vars);
+  Pico32x.dirty_pal = 1;
+
+  if (fs_changed)
+    Pico32xSwapDRAM((Pico32x.vdp_regs[0x0a / 2] & P32XV_FS) ^ P32XV_FS);
+
+  // a woken up m68k can't be put back to sleep, but it will
+  // notice it's polling again soon enough
+  if (!SekIsStoppedM68k())
+    Pico32x.emu_flags &= ~(P32XF_68KCPOLL|P32XF_68KVPOLL);
+}
+
+void p32x_spec_finish(void)
+{
+  p32x_spec_active = 0;
+  spec_pages_clear();
+  free(page_data);
+  page_data = NULL;
+}
+
+// vim:shiftwidth=2:ts=2:expandtab
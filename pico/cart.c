@@ -10,10 +10,21 @@
 #include "pico_int.h"
 #include "../cpu/debug.h"
 #include "../unzip/unzip.h"
+#include "pico_thread.h"
+#include "cd/pdz.h"
 #include <zlib.h>
+#ifdef USE_ROM_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
 
 
 static int rom_alloc_size;
+static int rom_file_mapped; // some of ROM area is a private file mapping
 static const char *rom_exts[] = { "bin", "gen", "smd", "iso", "sms", "gg", "sg" };
 
 void (*PicoCartUnloadHook)(void);
@@ -23,10 +34,15 @@ void (*PicoCartLoadProgressCB)(int percent) = NULL;
 void (*PicoCDLoadProgressCB)(const char *fname, int percent) = NULL; // handled in Pico/cd/cd_file.c
 
 int PicoGameLoaded;
+const char *PicoCartCacheDir; // byteswapped ROM images are kept here, if set
+const char *PicoDrcCacheDir;  // SH2 drc block lists, if set
 
 static void PicoCartDetect(const char *carthw_cfg);
 
 /* cso struct */
+#define CSO_CACHE_BLOCKS 64 // decompressed blocks kept by the read-ahead worker
+#define CSO_READ_AHEAD   32
+
 typedef struct _cso_struct
 {
   unsigned char in_buff[2*2048];
@@ -43,7 +59,23 @@ typedef struct _cso_struct
   } header;
   unsigned int  fpos_in;  // input file read pointer
   unsigned int  fpos_out; // pos in virtual decompressed file
-  int block_in_buff;      // block which we have read in in_buff
+  int block_in_buff;      // block which we have decompressed in out_buff
+  int block_count;
+#ifdef USE_THREADS
+  struct {
+    pico_thread_t thread;
+    pico_mutex_t lock;
+    pico_cond_t cond;
+    FILE *f;              // own handle, main thread keeps seeking the other
+    unsigned int fpos_in;
+    int next_block;       // where the reader is headed
+    int bad_block;        // failed to read, not retried until passed
+    int running, quit;
+    int tags[CSO_CACHE_BLOCKS];
+    unsigned char in_buff[2*2048];
+    unsigned char data[CSO_CACHE_BLOCKS][2048];
+  } *ra;
+#endif
   int pad;
   int index[0];
 }
@@ -75,6 +107,254 @@ static int uncompress_buf(void *dest, int destLen, void *source, int sourceLen)
     return inflateEnd(&stream);
 }
 
+// read and decompress one 2048 byte block, in_buff is scratch
+static int cso_read_block(cso_struct *cso, FILE *f, unsigned int *fpos_in,
+  unsigned char *in_buff, int block, unsigned char *dst)
+{
+  int index = cso->index[block];
+  int index_end = cso->index[block+1];
+  int read_pos, read_len, ret;
+
+  read_pos = (index&0x7fffffff) << cso->header.align;
+  if (index < 0) {
+    if (read_pos != *fpos_in)
+      fseek(f, read_pos, SEEK_SET);
+    ret = fread(dst, 1, 2048, f);
+    *fpos_in = read_pos + ret;
+    return ret == 2048 ? 0 : -1;
+  }
+
+  read_len = (((index_end&0x7fffffff) << cso->header.align) - read_pos) & 0xfff;
+  if (read_pos != *fpos_in)
+    fseek(f, read_pos, SEEK_SET);
+  ret = fread(in_buff, 1, read_len, f);
+  *fpos_in = read_pos + ret;
+  if (ret != read_len) {
+    elprintf(EL_STATUS, "cso: read failed @ %08x", read_pos);
+    return -1;
+  }
+  ret = uncompress_buf(dst, 2048, in_buff, read_len);
+  if (ret != 0) {
+    elprintf(EL_STATUS, "cso: uncompress failed @ %08x with %i", read_pos, ret);
+    return -1;
+  }
+  return 0;
+}
+
+#ifdef USE_THREADS
+// keeps decompressing ahead of the reader (which follows cdd.lba for CD),
+// so that crossing many blocks doesn't stall the emulation thread
+static void *cso_ra_thread(void *arg)
+{
+  cso_struct *cso = arg;
+  unsigned char buf[2048];
+  int block, end, slot, ret;
+
+  pico_mutex_lock(&cso->ra->lock);
+  while (!cso->ra->quit)
+  {
+    // first block in the window that we don't have yet
+    block = cso->ra->next_block;
+    if (block > cso->ra->bad_block)
+      cso->ra->bad_block = -1;
+    end = block + CSO_READ_AHEAD;
+    if (end > cso->block_count)
+      end = cso->block_count;
+    for (; block < end; block++)
+      if (cso->ra->tags[block % CSO_CACHE_BLOCKS] != block)
+        break;
+    if (block >= end || block == cso->ra->bad_block) {
+      pico_cond_wait(&cso->ra->cond, &cso->ra->lock);
+      continue;
+    }
+
+    pico_mutex_unlock(&cso->ra->lock);
+    ret = cso_read_block(cso, cso->ra->f, &cso->ra->fpos_in,
+            cso->ra->in_buff, block, buf);
+    pico_mutex_lock(&cso->ra->lock);
+
+    if (ret != 0) {
+      // bad block, leave it to the reader and wait for it to move on
+      cso->ra->bad_block = block;
+      continue;
+    }
+    slot = block % CSO_CACHE_BLOCKS;
+    memcpy(cso->ra->data[slot], buf, 2048);
+    cso->ra->tags[slot] = block;
+  }
+  pico_mutex_unlock(&cso->ra->lock);
+  return NULL;
+}
+
+static void cso_ra_start(cso_struct *cso, const char *path)
+{
+  int i;
+
+  cso->ra = calloc(1, sizeof(*cso->ra));
+  if (cso->ra == NULL)
+    return;
+  for (i = 0; i < CSO_CACHE_BLOCKS; i++)
+    cso->ra->tags[i] = -1;
+  cso->ra->bad_block = -1;
+  cso->ra->f = fopen(path, "rb");
+  if (cso->ra->f == NULL)
+    goto fail;
+  pico_mutex_init(&cso->ra->lock);
+  pico_cond_init(&cso->ra->cond);
+  if (pico_thread_create(&cso->ra->thread, cso_ra_thread, cso) != 0) {
+    pico_cond_destroy(&cso->ra->cond);
+    pico_mutex_destroy(&cso->ra->lock);
+    fclose(cso->ra->f);
+    goto fail;
+  }
+  cso->ra->running = 1;
+  return;
+
+fail:
+  free(cso->ra);
+  cso->ra = NULL;
+}
+
+static void cso_ra_stop(cso_struct *cso)
+{
+  if (cso->ra == NULL)
+    return;
+
+  pico_mutex_lock(&cso->ra->lock);
+  cso->ra->quit = 1;
+  pico_cond_signal(&cso->ra->cond);
+  pico_mutex_unlock(&cso->ra->lock);
+  pico_thread_join(cso->ra->thread);
+
+  pico_cond_destroy(&cso->ra->cond);
+  pico_mutex_destroy(&cso->ra->lock);
+  fclose(cso->ra->f);
+  free(cso->ra);
+  cso->ra = NULL;
+}
+
+static int cso_ra_get(cso_struct *cso, int block, unsigned char *dst)
+{
+  int slot = block % CSO_CACHE_BLOCKS, hit = 0;
+
+  if (cso->ra == NULL)
+    return 0;
+
+  pico_mutex_lock(&cso->ra->lock);
+  if (cso->ra->tags[slot] == block) {
+    memcpy(dst, cso->ra->data[slot], 2048);
+    hit = 1;
+  }
+  pico_mutex_unlock(&cso->ra->lock);
+  return hit;
+}
+
+static void cso_ra_hint(cso_struct *cso, int block)
+{
+  if (cso->ra == NULL)
+    return;
+
+  pico_mutex_lock(&cso->ra->lock);
+  cso->ra->next_block = block;
+  pico_cond_signal(&cso->ra->cond);
+  pico_mutex_unlock(&cso->ra->lock);
+}
+#else
+#define cso_ra_start(cso, path)
+#define cso_ra_stop(cso)
+#define cso_ra_get(cso, block, dst) 0
+#define cso_ra_hint(cso, block)
+#endif
+
+/* pdz struct */
+#define PDZ_CACHE_HUNKS 4 // decompressed hunks kept around
+
+typedef struct _pdz_struct
+{
+  pdz_header header;
+  unsigned int fpos_in;    // input file read pointer
+  unsigned int fpos_out;   // pos in virtual decompressed file
+  unsigned int total_bytes;
+  unsigned int hunk_bytes;
+  unsigned int hunk_count;
+  unsigned int clock;
+  unsigned char *in_buff;
+  struct {
+    int hunk;
+    unsigned int stamp;
+    unsigned char *data;
+  } cache[PDZ_CACHE_HUNKS];
+  unsigned int index[0];
+}
+pdz_struct;
+
+// undo per channel delta coding of 16bit little endian stereo samples
+static void pdz_undelta(unsigned char *p, int len)
+{
+  unsigned int prev[2] = { 0, 0 };
+  int i, c;
+
+  for (i = 0; i + 4 <= len; i += 4) {
+    for (c = 0; c < 2; c++) {
+      unsigned int v = prev[c] + (p[i+c*2] | (p[i+c*2+1] << 8));
+      p[i+c*2] = v;
+      p[i+c*2+1] = v >> 8;
+      prev[c] = v;
+    }
+  }
+}
+
+// read and decompress a hunk, returns where it is in the cache
+static unsigned char *pdz_get_hunk(pdz_struct *pdz, FILE *f, int hunk)
+{
+  unsigned int index = pdz->index[hunk];
+  unsigned int read_pos = index & PDZ_HUNK_OFFS;
+  unsigned int read_len = (pdz->index[hunk+1] & PDZ_HUNK_OFFS) - read_pos;
+  unsigned int out_len = pdz->hunk_bytes;
+  unsigned char *dst;
+  int i, lru = 0, ret;
+
+  for (i = 0; i < PDZ_CACHE_HUNKS; i++) {
+    if (pdz->cache[i].hunk == hunk) {
+      pdz->cache[i].stamp = ++pdz->clock;
+      return pdz->cache[i].data;
+    }
+    if (pdz->cache[i].stamp < pdz->cache[lru].stamp)
+      lru = i;
+  }
+
+  if (hunk == pdz->hunk_count - 1)
+    out_len = (pdz->header.sectors - hunk * pdz->header.hunk_sectors) * PDZ_SECTOR_SIZE;
+  if (read_len > pdz->hunk_bytes) {
+    elprintf(EL_STATUS, "pdz: bad hunk %i", hunk);
+    return NULL;
+  }
+
+  dst = pdz->cache[lru].data;
+  pdz->cache[lru].hunk = -1;
+  if (read_pos != pdz->fpos_in)
+    fseek(f, read_pos, SEEK_SET);
+  ret = fread((index & PDZ_HUNK_STORED) ? dst : pdz->in_buff, 1, read_len, f);
+  pdz->fpos_in = read_pos + ret;
+  if (ret != read_len) {
+    elprintf(EL_STATUS, "pdz: read failed @ %08x", read_pos);
+    return NULL;
+  }
+  if (!(index & PDZ_HUNK_STORED)) {
+    ret = uncompress_buf(dst, out_len, pdz->in_buff, read_len);
+    if (ret != 0) {
+      elprintf(EL_STATUS, "pdz: uncompress failed @ %08x with %i", read_pos, ret);
+      return NULL;
+    }
+  }
+  if (index & PDZ_HUNK_DELTA)
+    pdz_undelta(dst, out_len);
+
+  pdz->cache[lru].hunk = hunk;
+  pdz->cache[lru].stamp = ++pdz->clock;
+  return dst;
+}
+
 static const char *get_ext(const char *path)
 {
   const char *ext;
@@ -97,8 +377,132 @@ struct zip_file {
   unsigned char inbuf[16384];
   long start;
   unsigned int pos;
+#ifdef USE_THREADS
+  // whole entry inflated by a worker, readers only wait for what they need
+  pico_thread_t thread;
+  pico_mutex_t lock;
+  pico_cond_t cond;
+  unsigned char *data;
+  unsigned int done;      // bytes inflated so far
+  int finished, quit;
+  int reopened;
+  char *path;
+#endif
 };
 
+// inflate from the current stream position
+static int zip_inflate(struct zip_file *z, void *ptr, size_t bytes)
+{
+  int ret;
+
+  z->stream.next_out = ptr;
+  z->stream.avail_out = bytes;
+  while (z->stream.avail_out != 0) {
+    if (z->stream.avail_in == 0) {
+      z->stream.avail_in = fread(z->inbuf, 1, sizeof(z->inbuf), z->zip->fp);
+      if (z->stream.avail_in == 0)
+        break;
+      z->stream.next_in = z->inbuf;
+    }
+    ret = inflate(&z->stream, Z_NO_FLUSH);
+    if (ret == Z_STREAM_END)
+      break;
+    if (ret != Z_OK) {
+      elprintf(EL_STATUS, "zip: inflate: %d", ret);
+      return 0;
+    }
+  }
+  return bytes - z->stream.avail_out;
+}
+
+#ifdef USE_THREADS
+#define ZIP_THREAD_MAX_SIZE (16*1024*1024) // ROMs, not CD images
+#define ZIP_THREAD_CHUNK    (64*1024)
+
+// media detection opens, peeks and closes the file before the real load,
+// so the last inflater is kept around for the next pm_open() to pick up
+static struct zip_file *zip_parked;
+
+static void *zip_inflate_thread(void *arg)
+{
+  struct zip_file *z = arg;
+  unsigned int done = 0;
+  int ret;
+
+  while (done < z->file.size) {
+    ret = z->file.size - done;
+    if (ret > ZIP_THREAD_CHUNK)
+      ret = ZIP_THREAD_CHUNK;
+    ret = zip_inflate(z, z->data + done, ret);
+    done += ret;
+
+    pico_mutex_lock(&z->lock);
+    z->done = done;
+    pico_cond_broadcast(&z->cond);
+    ret = (ret == 0 || z->quit);
+    pico_mutex_unlock(&z->lock);
+    if (ret)
+      break;
+  }
+
+  pico_mutex_lock(&z->lock);
+  z->finished = 1;
+  pico_cond_broadcast(&z->cond);
+  pico_mutex_unlock(&z->lock);
+  return NULL;
+}
+
+static void zip_thread_start(struct zip_file *z, const char *path)
+{
+  if (z->entry->compression_method == 0 || z->file.size > ZIP_THREAD_MAX_SIZE)
+    return;
+
+  z->data = malloc(z->file.size);
+  z->path = strdup(path);
+  if (z->data == NULL || z->path == NULL)
+    goto fail;
+  pico_mutex_init(&z->lock);
+  pico_cond_init(&z->cond);
+  if (pico_thread_create(&z->thread, zip_inflate_thread, z) == 0)
+    return;
+
+  pico_cond_destroy(&z->cond);
+  pico_mutex_destroy(&z->lock);
+fail:
+  free(z->data);
+  free(z->path);
+  z->data = NULL;
+  z->path = NULL;
+}
+
+static void zip_release(struct zip_file *z)
+{
+  if (z->data != NULL) {
+    pico_mutex_lock(&z->lock);
+    z->quit = 1;
+    pico_mutex_unlock(&z->lock);
+    pico_thread_join(z->thread);
+    pico_cond_destroy(&z->cond);
+    pico_mutex_destroy(&z->lock);
+    free(z->data);
+    free(z->path);
+  }
+  inflateEnd(&z->stream);
+  closezip(z->zip);
+  free(z);
+}
+
+static void zip_unpark(void)
+{
+  if (zip_parked != NULL)
+    zip_release(zip_parked);
+  zip_parked = NULL;
+}
+#else
+#define zip_thread_start(z, path)
+#define zip_unpark()
+#endif
+
 pm_file *pm_open(const char *path)
 {
   pm_file *file = NULL;
@@ -116,6 +520,17 @@ pm_file *pm_open(const char *path)
     ZIP *zipfile;
     int i, ret;
 
+#ifdef USE_THREADS
+    if (zip_parked != NULL && strcmp(zip_parked->path, path) == 0) {
+      zfile = zip_parked;
+      zip_parked = NULL;
+      zfile->pos = 0;
+      zfile->reopened = 1;
+      return &zfile->file;
+    }
+#endif
+    zip_unpark();
+
     zipfile = openzip(path);
     if (zipfile != NULL)
     {
@@ -154,6 +569,7 @@ found_rom_zip:
       zfile->file.size = zipentry->uncompressed_size;
       zfile->file.type = PMT_ZIP;
       strncpy(zfile->file.ext, ext, sizeof(zfile->file.ext) - 1);
+      zip_thread_start(zfile, path);
       return &zfile->file;
 
 zip_failed:
@@ -209,12 +625,14 @@ zip_failed:
     cso->fpos_in = ftell(f);
     cso->fpos_out = 0;
     cso->block_in_buff = -1;
+    cso->block_count = cso->header.total_bytes >> 11;
     file = calloc(1, sizeof(*file));
     if (file == NULL) goto cso_failed;
     file->file  = f;
     file->param = cso;
     file->size  = cso->header.total_bytes;
     file->type  = PMT_CSO;
+    cso_ra_start(cso, path);
     return file;
 
 cso_failed:
@@ -223,6 +641,72 @@ cso_failed:
     return NULL;
   }
 
+  else if (strcasecmp(ext, "pdz") == 0)
+  {
+    pdz_struct *pdz = NULL, *tmp;
+    pdz_header header;
+    int i, size;
+
+    f = fopen(path, "rb");
+    if (f == NULL)
+      goto pdz_failed;
+
+    if (fread(&header, 1, sizeof(header), f) != sizeof(header))
+      goto pdz_failed;
+
+    if (strncmp(header.magic, PDZ_MAGIC, 4) != 0 || header.version != PDZ_VERSION
+        || header.hunk_sectors == 0 || header.hunk_sectors > 256
+        || header.track_count == 0 || header.track_count > PDZ_MAX_TRACKS) {
+      elprintf(EL_STATUS, "pdz: bad header");
+      goto pdz_failed;
+    }
+
+    size = (header.sectors + header.hunk_sectors - 1) / header.hunk_sectors;
+    tmp = calloc(1, sizeof(*pdz) + (size + 1) * 4);
+    if (tmp == NULL)
+      goto pdz_failed;
+    pdz = tmp;
+    pdz->header = header;
+    pdz->hunk_count = size;
+    pdz->hunk_bytes = header.hunk_sectors * PDZ_SECTOR_SIZE;
+    pdz->total_bytes = header.sectors * PDZ_SECTOR_SIZE;
+
+    fseek(f, sizeof(header) + header.track_count * sizeof(pdz_track), SEEK_SET);
+    size = (size + 1) * 4; // index size
+    if (fread(pdz->index, 1, size, f) != size) {
+      elprintf(EL_STATUS, "pdz: premature EOF");
+      goto pdz_failed;
+    }
+
+    pdz->in_buff = malloc(pdz->hunk_bytes * (PDZ_CACHE_HUNKS + 1));
+    if (pdz->in_buff == NULL)
+      goto pdz_failed;
+    for (i = 0; i < PDZ_CACHE_HUNKS; i++) {
+      pdz->cache[i].hunk = -1;
+      pdz->cache[i].data = pdz->in_buff + pdz->hunk_bytes * (i + 1);
+    }
+
+    // all ok
+    pdz->fpos_in = ftell(f);
+    pdz->fpos_out = 0;
+    file = calloc(1, sizeof(*file));
+    if (file == NULL) goto pdz_failed;
+    file->file  = f;
+    file->param = pdz;
+    file->size  = pdz->total_bytes;
+    file->type  = PMT_PDZ;
+    strncpy(file->ext, ext, sizeof(file->ext) - 1);
+    return file;
+
+pdz_failed:
+    if (pdz != NULL) {
+      free(pdz->in_buff);
+      free(pdz);
+    }
+    if (f != NULL) fclose(f);
+    return NULL;
+  }
+
   /* not a zip, treat as uncompressed file */
   f = fopen(path, "rb");
   if (f == NULL) return NULL;
@@ -267,33 +751,35 @@ size_t pm_read(void *ptr, size_t bytes, pm_file *stream)
       return ret;
     }
 
-    z->stream.next_out = ptr;
-    z->stream.avail_out = bytes;
-    while (z->stream.avail_out != 0) {
-      if (z->stream.avail_in == 0) {
-        z->stream.avail_in = fread(z->inbuf, 1, sizeof(z->inbuf), z->zip->fp);
-        if (z->stream.avail_in == 0)
-          break;
-        z->stream.next_in = z->inbuf;
-      }
-      ret = inflate(&z->stream, Z_NO_FLUSH);
-      if (ret == Z_STREAM_END)
-        break;
-      if (ret != Z_OK) {
-        elprintf(EL_STATUS, "zip: inflate: %d", ret);
+#ifdef USE_THREADS
+    if (z->data != NULL) {
+      unsigned int want = z->pos + bytes;
+      if (want > z->file.size || want < z->pos)
+        want = z->file.size;
+
+      pico_mutex_lock(&z->lock);
+      while (z->done < want && !z->finished)
+        pico_cond_wait(&z->cond, &z->lock);
+      ret = (z->done < want ? z->done : want) - z->pos;
+      pico_mutex_unlock(&z->lock);
+
+      if (ret <= 0)
         return 0;
-      }
+      memcpy(ptr, z->data + z->pos, ret);
+      z->pos += ret;
+      return ret;
     }
-    z->pos += bytes - z->stream.avail_out;
-    return bytes - z->stream.avail_out;
+#endif
+
+    ret = zip_inflate(z, ptr, bytes);
+    z->pos += ret;
+    return ret;
   }
   else if (stream->type == PMT_CSO)
   {
     cso_struct *cso = stream->param;
-    int read_pos, read_len, out_offs, rret;
+    int out_offs, rret;
     int block = cso->fpos_out >> 11;
-    int index = cso->index[block];
-    int index_end = cso->index[block+1];
     unsigned char *out = ptr, *tmp_dst;
 
     ret = 0;
@@ -304,33 +790,16 @@ size_t pm_read(void *ptr, size_t bytes, pm_file *stream)
            tmp_dst = out;
       else tmp_dst = cso->out_buff;
 
-      read_pos = (index&0x7fffffff) << cso->header.align;
-
-      if (index < 0) {
-        if (read_pos != cso->fpos_in)
-          fseek(stream->file, read_pos, SEEK_SET);
-        rret = fread(tmp_dst, 1, 2048, stream->file);
-        cso->fpos_in = read_pos + rret;
-        if (rret != 2048) break;
-      } else {
-        read_len = (((index_end&0x7fffffff) << cso->header.align) - read_pos) & 0xfff;
-        if (block != cso->block_in_buff)
-        {
-          if (read_pos != cso->fpos_in)
-            fseek(stream->file, read_pos, SEEK_SET);
-          rret = fread(cso->in_buff, 1, read_len, stream->file);
-          cso->fpos_in = read_pos + rret;
-          if (rret != read_len) {
-            elprintf(EL_STATUS, "cso: read failed @ %08x", read_pos);
+      if (tmp_dst != cso->out_buff || block != cso->block_in_buff)
+      {
+        if (!cso_ra_get(cso, block, tmp_dst)) {
+          cso->block_in_buff = -1;
+          if (cso_read_block(cso, stream->file, &cso->fpos_in,
+                cso->in_buff, block, tmp_dst) != 0)
             break;
-          }
-          cso->block_in_buff = block;
-        }
-        rret = uncompress_buf(tmp_dst, 2048, cso->in_buff, read_len);
-        if (rret != 0) {
-          elprintf(EL_STATUS, "cso: uncompress failed @ %08x with %i", read_pos, rret);
-          break;
         }
+        if (tmp_dst == cso->out_buff)
+          cso->block_in_buff = block;
       }
 
       rret = 2048;
@@ -345,8 +814,35 @@ size_t pm_read(void *ptr, size_t bytes, pm_file *stream)
       cso->fpos_out += rret;
       bytes -= rret;
       block++;
-      index = index_end;
-      index_end = cso->index[block+1];
+    }
+    cso_ra_hint(cso, cso->fpos_out >> 11);
+  }
+  else if (stream->type == PMT_PDZ)
+  {
+    pdz_struct *pdz = stream->param;
+    unsigned char *out = ptr, *hunk;
+    unsigned int out_offs, rret;
+
+    ret = 0;
+    if (pdz->fpos_out >= pdz->total_bytes)
+      return 0;
+    if (bytes > pdz->total_bytes - pdz->fpos_out)
+      bytes = pdz->total_bytes - pdz->fpos_out;
+
+    while (bytes != 0)
+    {
+      hunk = pdz_get_hunk(pdz, stream->file, pdz->fpos_out / pdz->hunk_bytes);
+      if (hunk == NULL)
+        break;
+
+      out_offs = pdz->fpos_out % pdz->hunk_bytes;
+      rret = pdz->hunk_bytes - out_offs;
+      if (bytes < rret) rret = bytes;
+      memcpy(out, hunk + out_offs, rret);
+      ret += rret;
+      out += rret;
+      pdz->fpos_out += rret;
+      bytes -= rret;
     }
   }
   else
@@ -380,6 +876,14 @@ int pm_seek(pm_file *stream, long offset, int whence)
         return (z->pos = pos);
       return -1;
     }
+#ifdef USE_THREADS
+    if (z->data != NULL) {
+      // reads will wait for the data as needed
+      if (pos > stream->size)
+        pos = stream->size;
+      return (z->pos = pos);
+    }
+#endif
     offset = pos - z->pos;
     if (pos < z->pos) {
       // full decompress from the start
@@ -413,8 +917,20 @@ int pm_seek(pm_file *stream, long offset, int whence)
       case SEEK_SET: cso->fpos_out  = offset; break;
       case SEEK_END: cso->fpos_out  = cso->header.total_bytes - offset; break;
     }
+    cso_ra_hint(cso, cso->fpos_out >> 11);
     return cso->fpos_out;
   }
+  else if (stream->type == PMT_PDZ)
+  {
+    pdz_struct *pdz = stream->param;
+    switch (whence)
+    {
+      case SEEK_CUR: pdz->fpos_out += offset; break;
+      case SEEK_SET: pdz->fpos_out  = offset; break;
+      case SEEK_END: pdz->fpos_out  = pdz->total_bytes - offset; break;
+    }
+    return pdz->fpos_out;
+  }
   else
     return -1;
 }
@@ -432,14 +948,33 @@ int pm_close(pm_file *fp)
   else if (fp->type == PMT_ZIP)
   {
     struct zip_file *z = fp->file;
+#ifdef USE_THREADS
+    if (z->data != NULL) {
+      // pm_file is a part of zip_file
+      zip_unpark();
+      if (!z->reopened)
+        zip_parked = z;
+      else
+        zip_release(z);
+      return 0;
+    }
+#endif
     inflateEnd(&z->stream);
     closezip(z->zip);
   }
   else if (fp->type == PMT_CSO)
   {
+    cso_ra_stop(fp->param);
     free(fp->param);
     fclose(fp->file);
   }
+  else if (fp->type == PMT_PDZ)
+  {
+    pdz_struct *pdz = fp->param;
+    free(pdz->in_buff);
+    free(pdz);
+    fclose(fp->file);
+  }
   else
     ret = EOF;
 
@@ -529,6 +1064,122 @@ static unsigned char *PicoCartAlloc(int filesize, int is_sms)
   return rom;
 }
 
+static int rom_has_boot(const unsigned char *rom, int size, int swapped)
+{
+  int i, x = swapped ? 1 : 0;
+  if (size != 0x20000)
+    return 0;
+  for (i = 0; i < 4; i++)
+    if (rom[(0x124 + i) ^ x] != "BOOT"[i])
+      break;
+  if (i == 4)
+    return 1;
+  for (i = 0; i < 4; i++)
+    if (rom[(0x128 + i) ^ x] != "BOOT"[i])
+      return 0;
+  return 1;
+}
+
+#ifdef USE_ROM_MMAP
+// Replace the start of the (anonymous) ROM area with a private file mapping.
+// Untouched pages stay shared with the page cache (and other instances),
+// patches and such only get copies of the pages they write to.
+static int rom_map_fd(unsigned char *rom, int fd, int size)
+{
+  long pgmask = sysconf(_SC_PAGESIZE) - 1;
+  size_t len = (size + pgmask) & ~pgmask;
+  void *ret;
+
+  ret = mmap(rom, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+  if (ret == MAP_FAILED) {
+    elprintf(EL_STATUS, "rom mmap failed: %d", errno);
+    // the old mapping may be gone, don't leave a hole
+    mmap(rom, len, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    return -1;
+  }
+
+  rom_file_mapped = 1;
+  return 0;
+}
+
+static int rom_cache_path(char *path, size_t path_size, pm_file *f)
+{
+  struct stat st;
+
+  if (PicoCartCacheDir == NULL || fstat(fileno(f->file), &st) != 0)
+    return -1;
+
+  // enough to notice a changed file, no need to read it all for a hash
+  snprintf(path, path_size, "%s/%08lx%08lx%08lx%08lx.rom", PicoCartCacheDir,
+    (unsigned long)st.st_dev, (unsigned long)st.st_ino,
+    (unsigned long)st.st_mtime, (unsigned long)st.st_size);
+  return 0;
+}
+
+// map a ready to use ROM image, returns 0 if done
+static int rom_mmap_load(pm_file *f, unsigned char *rom, int *psize, int is_sms)
+{
+  char path[512];
+  struct stat st;
+  int fd, ret;
+
+  if (is_sms) {
+    // not byteswapped, so the file itself is usable unless it has a header
+    if (*psize >= 0x4200 && (*psize & 0x3fff) == 0x200)
+      return -1;
+    return rom_map_fd(rom, fileno(f->file), *psize);
+  }
+
+  if (rom_cache_path(path, sizeof(path), f) != 0)
+    return -1;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return -1;
+
+  ret = -1;
+  if (fstat(fd, &st) == 0 && st.st_size > 0 && st.st_size <= *psize) {
+    ret = rom_map_fd(rom, fd, st.st_size);
+    if (ret == 0) {
+      elprintf(EL_STATUS, "mapped cached ROM %s", path);
+      *psize = st.st_size;
+    }
+  }
+  close(fd);
+  return ret;
+}
+
+// write out the converted image for the next time, and share it right away
+static void rom_cache_store(pm_file *f, unsigned char *rom, int size)
+{
+  char path[512], tmp_path[512 + 16];
+  int fd, ret;
+
+  if (rom_cache_path(path, sizeof(path), f) != 0)
+    return;
+
+  // other instances may be doing the same, so rename into place
+  snprintf(tmp_path, sizeof(tmp_path), "%s.%d", path, (int)getpid());
+  fd = open(tmp_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    elprintf(EL_STATUS, "can't create %s", tmp_path);
+    return;
+  }
+
+  ret = write(fd, rom, size);
+  if (ret != size || rename(tmp_path, path) != 0) {
+    elprintf(EL_STATUS, "failed to write %s", path);
+    close(fd);
+    unlink(tmp_path);
+    return;
+  }
+
+  rom_map_fd(rom, fd, size);
+  close(fd);
+}
+#endif
+
 int PicoCartLoad(pm_file *f,unsigned char **prom,unsigned int *psize,int is_sms)
 {
   unsigned char *rom;
@@ -547,6 +1198,16 @@ int PicoCartLoad(pm_file *f,unsigned char **prom,unsigned int *psize,int is_sms)
     elprintf(EL_STATUS, "out of memory (wanted %i)", size);
     return 2;
   }
+  rom_file_mapped = 0;
+
+#ifdef USE_ROM_MMAP
+  if (f->type == PMT_UNCOMPRESSED && rom_mmap_load(f, rom, &size, is_sms) == 0)
+  {
+    if (!is_sms && !(PicoIn.AHW & PAHW_MCD) && rom_has_boot(rom, size, 1))
+      PicoIn.AHW |= PAHW_MCD;
+    goto loaded;
+  }
+#endif
 
   if (PicoCartLoadProgressCB != NULL)
   {
@@ -576,8 +1237,7 @@ int PicoCartLoad(pm_file *f,unsigned char **prom,unsigned int *psize,int is_sms)
   if (!is_sms)
   {
     // maybe we are loading MegaCD BIOS?
-    if (!(PicoIn.AHW & PAHW_MCD) && size == 0x20000 && (!strncmp((char *)rom+0x124, "BOOT", 4) ||
-         !strncmp((char *)rom+0x128, "BOOT", 4))) {
+    if (!(PicoIn.AHW & PAHW_MCD) && rom_has_boot(rom, size, 0)) {
       PicoIn.AHW |= PAHW_MCD;
     }
 
@@ -588,6 +1248,11 @@ int PicoCartLoad(pm_file *f,unsigned char **prom,unsigned int *psize,int is_sms)
       DecodeSmd(rom,size); size-=0x200; // Decode and byteswap SMD
     }
     else Byteswap(rom, rom, size); // Just byteswap
+
+#ifdef USE_ROM_MMAP
+    if (f->type == PMT_UNCOMPRESSED)
+      rom_cache_store(f, rom, size);
+#endif
   }
   else
   {
@@ -599,6 +1264,9 @@ int PicoCartLoad(pm_file *f,unsigned char **prom,unsigned int *psize,int is_sms)
     }
   }
 
+#ifdef USE_ROM_MMAP
+loaded:
+#endif
   if (prom)  *prom = rom;
   if (psize) *psize = size;
 
@@ -654,6 +1322,9 @@ int PicoCartInsert(unsigned char *rom, unsigned int romsize, const char *carthw_
   if (PicoCartMemSetup != NULL)
     PicoCartMemSetup();
 
+  SekRomChanged();
+  PicoIdleStatsReset();
+
   if (PicoIn.AHW & PAHW_SMS)
     PicoPowerMS();
   else
@@ -665,7 +1336,24 @@ int PicoCartInsert(unsigned char *rom, unsigned int romsize, const char *carthw_
 
 int PicoCartResize(int newsize)
 {
-  void *tmp = plat_mremap(Pico.rom, rom_alloc_size, newsize);
+  void *tmp;
+
+  if (rom_file_mapped) {
+    // can't mremap across the file/anon mappings, take a private copy
+    int keep = rom_alloc_size < newsize ? rom_alloc_size : newsize;
+    void *save = malloc(keep);
+    if (save == NULL)
+      return -1;
+    memcpy(save, Pico.rom, keep);
+    plat_munmap(Pico.rom, rom_alloc_size);
+    tmp = plat_mmap(0x02000000, newsize, 0, 0);
+    if (tmp != NULL)
+      memcpy(tmp, save, keep);
+    free(save);
+    rom_file_mapped = 0;
+  }
+  else
+    tmp = plat_mremap(Pico.rom, rom_alloc_size, newsize);
   if (tmp == NULL)
     return -1;
 
@@ -681,26 +1369,40 @@ void PicoCartUnload(void)
     PicoCartUnloadHook = NULL;
   }
 
+  pcd_s68k_thread_stop();
+  ym2612_thread_stop();
+  PsndStemsStop();
+
   if (PicoIn.AHW & PAHW_32X)
     PicoUnload32x();
 
   if (Pico.rom != NULL) {
+    PicoIdleStatsPrint();
     SekFinishIdleDet();
     plat_munmap(Pico.rom, rom_alloc_size);
     Pico.rom = NULL;
+    rom_file_mapped = 0;
+    SekRomChanged();
   }
   PicoGameLoaded = 0;
 }
 
-static unsigned int rom_crc32(void)
+unsigned int rom_crc32(void)
 {
-  unsigned int crc;
+  unsigned char buf[0x1000];
+  unsigned int crc = 0;
+  int i, len;
   elprintf(EL_STATUS, "caclulating CRC32..");
 
   // have to unbyteswap for calculation..
-  Byteswap(Pico.rom, Pico.rom, Pico.romsize);
-  crc = crc32(0, Pico.rom, Pico.romsize);
-  Byteswap(Pico.rom, Pico.rom, Pico.romsize);
+  // (in chunks, so that shared ROM pages are not written to)
+  for (i = 0; i < Pico.romsize; i += len) {
+    len = Pico.romsize - i;
+    if (len > sizeof(buf))
+      len = sizeof(buf);
+    Byteswap(buf, Pico.rom + i, len);
+    crc = crc32(crc, buf, len);
+  }
   return crc;
 }
 
@@ -696,6 +696,7 @@ static void PicoWrite8_plk3b(u32 a, u32 d)
     memcpy(Pico.rom, Pico.rom + Pico.romsize, 0x8000);
   else
     memcpy(Pico.rom, Pico.rom + addr, 0x8000);
+  SekRomWritten(0, 0x8000);
 }
 
 static void carthw_prot_lk3_mem_setup(void)
@@ -190,7 +190,17 @@ static void cdd_change_track(int index, int lba)
 
   elprintf(EL_CD, "play #%d lba %d base %d", index, lba, base);
 
-  cdda_start_play(base, lba_offset, lb_len);
+  cdda_start_play(base, lba_offset, lb_len, i == 0);
+}
+
+/* CD-DA stream was not read for a while (sound off), catch up to the drive */
+void cdd_resync_audio(void)
+{
+  if (cdd.status == CD_PLAY && cdd.index > 0 && cdd.index < cdd.toc.last
+      && cdd.lba >= cdd.toc.tracks[cdd.index].start)
+  {
+    cdd_change_track(cdd.index, cdd.lba);
+  }
 }
 
 int cdd_context_save(uint8 *state)
@@ -285,6 +295,8 @@ int cdd_load(const char *filename, int type)
   char header[0x210];
   int ret;
 
+  pcd_s68k_wait();
+
   /* first unmount any loaded disc */
   cdd_unload();
 
@@ -435,10 +447,89 @@ int cdd_load(const char *filename, int type)
   return 0;
 }
 
+/* DATA track sector cache: consecutive sectors are fetched in chunks with a
+ * single seek+read each (read-ahead for sequential access), and a few chunks
+ * are kept around in LRU order for games going back and forth between files */
+#define CACHE_CHUNK_SECTORS 16
+#define CACHE_CHUNKS        4
+
+static struct
+{
+  int lba[CACHE_CHUNKS];   /* first sector in chunk, -1 if unused */
+  int count[CACHE_CHUNKS]; /* sectors in chunk */
+  unsigned int stamp[CACHE_CHUNKS];
+  unsigned int clock;
+  uint8 *data;             /* CACHE_CHUNKS * CACHE_CHUNK_SECTORS raw sectors */
+} cdd_cache;
+
+static void cdd_cache_reset(void)
+{
+  int i;
+
+  for (i = 0; i < CACHE_CHUNKS; i++)
+    cdd_cache.lba[i] = -1;
+  cdd_cache.clock = 0;
+}
+
+static void cdd_cache_free(void)
+{
+  cdd_cache_reset();
+  free(cdd_cache.data);
+  cdd_cache.data = NULL;
+}
+
+static uint8 *cdd_cache_get(int lba)
+{
+  int sector_size = cdd.sectorSize;
+  int i, n, lru = 0;
+  uint8 *chunk;
+
+  if (cdd_cache.data == NULL)
+  {
+    cdd_cache.data = malloc(CACHE_CHUNKS * CACHE_CHUNK_SECTORS * 2352);
+    if (cdd_cache.data == NULL)
+      return NULL;
+    cdd_cache_reset();
+  }
+
+  for (i = 0; i < CACHE_CHUNKS; i++)
+  {
+    if (cdd_cache.lba[i] >= 0 && (unsigned)(lba - cdd_cache.lba[i]) < cdd_cache.count[i])
+      goto hit;
+    if (cdd_cache.lba[i] < 0 || cdd_cache.stamp[i] < cdd_cache.stamp[lru])
+      lru = i;
+  }
+
+  /* miss - refill least recently used chunk, starting at requested sector */
+  i = lru;
+  n = cdd.toc.tracks[0].end - lba;
+  if (n > CACHE_CHUNK_SECTORS)
+    n = CACHE_CHUNK_SECTORS;
+
+  chunk = cdd_cache.data + i * CACHE_CHUNK_SECTORS * 2352;
+  pm_seek(cdd.toc.tracks[0].fd, lba * sector_size, SEEK_SET);
+  n = pm_read(chunk, n * sector_size, cdd.toc.tracks[0].fd) / sector_size;
+  if (n <= 0)
+  {
+    cdd_cache.lba[i] = -1;
+    return NULL;
+  }
+  cdd_cache.lba[i] = lba;
+  cdd_cache.count[i] = n;
+
+hit:
+  cdd_cache.stamp[i] = ++cdd_cache.clock;
+  return cdd_cache.data + i * CACHE_CHUNK_SECTORS * 2352
+    + (lba - cdd_cache.lba[i]) * sector_size;
+}
+
 int cdd_unload(void)
 {
   int was_loaded = cdd.loaded;
 
+  pcd_s68k_wait();
+  cdda_thread_stop();
+
   if (cdd.loaded)
   {
     int i;
@@ -484,6 +575,9 @@ int cdd_unload(void)
       cdd.status = NO_DISC;
   }
 
+  /* drop cached sectors of the old image */
+  cdd_cache_free();
+
   /* reset TOC */
   memset(&cdd.toc, 0x00, sizeof(cdd.toc));
     
@@ -498,12 +592,29 @@ void cdd_read_data(uint8 *dst)
   /* only read DATA track sectors */
   if ((cdd.lba >= 0) && (cdd.lba < cdd.toc.tracks[0].end))
   {
+    uint8 *sector = cdd_cache_get(cdd.lba);
+
+    if (sector != NULL)
+    {
+      /* BIN format ? skip 16-byte header */
+      if (cdd.sectorSize == 2352)
+        sector += 16;
+
+      /* sector data (Mode 1 = 2048 bytes) */
+      memcpy(dst, sector, 2048);
+      return;
+    }
+
     /* BIN format ? */
     if (cdd.sectorSize == 2352)
     {
       /* skip 16-byte header */
       pm_seek(cdd.toc.tracks[0].fd, cdd.lba * 2352 + 16, SEEK_SET);
     }
+    else
+    {
+      pm_seek(cdd.toc.tracks[0].fd, cdd.lba * 2048, SEEK_SET);
+    }
 
     /* read sector data (Mode 1 = 2048 bytes) */
     pm_read(dst, 2048, cdd.toc.tracks[0].fd);
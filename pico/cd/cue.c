@@ -9,6 +9,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "cue.h"
+#include "pdz.h"
 
 #include "../pico_int.h"
 // #define elprintf(w,f,...) printf(f "\n",##__VA_ARGS__);
@@ -104,6 +105,53 @@ static int file_openable(const char *fname)
 
 #define BEGINS(buff,str) (strncmp(buff,str,sizeof(str)-1) == 0)
 
+/* .pdz images carry their own track list, present it as a single file cue */
+static cue_data_t *pdz_parse(const char *fname)
+{
+	pdz_track tracks[PDZ_MAX_TRACKS];
+	cue_data_t *data = NULL;
+	pdz_header header;
+	int i, count;
+	FILE *f;
+
+	f = fopen(fname, "rb");
+	if (f == NULL)
+		return NULL;
+
+	if (fread(&header, 1, sizeof(header), f) != sizeof(header))
+		goto out;
+	count = header.track_count;
+	if (strncmp(header.magic, PDZ_MAGIC, 4) != 0 || count < 1 || count > PDZ_MAX_TRACKS) {
+		elprintf(EL_STATUS, "pdz: bad header: \"%s\"", fname);
+		goto out;
+	}
+	if (fread(tracks, sizeof(tracks[0]), count, f) != count)
+		goto out;
+
+	// one extra entry past the end, load_cd_image() looks at track 2
+	data = calloc(1, sizeof(*data) + (count + 2) * sizeof(cue_track));
+	if (data == NULL)
+		goto out;
+	data->tracks[1].fname = strdup(fname);
+	if (data->tracks[1].fname == NULL) {
+		free(data);
+		data = NULL;
+		goto out;
+	}
+
+	for (i = 1; i <= count; i++) {
+		data->tracks[i].type = CT_BIN;
+		data->tracks[i].pregap = tracks[i-1].pregap;
+		data->tracks[i].sector_offset = tracks[i-1].sector_offset;
+	}
+	data->tracks[count+1].sector_offset = header.sectors;
+	data->track_count = count;
+
+out:
+	fclose(f);
+	return data;
+}
+
 /* note: tracks[0] is not used */
 cue_data_t *cue_parse(const char *fname)
 {
@@ -119,6 +167,8 @@ cue_data_t *cue_parse(const char *fname)
 		return NULL;
 
 	ret = get_ext(fname, ext, cue_base, sizeof(cue_base));
+	if (strcasecmp(ext, "pdz") == 0)
+		return pdz_parse(fname);
 	if (strcasecmp(ext, "cue") == 0) {
 		f = fopen(fname, "r");
 	}
@@ -7,6 +7,7 @@
  */
 
 #include "../pico_int.h"
+#include "../pico_thread.h"
 #include "../sound/ym2612.h"
 
 extern unsigned char formatted_bram[4*0x10];
@@ -23,6 +24,7 @@ PICO_INTERNAL void PicoInitMCD(void)
 
 PICO_INTERNAL void PicoExitMCD(void)
 {
+  pcd_s68k_thread_stop();
 }
 
 PICO_INTERNAL void PicoPowerMCD(void)
@@ -102,9 +104,9 @@ static void SekRunM68kOnce(void)
     CycloneRun(&PicoCpuCM68k);
     Pico.t.m68c_cnt -= PicoCpuCM68k.cycles;
 #elif defined(EMU_M68K)
-    Pico.t.m68c_cnt += m68k_execute(cyc_do) - cyc_do;
+    Pico.t.m68c_cnt += m68k_execute(&PicoCpuMM68k, cyc_do) - cyc_do;
 #elif defined(EMU_F68K)
-    Pico.t.m68c_cnt += fm68k_emulate(&PicoCpuFM68k, cyc_do, 0) - cyc_do;
+    Pico.t.m68c_cnt += SekEmulateF68k(&PicoCpuFM68k, cyc_do) - cyc_do;
 #endif
   }
 
@@ -131,11 +133,9 @@ static void SekRunS68k(unsigned int to)
   CycloneRun(&PicoCpuCS68k);
   SekCycleCntS68k -= PicoCpuCS68k.cycles;
 #elif defined(EMU_M68K)
-  m68k_set_context(&PicoCpuMS68k);
-  SekCycleCntS68k += m68k_execute(cyc_do) - cyc_do;
-  m68k_set_context(&PicoCpuMM68k);
+  SekCycleCntS68k += m68k_execute(&PicoCpuMS68k, cyc_do) - cyc_do;
 #elif defined(EMU_F68K)
-  SekCycleCntS68k += fm68k_emulate(&PicoCpuFS68k, cyc_do, 0) - cyc_do;
+  SekCycleCntS68k += SekEmulateF68k(&PicoCpuFS68k, cyc_do) - cyc_do;
 #endif
 }
 
@@ -306,6 +306,116 @@ int pcd_sync_s68k(unsigned int m68k_target, int m68k_poll_sync)
   #undef now
 }
 
+#ifdef USE_THREADS
+/*
+ * The sub cpu catch-up at the end of a frame may run on another thread,
+ * overlapped with whatever the frontend does between frames. Any entry
+ * into the core waits for it first (pcd_s68k_wait), so nothing observes
+ * the machine halfway and the result is the same as the serial run.
+ * Within a frame both cpus share maps, word RAM and drc caches, so that
+ * part stays on one thread.
+ * Only the remainder after the last in-frame sync (roughly the part after
+ * VINT) ever overlaps. Running the two cpus concurrently with the Gate
+ * Array syncing them on register access (dmna/ret in 2M mode) would cover
+ * the whole frame, but is not built.
+ */
+static struct {
+  pico_thread_t thread;
+  pico_mutex_t mutex;
+  pico_cond_t cond;
+  unsigned int target;
+  int busy;
+  int quit;
+  int started;
+} s68k_thr;
+
+static void *pcd_s68k_thread(void *arg)
+{
+  pico_mutex_lock(&s68k_thr.mutex);
+  while (!s68k_thr.quit) {
+    if (!s68k_thr.busy) {
+      pico_cond_wait(&s68k_thr.cond, &s68k_thr.mutex);
+      continue;
+    }
+    pico_mutex_unlock(&s68k_thr.mutex);
+
+    pcd_sync_s68k(s68k_thr.target, 0);
+
+    pico_mutex_lock(&s68k_thr.mutex);
+    s68k_thr.busy = 0;
+    pico_cond_broadcast(&s68k_thr.cond);
+  }
+  pico_mutex_unlock(&s68k_thr.mutex);
+
+  return NULL;
+}
+
+static int pcd_s68k_thread_start(void)
+{
+  if (s68k_thr.started)
+    return 0;
+
+  pico_mutex_init(&s68k_thr.mutex);
+  pico_cond_init(&s68k_thr.cond);
+  s68k_thr.busy = s68k_thr.quit = 0;
+  if (pico_thread_create(&s68k_thr.thread, pcd_s68k_thread, NULL) != 0) {
+    elprintf(EL_STATUS, "cd: can't create s68k thread, running serially");
+    pico_cond_destroy(&s68k_thr.cond);
+    pico_mutex_destroy(&s68k_thr.mutex);
+    return -1;
+  }
+  s68k_thr.started = 1;
+  return 0;
+}
+
+void pcd_s68k_wait(void)
+{
+  if (!s68k_thr.started)
+    return;
+
+  pico_mutex_lock(&s68k_thr.mutex);
+  while (s68k_thr.busy)
+    pico_cond_wait(&s68k_thr.cond, &s68k_thr.mutex);
+  pico_mutex_unlock(&s68k_thr.mutex);
+}
+
+void pcd_s68k_thread_stop(void)
+{
+  if (!s68k_thr.started)
+    return;
+
+  pcd_s68k_wait();
+  pico_mutex_lock(&s68k_thr.mutex);
+  s68k_thr.quit = 1;
+  pico_cond_broadcast(&s68k_thr.cond);
+  pico_mutex_unlock(&s68k_thr.mutex);
+  pico_thread_join(s68k_thr.thread);
+
+  pico_cond_destroy(&s68k_thr.cond);
+  pico_mutex_destroy(&s68k_thr.mutex);
+  s68k_thr.started = 0;
+}
+#endif
+
+// end of frame sync, handed to the s68k thread if enabled
+void pcd_sync_s68k_frame_end(unsigned int m68k_target)
+{
+#ifdef USE_THREADS
+  // 32X+CD still has the sh2s to run after this
+  if ((PicoIn.opt & POPT_EN_MCD_THREAD) && !(PicoIn.AHW & PAHW_32X)
+      && pcd_s68k_thread_start() == 0)
+  {
+    pico_mutex_lock(&s68k_thr.mutex);
+    s68k_thr.target = m68k_target;
+    s68k_thr.busy = 1;
+    pico_cond_broadcast(&s68k_thr.cond);
+    pico_mutex_unlock(&s68k_thr.mutex);
+    return;
+  }
+#endif
+  pcd_sync_s68k(m68k_target, 0);
+}
+
 #define pcd_run_cpus_normal pcd_run_cpus
 //#define pcd_run_cpus_lockstep pcd_run_cpus
 
@@ -321,6 +431,7 @@ void pcd_run_cpus_normal(int m68k_cycles)
     if (s68k_left <= 0) {
       elprintf(EL_CDPOLL, "m68k poll [%02x] x%d @%06x",
         Pico_mcd->m.m68k_poll_a, Pico_mcd->m.m68k_poll_cnt, SekPc);
+      PicoIdleHit(IDLE_M68K, SekPc);
       Pico.t.m68c_cnt = Pico.t.m68c_aim;
       return;
     }
@@ -255,6 +255,7 @@ u32 s68k_poll_detect(u32 a, u32 d)
         SekSetStopS68k(1);
         elprintf(EL_CDPOLL, "s68k poll detected @%06x, a=%02x",
           SekPcS68k, a);
+        PicoIdleHit(IDLE_S68K, SekPcS68k);
       }
     }
   }
@@ -1201,47 +1202,15 @@ PICO_INTERNAL void PicoMemSetupCD(void)
 
 
 #ifdef EMU_M68K
-u32  m68k_read8(u32 a);
-u32  m68k_read16(u32 a);
-u32  m68k_read32(u32 a);
-void m68k_write8(u32 a, u8 d);
-void m68k_write16(u32 a, u16 d);
-void m68k_write32(u32 a, u32 d);
-
-static unsigned int PicoReadCD8w (unsigned int a) {
-	return m68ki_cpu_p == &PicoCpuMS68k ? s68k_read8(a) : m68k_read8(a);
-}
-static unsigned int PicoReadCD16w(unsigned int a) {
-	return m68ki_cpu_p == &PicoCpuMS68k ? s68k_read16(a) : m68k_read16(a);
-}
-static unsigned int PicoReadCD32w(unsigned int a) {
-	return m68ki_cpu_p == &PicoCpuMS68k ? s68k_read32(a) : m68k_read32(a);
-}
-static void PicoWriteCD8w (unsigned int a, unsigned char d) {
-	if (m68ki_cpu_p == &PicoCpuMS68k) s68k_write8(a, d); else m68k_write8(a, d);
-}
-static void PicoWriteCD16w(unsigned int a, unsigned short d) {
-	if (m68ki_cpu_p == &PicoCpuMS68k) s68k_write16(a, d); else m68k_write16(a, d);
-}
-static void PicoWriteCD32w(unsigned int a, unsigned int d) {
-	if (m68ki_cpu_p == &PicoCpuMS68k) s68k_write32(a, d); else m68k_write32(a, d);
-}
-
-extern unsigned int (*pm68k_read_memory_8) (unsigned int address);
-extern unsigned int (*pm68k_read_memory_16)(unsigned int address);
-extern unsigned int (*pm68k_read_memory_32)(unsigned int address);
-extern void (*pm68k_write_memory_8) (unsigned int address, unsigned char  value);
-extern void (*pm68k_write_memory_16)(unsigned int address, unsigned short value);
-extern void (*pm68k_write_memory_32)(unsigned int address, unsigned int   value);
-
+// main 68k handlers are set up by PicoMemSetup()
 static void m68k_mem_setup_cd(void)
 {
-  pm68k_read_memory_8  = PicoReadCD8w;
-  pm68k_read_memory_16 = PicoReadCD16w;
-  pm68k_read_memory_32 = PicoReadCD32w;
-  pm68k_write_memory_8  = PicoWriteCD8w;
-  pm68k_write_memory_16 = PicoWriteCD16w;
-  pm68k_write_memory_32 = PicoWriteCD32w;
+  PicoCpuMS68k.read_memory_8  = s68k_read8;
+  PicoCpuMS68k.read_memory_16 = s68k_read16;
+  PicoCpuMS68k.read_memory_32 = s68k_read32;
+  PicoCpuMS68k.write_memory_8  = s68k_write8;
+  PicoCpuMS68k.write_memory_16 = s68k_write16;
+  PicoCpuMS68k.write_memory_32 = s68k_write32;
 }
 #endif // EMU_M68K
 
@@ -7,9 +7,17 @@
  */
 
 #include "../pico_int.h"
+#include "../sound/resampler.h"
 
 #define PCM_STEP_SHIFT 11
 
+static struct resampler pcm_rs;
+
+// channels apart, while capturing stems
+static int (*pcm_stem_mix)[PCM_MIXBUF_LEN * 2];
+static struct resampler *pcm_stem_rs;
+static int pcm_stem_dirty;
+
 void pcd_pcm_write(unsigned int a, unsigned int d)
 {
   unsigned int cycles = SekCyclesDoneS68k();
@@ -49,21 +57,47 @@ unsigned int pcd_pcm_read(unsigned int a)
   return d & 0xff;
 }
 
+// steps from addr before a loop marker is reached (0 if it's at addr),
+// at most 'max' and not past the end of pcm ram
+static int pcm_run_len(unsigned int addr, unsigned int inc, int max)
+{
+  const unsigned char *ram = Pico_mcd->pcm_ram;
+  unsigned int first = addr >> PCM_STEP_SHIFT, last;
+  const unsigned char *p;
+
+  if (ram[first] == 0xff)
+    return 0;
+  if (inc == 0)
+    return max;
+
+  if (addr + (max - 1) * inc > 0x7FFFFFF)
+    max = (0x8000000 - addr + inc - 1) / inc;
+  last = (addr + (max - 1) * inc) >> PCM_STEP_SHIFT;
+
+  // markers in skipped over bytes end the run early, that's harmless
+  p = memchr(ram + first + 1, 0xff, last - first);
+  if (p == NULL)
+    return max;
+  return (((p - ram) << PCM_STEP_SHIFT) - addr + inc - 1) / inc;
+}
+
 void pcd_pcm_sync(unsigned int to)
 {
   unsigned int cycles = Pico_mcd->pcm.update_cycles;
   int mul_l, mul_r, inc, smp;
   struct pcm_chan *ch;
   unsigned int addr;
-  int c, s, steps;
-  int enabled;
-  int *out;
+  int c, s, n, steps;
+  int enabled, mute;
+  int *out, *o;
 
   if ((int)(to - cycles) < 384)
     return;
 
   steps = (to - cycles) / 384;
-  if (Pico_mcd->pcm_mixpos + steps > PCM_MIXBUF_LEN)
+  // when nothing is heard, only the channel addresses are kept going
+  mute = !PicoIn.sndOut || !(PicoIn.opt & POPT_EN_MCD_PCM);
+  if (!mute && Pico_mcd->pcm_mixpos + steps > PCM_MIXBUF_LEN)
     // shouldn't happen, but occasionally does
     steps = PCM_MIXBUF_LEN - Pico_mcd->pcm_mixpos;
 
@@ -75,7 +109,8 @@ void pcd_pcm_sync(unsigned int to)
     goto end;
 
   out = Pico_mcd->pcm_mixbuf + Pico_mcd->pcm_mixpos * 2;
-  Pico_mcd->pcm_mixbuf_dirty = 1;
+  if (!mute)
+    Pico_mcd->pcm_mixbuf_dirty = 1;
   Pico_mcd->pcm_regs_dirty = 0;
 
   for (c = 0; c < 8; c++)
@@ -92,6 +127,34 @@ void pcd_pcm_sync(unsigned int to)
     mul_l = ((int)ch->regs[0] * (ch->regs[1] & 0xf)) >> (5+1); 
     mul_r = ((int)ch->regs[0] * (ch->regs[1] >>  4)) >> (5+1);
 
+    if (mute || (mul_l == 0 && mul_r == 0))
+    {
+      // muted, only the address needs to move, from loop marker to marker
+      for (s = 0; s < steps; s += n)
+      {
+        n = pcm_run_len(addr, inc, steps - s);
+        if (n == 0)
+        {
+          addr = *(unsigned short *)&ch->regs[4]; // loop_addr
+          smp = Pico_mcd->pcm_ram[addr];
+          addr <<= PCM_STEP_SHIFT;
+          if (smp == 0xff)
+            break;
+          continue;
+        }
+        addr = (addr + n * inc) & 0x7FFFFFF;
+      }
+      ch->addr = addr;
+      continue;
+    }
+
+    // with stems, the channel goes to its own buffer and is added from there
+    o = out;
+    if (pcm_stem_mix != NULL) {
+      o = pcm_stem_mix[c] + Pico_mcd->pcm_mixpos * 2;
+      pcm_stem_dirty = 1;
+    }
+
     for (s = 0; s < steps; s++, addr = (addr + inc) & 0x7FFFFFF)
     {
       smp = Pico_mcd->pcm_ram[addr >> PCM_STEP_SHIFT];
@@ -109,51 +172,74 @@ void pcd_pcm_sync(unsigned int to)
       if (smp & 0x80)
         smp = -(smp & 0x7f);
 
-      out[s*2  ] += smp * mul_l; // max 128 * 119 = 15232
-      out[s*2+1] += smp * mul_r;
+      o[s*2  ] += smp * mul_l; // max 128 * 119 = 15232
+      o[s*2+1] += smp * mul_r;
     }
     ch->addr = addr;
+
+    if (o != out)
+      for (s = 0; s < steps * 2; s++)
+        out[s] += o[s];
   }
 
 end:
   Pico_mcd->pcm.update_cycles = cycles + steps * 384;
-  Pico_mcd->pcm_mixpos += steps;
+  if (!mute)
+    Pico_mcd->pcm_mixpos += steps;
 }
 
-void pcd_pcm_update(int *buf32, int length, int stereo)
+// stem capture of PCM channels starting/ending, they are kept apart at
+// the chip rate and resampled each on its own
+void pcd_pcm_stems(int on)
 {
-  int step, *pcm;
-  int p = 0;
+  free(pcm_stem_mix);
+  free(pcm_stem_rs);
+  pcm_stem_mix = NULL;
+  pcm_stem_rs = NULL;
+  pcm_stem_dirty = 0;
+  if (!on)
+    return;
 
-  pcd_pcm_sync(SekCyclesDoneS68k());
+  pcm_stem_mix = calloc(8, sizeof(pcm_stem_mix[0]));
+  pcm_stem_rs = calloc(8, sizeof(pcm_stem_rs[0]));
+  if (pcm_stem_mix == NULL || pcm_stem_rs == NULL)
+    pcd_pcm_stems(0);
+}
 
-  if (!Pico_mcd->pcm_mixbuf_dirty || !(PicoIn.opt & POPT_EN_MCD_PCM))
-    goto out;
+static void pcm_stems_update(int length, int stereo, int mix)
+{
+  int c, *dest;
+
+  for (c = 0; c < 8; c++) {
+    dest = psnd_stems.buf[PSND_STEM_PCM1 + c];
+    if (!mix)
+      resampler_reset(&pcm_stem_rs[c]);
+    else if (dest != NULL)
+      resampler_run(&pcm_stem_rs[c], dest + psnd_stems.pos, length, stereo,
+        pcm_stem_mix[c], Pico_mcd->pcm_mixpos);
+    if (pcm_stem_dirty)
+      memset(pcm_stem_mix[c], 0,
+        Pico_mcd->pcm_mixpos * 2 * sizeof(pcm_stem_mix[c][0]));
+  }
+  pcm_stem_dirty = 0;
+}
 
-  step = (Pico_mcd->pcm_mixpos << 16) / length;
-  pcm = Pico_mcd->pcm_mixbuf;
+void pcd_pcm_update(int *buf32, int length, int stereo)
+{
+  pcd_pcm_sync(SekCyclesDoneS68k());
 
-  if (stereo) {
-    while (length-- > 0) {
-      *buf32++ += pcm[0];
-      *buf32++ += pcm[1];
+  if (pcm_stem_mix != NULL)
+    pcm_stems_update(length, stereo,
+      Pico_mcd->pcm_mixbuf_dirty && (PicoIn.opt & POPT_EN_MCD_PCM));
 
-      p += step;
-      pcm += (p >> 16) * 2;
-      p &= 0xffff;
-    }
-  }
-  else {
-    while (length-- > 0) {
-      // mostly unused
-      *buf32++ += pcm[0];
-
-      p += step;
-      pcm += (p >> 16) * 2;
-      p &= 0xffff;
-    }
+  if (!Pico_mcd->pcm_mixbuf_dirty || !(PicoIn.opt & POPT_EN_MCD_PCM)) {
+    resampler_reset(&pcm_rs);
+    goto out;
   }
 
+  resampler_run(&pcm_rs, buf32, length, stereo,
+    Pico_mcd->pcm_mixbuf, Pico_mcd->pcm_mixpos);
+
   memset(Pico_mcd->pcm_mixbuf, 0,
     Pico_mcd->pcm_mixpos * 2 * sizeof(Pico_mcd->pcm_mixbuf[0]));
 
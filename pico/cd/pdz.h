@@ -0,0 +1,54 @@
+/*
+ * PicoDrive
+ * hunk compressed CD image (.pdz) layout
+ *
+ * This work is licensed under the terms of MAME license.
+ * See COPYING file in the top-level directory.
+ */
+
+#ifndef PDZ_H
+#define PDZ_H
+
+/*
+ * All values are little endian:
+ *   pdz_header
+ *   pdz_track[track_count]     track 1 is the data track
+ *   u32 index[hunk_count + 1]  file offset of each hunk | PDZ_HUNK_* flags,
+ *                              the last entry is where the last hunk ends
+ *   hunk data
+ *
+ * The image is the whole disc as 2352 byte raw sectors (like a single .bin),
+ * split in hunks of hunk_sectors sectors (the last one may be shorter).
+ * Each hunk is deflated without zlib header, or stored if that doesn't help,
+ * so any sector can be located through the index without reading others.
+ */
+
+#define PDZ_MAGIC        "PDZ\x1a"
+#define PDZ_VERSION      1
+#define PDZ_SECTOR_SIZE  2352
+#define PDZ_MAX_TRACKS   99
+
+#define PDZ_HUNK_STORED  0x80000000 // not compressed
+#define PDZ_HUNK_DELTA   0x40000000 // CDDA, 16bit samples as per channel deltas
+#define PDZ_HUNK_OFFS    0x3fffffff
+
+#define PDZ_TRACK_DATA   0
+#define PDZ_TRACK_AUDIO  1
+
+typedef struct
+{
+  char         magic[4];
+  unsigned int version;
+  unsigned int hunk_sectors;
+  unsigned int sectors;       // total sectors in image
+  unsigned int track_count;
+} pdz_header;
+
+typedef struct
+{
+  unsigned int type;          // PDZ_TRACK_*
+  unsigned int pregap;        // sectors of silence not stored in image
+  unsigned int sector_offset; // start of track (index 01) in image
+} pdz_track;
+
+#endif // PDZ_H
@@ -0,0 +1,467 @@
+/*
+ * PicoDrive
+ * lockstep comparison of FAME against Musashi
+ *
+ * This work is licensed under the terms of MAME license.
+ * See COPYING file in the top-level directory.
+ *
+ * Built with cmp68k=1 (CMP_68K). FAME runs the machine as usual and every
+ * stretch of CMP68K_N instructions is run again by a private Musashi
+ * context, started from the same registers:
+ * - FAME's data accesses are logged, Musashi's reads are served from the
+ *   log and its writes are checked against it, so the hardware only ever
+ *   sees one cpu. Reads that are not in the log (instruction fetches) go
+ *   through FAME's fetch map, which never calls handlers,
+ * - at the end of the stretch registers, SR, cycles and both access
+ *   streams are compared, anything different is reported with the pcs
+ *   and opcodes of the stretch.
+ * Musashi is resynced from FAME at the start of every stretch, so each
+ * divergence is reported once and doesn't spoil what follows. FAME's
+ * direct RAM/ROM paths are switched off while stepping, they would bypass
+ * the log. Accesses are matched by instruction, address and size rather
+ * than by strict order, the cores don't push exception frames the same way.
+ * Since FAME is stepped one instruction at a time it notices irqs a bit
+ * earlier than in a normal build, so timing isn't exactly the same.
+ * Unlike cpu_cmp=1 this needs no second run and no trace file, but only
+ * the 68k cores can be compared like this: the SH2 drc reads memory
+ * directly, drc_cmp=1 has to be used for it.
+ */
+#include "pico_int.h"
+#include "memory.h"
+#include "../cpu/musashi/m68kcpu.h"
+
+#ifndef CMP68K_N
+#define CMP68K_N 1
+#endif
+#if CMP68K_N < 1 || CMP68K_N > 256
+#error CMP68K_N out of range
+#endif
+
+// movem.l of all regs does 16 accesses, an exception frame 5 more
+#define LOG_MAX (CMP68K_N * 24)
+#define BAD_MAX 8
+#define REPORTS_MAX 32
+
+struct access {
+  u32 a, d;
+  u8 size;
+  u8 write;
+  u8 done;
+  u8 insn;
+};
+
+static struct cmp_cpu {
+  M68K_CONTEXT *ctx;
+  m68ki_cpu_core mus;
+  // FAME's handlers, the logging ones call them
+  unsigned int (*read8) (unsigned int a);
+  unsigned int (*read16)(unsigned int a);
+  unsigned int (*read32)(unsigned int a);
+  void (*write8) (unsigned int a, unsigned char  d);
+  void (*write16)(unsigned int a, unsigned short d);
+  void (*write32)(unsigned int a, unsigned int   d);
+  struct access log[LOG_MAX];
+  int log_cnt, log_lost;
+  struct access bad[BAD_MAX]; // musashi's side of mismatched writes
+  int bad_cnt;
+  int insn;
+  u32 pc[CMP68K_N];
+  u8  irq[CMP68K_N][2];       // FAME's irq level before and after
+  int cyc[CMP68K_N][2];       // FAME, Musashi
+  u8  ext[CMP68K_N];          // cycles changed by a handler
+  // FAME is stepped with 1 cycle, this is what was taken off to get there
+  unsigned int *cnt, cnt_step;
+  int bias;
+} cmp_cpus[2];
+
+static const char *cmp_names[2] = { "m68k", "s68k" };
+static int cmp_reports;
+
+static void log_access(struct cmp_cpu *c, u32 a, u32 d, int size, int write)
+{
+  struct access *l;
+
+  if (c->log_cnt >= LOG_MAX) {
+    c->log_lost++;
+    return;
+  }
+  l = &c->log[c->log_cnt++];
+  l->a = a & 0xffffff;
+  l->d = d;
+  l->size = size;
+  l->write = write;
+  l->done = 0;
+  l->insn = c->insn;
+}
+
+// a handler may have burnt cycles or ended the run
+static void handler_done(struct cmp_cpu *c, int io_before)
+{
+  M68K_CONTEXT *ctx = c->ctx;
+
+  if (ctx->io_cycle_counter != io_before)
+    c->ext[c->insn] = 1;
+  if (*c->cnt != c->cnt_step) {
+    // SekEndRun() set an absolute count, rebias so that
+    // FAME still stops after this instruction
+    c->bias = ctx->io_cycle_counter - 1;
+    *c->cnt -= c->bias;
+    ctx->io_cycle_counter = 1;
+    c->cnt_step = *c->cnt;
+  }
+}
+
+#define MAKE_FAME_READ(n, size, mask) \
+static unsigned int fame_read##size##_##n(unsigned int a) \
+{ \
+  struct cmp_cpu *c = &cmp_cpus[n]; \
+  int io = c->ctx->io_cycle_counter; \
+  u32 d = c->read##size(a) & mask; \
+  handler_done(c, io); \
+  log_access(c, a, d, size, 0); \
+  return d; \
+}
+
+#define MAKE_FAME_WRITE(n, size, type) \
+static void fame_write##size##_##n(unsigned int a, type d) \
+{ \
+  struct cmp_cpu *c = &cmp_cpus[n]; \
+  int io = c->ctx->io_cycle_counter; \
+  log_access(c, a, d, size, 1); \
+  c->write##size(a, d); \
+  handler_done(c, io); \
+}
+
+#define MAKE_FAME_HANDLERS(n) \
+  MAKE_FAME_READ(n, 8, 0xff) \
+  MAKE_FAME_READ(n, 16, 0xffff) \
+  MAKE_FAME_READ(n, 32, 0xffffffff) \
+  MAKE_FAME_WRITE(n, 8, unsigned char) \
+  MAKE_FAME_WRITE(n, 16, unsigned short) \
+  MAKE_FAME_WRITE(n, 32, unsigned int)
+
+MAKE_FAME_HANDLERS(0)
+MAKE_FAME_HANDLERS(1)
+
+// what FAME would fetch from a
+static u32 fetch16(M68K_CONTEXT *ctx, u32 a)
+{
+  uptr base = ctx->Fetch[(a >> 16) & (M68K_FETCHBANK1 - 1)];
+  return *(u16 *)(base + (a & 0xfffffe));
+}
+
+static u32 replay_read(struct cmp_cpu *c, u32 a, int size)
+{
+  int i;
+
+  a &= 0xffffff;
+  for (i = 0; i < c->log_cnt; i++) {
+    struct access *l = &c->log[i];
+    if (!l->done && !l->write && l->insn == c->insn
+        && l->a == a && l->size == size) {
+      l->done = 1;
+      return l->d;
+    }
+  }
+
+  if (size == 8)
+    return fetch16(c->ctx, a) >> ((~a & 1) << 3) & 0xff;
+  if (size == 16)
+    return fetch16(c->ctx, a);
+  return (fetch16(c->ctx, a) << 16) | fetch16(c->ctx, a + 2);
+}
+
+static void replay_write(struct cmp_cpu *c, u32 a, u32 d, int size)
+{
+  int i;
+
+  a &= 0xffffff;
+  for (i = 0; i < c->log_cnt; i++) {
+    struct access *l = &c->log[i];
+    if (!l->done && l->write && l->insn == c->insn
+        && l->a == a && l->size == size) {
+      l->done = 1;
+      if (l->d == d)
+        return;
+      break;
+    }
+  }
+
+  if (c->bad_cnt < BAD_MAX) {
+    struct access *b = &c->bad[c->bad_cnt++];
+    b->a = a;
+    b->d = d;
+    b->size = size;
+    b->write = 1;
+    b->insn = c->insn;
+  }
+}
+
+#define MAKE_MUSASHI_HANDLERS(n) \
+static unsigned int mus_read8_##n(unsigned int a) \
+{ \
+  return replay_read(&cmp_cpus[n], a, 8); \
+} \
+static unsigned int mus_read16_##n(unsigned int a) \
+{ \
+  return replay_read(&cmp_cpus[n], a, 16); \
+} \
+static unsigned int mus_read32_##n(unsigned int a) \
+{ \
+  return replay_read(&cmp_cpus[n], a, 32); \
+} \
+static void mus_write8_##n(unsigned int a, unsigned char d) \
+{ \
+  replay_write(&cmp_cpus[n], a, d, 8); \
+} \
+static void mus_write16_##n(unsigned int a, unsigned short d) \
+{ \
+  replay_write(&cmp_cpus[n], a, d, 16); \
+} \
+static void mus_write32_##n(unsigned int a, unsigned int d) \
+{ \
+  replay_write(&cmp_cpus[n], a, d, 32); \
+} \
+static int mus_int_ack_##n(int level) \
+{ \
+  struct cmp_cpu *c = &cmp_cpus[n]; \
+  c->mus.int_level = c->irq[c->insn][1] << 8; \
+  return M68K_INT_ACK_AUTOVECTOR; \
+}
+
+MAKE_MUSASHI_HANDLERS(0)
+MAKE_MUSASHI_HANDLERS(1)
+
+// like the FAME hack, TAS only writes back on the sub cpu
+static int mus_tas_0(void) { return 0; }
+static int mus_tas_1(void) { return 1; }
+
+static void cmp_init(struct cmp_cpu *c, M68K_CONTEXT *ctx, int is_sub)
+{
+  void *oldcontext = m68ki_cpu_p;
+
+  memset(&c->mus, 0, sizeof(c->mus));
+  m68k_set_context(&c->mus);
+  m68k_set_cpu_type(M68K_CPU_TYPE_68000);
+  m68k_init();
+  m68k_set_int_ack_callback(is_sub ? mus_int_ack_1 : mus_int_ack_0);
+  m68k_set_tas_instr_callback(is_sub ? mus_tas_1 : mus_tas_0);
+  m68k_set_context(oldcontext);
+
+  c->mus.read_memory_8   = is_sub ? mus_read8_1   : mus_read8_0;
+  c->mus.read_memory_16  = is_sub ? mus_read16_1  : mus_read16_0;
+  c->mus.read_memory_32  = is_sub ? mus_read32_1  : mus_read32_0;
+  c->mus.write_memory_8  = is_sub ? mus_write8_1  : mus_write8_0;
+  c->mus.write_memory_16 = is_sub ? mus_write16_1 : mus_write16_0;
+  c->mus.write_memory_32 = is_sub ? mus_write32_1 : mus_write32_0;
+  c->ctx = ctx;
+}
+
+static void mus_sync(m68ki_cpu_core *m68ki_cpu_p, M68K_CONTEXT *ctx)
+{
+  int i;
+
+  m68ki_set_sr_noint(m68ki_cpu_p, ctx->sr);
+  for (i = 0; i < 8; i++) {
+    REG_D[i] = ctx->dreg[i].D;
+    REG_A[i] = ctx->areg[i].D;
+  }
+  if (FLAG_S)
+    REG_USP = ctx->asp;
+  else
+    REG_ISP = ctx->asp;
+  REG_PC = REG_PPC = ctx->pc & 0xffffff;
+  CPU_STOPPED = 0;
+  CPU_INT_CYCLES = 0;
+}
+
+static u32 mus_other_sp(m68ki_cpu_core *m68ki_cpu_p)
+{
+  return FLAG_S ? REG_USP : REG_ISP;
+}
+
+static void report(struct cmp_cpu *c, int n, int is_sub)
+{
+  m68ki_cpu_core *m68ki_cpu_p = &c->mus;
+  M68K_CONTEXT *ctx = c->ctx;
+  u32 fame_sr = ctx->sr, mus_sr = m68ki_get_sr();
+  int i;
+
+  elprintf(EL_STATUS, "cmp68k: %s diverged, frame %d line %d",
+    cmp_names[is_sub], Pico.m.frame_count, Pico.m.scanline);
+  for (i = 0; i < n; i++)
+    elprintf(EL_STATUS, "  %06x: %04x  irq %d->%d  cycles %d%s vs %d",
+      c->pc[i], fetch16(ctx, c->pc[i]), c->irq[i][0], c->irq[i][1],
+      c->cyc[i][0], c->ext[i] ? " (ext)" : "", c->cyc[i][1]);
+
+  for (i = 0; i < 8; i++) {
+    if (ctx->dreg[i].D != REG_D[i])
+      elprintf(EL_STATUS, "  d%d %08x vs %08x", i, ctx->dreg[i].D, REG_D[i]);
+    if (ctx->areg[i].D != REG_A[i])
+      elprintf(EL_STATUS, "  a%d %08x vs %08x", i, ctx->areg[i].D, REG_A[i]);
+  }
+  if ((ctx->pc ^ REG_PC) & 0xffffff)
+    elprintf(EL_STATUS, "  pc %06x vs %06x", ctx->pc & 0xffffff, REG_PC & 0xffffff);
+  if (fame_sr != mus_sr)
+    elprintf(EL_STATUS, "  sr %04x vs %04x", fame_sr, mus_sr);
+  if (ctx->asp != mus_other_sp(m68ki_cpu_p))
+    elprintf(EL_STATUS, "  osp %08x vs %08x", ctx->asp, mus_other_sp(m68ki_cpu_p));
+
+  for (i = 0; i < c->log_cnt; i++) {
+    struct access *l = &c->log[i];
+    if (!l->done)
+      elprintf(EL_STATUS, "  #%d %c%d @%06x %x not done by musashi",
+        l->insn, l->write ? 'w' : 'r', l->size, l->a, l->d);
+  }
+  for (i = 0; i < c->bad_cnt; i++) {
+    struct access *b = &c->bad[i];
+    elprintf(EL_STATUS, "  #%d w%d @%06x %x unexpected from musashi",
+      b->insn, b->size, b->a, b->d);
+  }
+  if (c->log_lost)
+    elprintf(EL_STATUS, "  %d accesses not logged", c->log_lost);
+}
+
+static int check(struct cmp_cpu *c, int n)
+{
+  m68ki_cpu_core *m68ki_cpu_p = &c->mus;
+  M68K_CONTEXT *ctx = c->ctx;
+  int i;
+
+  if (c->bad_cnt || c->log_lost)
+    return 1;
+  for (i = 0; i < c->log_cnt; i++)
+    if (!c->log[i].done)
+      return 1;
+  for (i = 0; i < n; i++)
+    if (c->cyc[i][0] != c->cyc[i][1] && !c->ext[i])
+      return 1;
+  for (i = 0; i < 8; i++)
+    if (ctx->dreg[i].D != REG_D[i] || ctx->areg[i].D != REG_A[i])
+      return 1;
+  if ((ctx->pc ^ REG_PC) & 0xffffff)
+    return 1;
+  if (ctx->sr != m68ki_get_sr())
+    return 1;
+  return ctx->asp != mus_other_sp(m68ki_cpu_p);
+}
+
+// run a stretch on FAME, returns the cycles left
+static int run_fame(struct cmp_cpu *c, int left, int *n_out)
+{
+  M68K_CONTEXT *ctx = c->ctx;
+  int n, r;
+
+  for (n = 0; n < CMP68K_N && left > 0; n++) {
+    c->insn = n;
+    c->pc[n] = ctx->pc & 0xffffff;
+    c->irq[n][0] = ctx->interrupts[0];
+    c->ext[n] = 0;
+
+    // to the handlers it must look like a normal run of 'left' cycles
+    c->bias = left - 1;
+    *c->cnt -= c->bias;
+    c->cnt_step = *c->cnt;
+    r = fm68k_emulate(ctx, 1, 0);
+    *c->cnt += c->bias;
+    left = 1 - r + c->bias;
+
+    c->cyc[n][0] = r;
+    c->irq[n][1] = ctx->interrupts[0];
+    if (ctx->execinfo & FM68K_HALTED) {
+      n++;
+      break;
+    }
+  }
+
+  *n_out = n;
+  return left;
+}
+
+static void run_musashi(struct cmp_cpu *c, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++) {
+    c->insn = i;
+    c->mus.int_level = c->irq[i][0] << 8;
+    c->cyc[i][1] = m68k_execute(&c->mus, 1);
+    // Musashi eats the rest of the timeslice on bra.s to itself
+    if (c->mus.ir == 0x60fe)
+      c->ext[i] = 1;
+  }
+}
+
+static int stretch(struct cmp_cpu *c, unsigned int *cnt, int left, int is_sub)
+{
+  M68K_CONTEXT *ctx = c->ctx;
+  unsigned char *fast_ram = ctx->fast_ram;
+  unsigned int fast_rom_len = ctx->fast_rom_len;
+  int n;
+
+  mus_sync(&c->mus, ctx);
+  c->cnt = cnt;
+  c->log_cnt = c->log_lost = c->bad_cnt = 0;
+
+  c->read8   = ctx->read_byte;
+  c->read16  = ctx->read_word;
+  c->read32  = ctx->read_long;
+  c->write8  = ctx->write_byte;
+  c->write16 = ctx->write_word;
+  c->write32 = ctx->write_long;
+  ctx->read_byte  = is_sub ? fame_read8_1   : fame_read8_0;
+  ctx->read_word  = is_sub ? fame_read16_1  : fame_read16_0;
+  ctx->read_long  = is_sub ? fame_read32_1  : fame_read32_0;
+  ctx->write_byte = is_sub ? fame_write8_1  : fame_write8_0;
+  ctx->write_word = is_sub ? fame_write16_1 : fame_write16_0;
+  ctx->write_long = is_sub ? fame_write32_1 : fame_write32_0;
+  ctx->fast_ram = NULL;
+  ctx->fast_rom_len = 0;
+
+  left = run_fame(c, left, &n);
+
+  ctx->read_byte  = c->read8;
+  ctx->read_word  = c->read16;
+  ctx->read_long  = c->read32;
+  ctx->write_byte = c->write8;
+  ctx->write_word = c->write16;
+  ctx->write_long = c->write32;
+  ctx->fast_ram = fast_ram;
+  ctx->fast_rom_len = fast_rom_len;
+
+  run_musashi(c, n);
+
+  if (check(c, n)) {
+    report(c, n, is_sub);
+    if (++cmp_reports == REPORTS_MAX)
+      elprintf(EL_STATUS, "cmp68k: too many divergences, giving up");
+  }
+
+  return left;
+}
+
+// drop-in for fm68k_emulate(ctx, cycles, 0)
+int cmp68k_run(M68K_CONTEXT *ctx, int cycles)
+{
+  int is_sub = ctx == &PicoCpuFS68k;
+  struct cmp_cpu *c = &cmp_cpus[is_sub];
+  unsigned int *cnt = is_sub ? &SekCycleCntS68k : &Pico.t.m68c_cnt;
+  int left = cycles;
+
+  if (cmp_reports >= REPORTS_MAX)
+    return fm68k_emulate(ctx, cycles, 0);
+  if (c->ctx == NULL)
+    cmp_init(c, ctx, is_sub);
+
+  while (left > 0) {
+    // a stopped cpu is only woken by an irq, the rest is idle time
+    if ((ctx->execinfo & FM68K_HALTED)
+        && ctx->interrupts[0] <= ((ctx->sr >> 8) & 7))
+      return cycles;
+    left = stretch(c, cnt, left, is_sub);
+  }
+
+  return cycles - left;
+}
+
+// vim:shiftwidth=2:ts=2:expandtab
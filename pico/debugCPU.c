@@ -127,7 +127,7 @@ int CM_compareRun(int cyc, int is_sub)
     // Musashi takes irq even if it hasn't got cycles left, let othercpu do it too
     if (other_get_irq() && other_get_irq() > ((other_get_sr()>>8)&7))
       cyc_other+=otherRun();
-    cyc_musashi=m68k_execute(1);
+    cyc_musashi=m68k_execute(NULL, 1);
 
     if (cyc_other != cyc_musashi) {
       dprintf("cycles: %i vs %i", cyc_other, cyc_musashi);
@@ -0,0 +1,84 @@
+/*
+ * PicoDrive
+ * idle loop and poll detection helpers, shared by all cpus
+ *
+ * This work is licensed under the terms of MAME license.
+ * See COPYING file in the top-level directory.
+ *
+ * Each cpu has its own way of noticing that it's spinning (patched
+ * branches on the 68k, jr checks in cz80, reads of shared registers on
+ * 32X/CD), but they all end the same way: the cpu is stopped or its
+ * timeslice is consumed until the next event or a write by another cpu.
+ * Hits are collected here per loaded title.
+ */
+
+#include "pico_int.h"
+
+unsigned int  idlehit_addrs[IDLEHIT_MAX], idlehit_counts[IDLEHIT_MAX];
+unsigned char idlehit_cpus[IDLEHIT_MAX];
+static int idlehit_last;
+
+static const char *idle_cpu_names[] = { "m68k", "s68k", "z80", "msh2", "ssh2" };
+
+// count a hit of an idle loop or poller at pc
+void PicoIdleHit(int cpu, unsigned int pc)
+{
+  int i = idlehit_last;
+
+  // usually it's the same loop over and over again
+  if (idlehit_addrs[i] == pc && idlehit_cpus[i] == cpu && idlehit_counts[i]) {
+    idlehit_counts[i]++;
+    return;
+  }
+
+  for (i = 0; i < IDLEHIT_MAX - 1 && idlehit_counts[i]; i++) {
+    if (idlehit_addrs[i] == pc && idlehit_cpus[i] == cpu) {
+      idlehit_counts[i]++;
+      idlehit_last = i;
+      return;
+    }
+  }
+  if (idlehit_counts[i] == 0)
+    elprintf(EL_IDLE, "idle: new %s loop @%06x", idle_cpu_names[cpu], pc);
+  idlehit_addrs[i] = pc;
+  idlehit_cpus[i] = cpu;
+  idlehit_counts[i] = 1;
+  idlehit_last = i;
+}
+
+void PicoIdleStatsReset(void)
+{
+  memset(idlehit_counts, 0, sizeof(idlehit_counts));
+  idlehit_last = 0;
+}
+
+void PicoIdleStatsPrint(void)
+{
+  int i;
+
+  for (i = 0; i < IDLEHIT_MAX && idlehit_counts[i]; i++)
+    elprintf(EL_IDLE, "idle: %s @%06x hit %u times",
+      idle_cpu_names[idlehit_cpus[i]], idlehit_addrs[i], idlehit_counts[i]);
+}
+
+// Feed a read of a polled location. Returns how many reads in a row
+// before this one went to the same place (within 'slack' bytes) with no
+// more than 'max_cycles' between them.
+int poll_detect(struct poll_det *p, unsigned int a, unsigned int cycles,
+  unsigned int slack, unsigned int max_cycles)
+{
+  int cnt = 0;
+
+  if (a - slack <= p->addr && p->addr <= a + slack
+      && cycles - p->cycles <= max_cycles)
+    cnt = p->cnt++;
+  else {
+    p->cnt = 0;
+    p->addr = a;
+  }
+  p->cycles = cycles;
+
+  return cnt;
+}
+
+// vim:shiftwidth=2:ts=2:expandtab
@@ -20,6 +20,8 @@ uptr m68k_read16_map [0x1000000 >> M68K_MEM_SHIFT];
 uptr m68k_write8_map [0x1000000 >> M68K_MEM_SHIFT];
 uptr m68k_write16_map[0x1000000 >> M68K_MEM_SHIFT];
 
+static void m68k_map_fast_update(void);
+
 static void xmap_set(uptr *map, int shift, int start_addr, int end_addr,
     const void *func_or_mh, int is_func)
 {
@@ -63,6 +65,9 @@ void cpu68k_map_set(uptr *map, int start_addr, int end_addr,
     const void *func_or_mh, int is_func)
 {
   xmap_set(map, M68K_MEM_SHIFT, start_addr, end_addr, func_or_mh, is_func);
+  if (map == m68k_read8_map || map == m68k_read16_map
+      || map == m68k_write8_map || map == m68k_write16_map)
+    m68k_map_fast_update();
 #ifdef EMU_F68K
   // setup FAME fetchmap
   if (!is_func)
@@ -100,6 +105,8 @@ void cpu68k_map_all_ram(int start_addr, int end_addr, void *ptr, int is_sub)
   addr >>= 1;
   for (i = start_addr >> shift; i <= end_addr >> shift; i++)
     r8map[i] = r16map[i] = w8map[i] = w16map[i] = addr;
+  if (!is_sub)
+    m68k_map_fast_update();
 #ifdef EMU_F68K
   // setup FAME fetchmap
   {
@@ -161,6 +168,8 @@ void m68k_map_unmap(int start_addr, int end_addr)
   addr = (uptr)m68k_unmapped_write16;
   for (i = start_addr >> shift; i <= end_addr >> shift; i++)
     m68k_write16_map[i] = (addr >> 1) | MAP_FLAG;
+
+  m68k_map_fast_update();
 }
 
 MAKE_68K_READ8(m68k_read8, m68k_read8_map)
@@ -170,6 +179,46 @@ MAKE_68K_WRITE8(m68k_write8, m68k_write8_map)
 MAKE_68K_WRITE16(m68k_write16, m68k_write16_map)
 MAKE_68K_WRITE32(m68k_write32, m68k_write16_map)
 
+// FAME reads and writes work RAM and linearly mapped ROM directly
+// (see fm68k_read_byte() and friends), skipping the table lookup and
+// the indirect call for the bulk of data accesses. Which ranges qualify
+// is rechecked against the tables each time they change (cart insert,
+// mappers, 32X), anything else goes through the handlers above.
+#ifdef EMU_F68K
+static void m68k_map_fast_update(void)
+{
+  uptr v;
+  int i, lo, hi, ram_ok = 1;
+
+  for (i = 0xe00000 >> M68K_MEM_SHIFT; i < 0x1000000 >> M68K_MEM_SHIFT; i++) {
+    v = ((uptr)PicoMem.ram - (i << M68K_MEM_SHIFT)) >> 1;
+    if (m68k_read8_map[i] != v || m68k_read16_map[i] != v
+        || m68k_write8_map[i] != v || m68k_write16_map[i] != v)
+      ram_ok = 0;
+  }
+
+  // ROM is at 0, or from 0x10000 when the 32X BIOS covers the first bank
+  lo = hi = 0;
+  if (Pico.rom != NULL) {
+    v = (uptr)Pico.rom >> 1;
+    if (m68k_read8_map[0] != v || m68k_read16_map[0] != v)
+      lo = hi = 1;
+    while (hi < 0x400000 >> M68K_MEM_SHIFT
+           && m68k_read8_map[hi] == v && m68k_read16_map[hi] == v)
+      hi++;
+  }
+
+  PicoCpuFM68k.fast_ram = ram_ok ? PicoMem.ram : NULL;
+  PicoCpuFM68k.fast_rom = Pico.rom;
+  PicoCpuFM68k.fast_rom_lo = lo << M68K_MEM_SHIFT;
+  PicoCpuFM68k.fast_rom_len = (hi - lo) << M68K_MEM_SHIFT;
+}
+#else
+static void m68k_map_fast_update(void)
+{
+}
+#endif
+
 // -----------------------------------------------------------------
 
 static u32 ym2612_read_local_68k(void);
@@ -281,6 +330,7 @@ void PicoSetInputDevice(int port, enum input_device device)
 {
   port_read_func *func;
 
+  pcd_s68k_wait();
   if (port < 0 || port > 2)
     return;
 
@@ -826,6 +876,7 @@ PICO_INTERNAL void PicoMemSetup(void)
   PicoCpuFM68k.write_byte = m68k_write8;
   PicoCpuFM68k.write_word = m68k_write16;
   PicoCpuFM68k.write_long = m68k_write32;
+  m68k_map_fast_update();
 
   // setup FAME fetchmap
   {
@@ -847,29 +898,14 @@ PICO_INTERNAL void PicoMemSetup(void)
 }
 
 #ifdef EMU_M68K
-unsigned int (*pm68k_read_memory_8) (unsigned int address) = NULL;
-unsigned int (*pm68k_read_memory_16)(unsigned int address) = NULL;
-unsigned int (*pm68k_read_memory_32)(unsigned int address) = NULL;
-void (*pm68k_write_memory_8) (unsigned int address, unsigned char  value) = NULL;
-void (*pm68k_write_memory_16)(unsigned int address, unsigned short value) = NULL;
-void (*pm68k_write_memory_32)(unsigned int address, unsigned int   value) = NULL;
-
-/* it appears that Musashi doesn't always mask the unused bits */
-unsigned int m68k_read_memory_8 (unsigned int address) { return pm68k_read_memory_8 (address) & 0xff; }
-unsigned int m68k_read_memory_16(unsigned int address) { return pm68k_read_memory_16(address) & 0xffff; }
-unsigned int m68k_read_memory_32(unsigned int address) { return pm68k_read_memory_32(address); }
-void m68k_write_memory_8 (unsigned int address, unsigned int value) { pm68k_write_memory_8 (address, (u8)value); }
-void m68k_write_memory_16(unsigned int address, unsigned int value) { pm68k_write_memory_16(address,(u16)value); }
-void m68k_write_memory_32(unsigned int address, unsigned int value) { pm68k_write_memory_32(address, value); }
-
 static void m68k_mem_setup(void)
 {
-  pm68k_read_memory_8  = m68k_read8;
-  pm68k_read_memory_16 = m68k_read16;
-  pm68k_read_memory_32 = m68k_read32;
-  pm68k_write_memory_8  = m68k_write8;
-  pm68k_write_memory_16 = m68k_write16;
-  pm68k_write_memory_32 = m68k_write32;
+  PicoCpuMM68k.read_memory_8  = m68k_read8;
+  PicoCpuMM68k.read_memory_16 = m68k_read16;
+  PicoCpuMM68k.read_memory_32 = m68k_read32;
+  PicoCpuMM68k.write_memory_8  = m68k_write8;
+  PicoCpuMM68k.write_memory_16 = m68k_write16;
+  PicoCpuMM68k.write_memory_32 = m68k_write32;
 }
 #endif // EMU_M68K
 
@@ -889,6 +925,42 @@ static int get_scanline(int is_from_z80)
   return Pico.m.scanline;
 }
 
+// sample position of the current cpu time
+static int get_snd_pos(int is_from_z80)
+{
+  int line, cycles;
+
+  if (is_from_z80) {
+    line = get_scanline(1);
+    cycles = (z80_cyclesDone() * 15 - line * 488 * 7) / 7;
+  }
+  else {
+    line = Pico.m.scanline;
+    cycles = SekCyclesDone() - Pico.t.m68c_line_start;
+  }
+  return PsndPos(line, cycles);
+}
+
+// FM output changes at 'pos', bring it up to there first.
+// Returns 1 if the write went to the FM thread instead.
+static int ym2612_fm_sync(u32 reg, u32 d, int pos)
+{
+  if (ym2612_thread_on) {
+    ym2612_thread_write(reg, d, pos);
+    return 1;
+  }
+  PsndDoFM(pos);
+  return 0;
+}
+
+// next overflow after 'xcycles', as if the timer kept running
+static int timer_next_oflow(int next_oflow, int step, int xcycles)
+{
+  if (xcycles > next_oflow)
+    next_oflow += (xcycles - next_oflow + step - 1) / step * step;
+  return next_oflow;
+}
+
 /* probably should not be in this file, but it's near related code here */
 void ym2612_sync_timers(int z80_cycles, int mode_old, int mode_new)
 {
@@ -903,8 +975,8 @@ void ym2612_sync_timers(int z80_cycles, int mode_old, int mode_new)
 
   /* update timer a */
   if (mode_old & 1)
-    while (xcycles > Pico.t.timer_a_next_oflow)
-      Pico.t.timer_a_next_oflow += Pico.t.timer_a_step;
+    Pico.t.timer_a_next_oflow = timer_next_oflow(Pico.t.timer_a_next_oflow,
+      Pico.t.timer_a_step, xcycles);
 
   if ((mode_old ^ mode_new) & 1) // turning on/off
   {
@@ -918,8 +990,8 @@ void ym2612_sync_timers(int z80_cycles, int mode_old, int mode_new)
 
   /* update timer b */
   if (mode_old & 2)
-    while (xcycles > Pico.t.timer_b_next_oflow)
-      Pico.t.timer_b_next_oflow += Pico.t.timer_b_step;
+    Pico.t.timer_b_next_oflow = timer_next_oflow(Pico.t.timer_b_next_oflow,
+      Pico.t.timer_b_step, xcycles);
 
   if ((mode_old ^ mode_new) & 2)
   {
@@ -940,11 +1012,10 @@ static int ym2612_write_local(u32 a, u32 d, int is_from_z80)
   a &= 3;
   if (a == 1 && ym2612.OPN.ST.address == 0x2a) /* DAC data */
   {
-    int scanline = get_scanline(is_from_z80);
-    //elprintf(EL_STATUS, "%03i -> %03i dac w %08x z80 %i", Pico.snd.dac_line, scanline, d, is_from_z80);
-    ym2612.dacout = ((int)d - 0x80) << 6;
+    // previous value plays until now
     if (ym2612.dacen)
-      PsndDoDAC(scanline);
+      PsndDoDAC(get_snd_pos(is_from_z80));
+    ym2612.dacout = ((int)d - 0x80) << 6;
     return 0;
   }
 
@@ -1004,6 +1075,10 @@ static int ym2612_write_local(u32 a, u32 d, int is_from_z80)
         case 0x27: { /* mode, timer control */
           int old_mode = ym2612.OPN.ST.mode;
           int cycles = is_from_z80 ? z80_cyclesDone() : z80_cycles_from_68k();
+
+          // 3 slot mode changes FM output
+          if (((d ^ old_mode) & 0xc0) && !(PicoIn.opt & POPT_EXT_FM))
+            ym2612_fm_sync(addr, d, get_snd_pos(is_from_z80));
           ym2612.OPN.ST.mode = d;
 
           elprintf(EL_YMTIMER, "st mode %02x", d);
@@ -1017,22 +1092,23 @@ static int ym2612_write_local(u32 a, u32 d, int is_from_z80)
           if (d & 0x20)
             ym2612.OPN.ST.status &= ~2;
 
-          if ((d ^ old_mode) & 0xc0) {
 #ifdef __GP2X__
-            if (PicoIn.opt & POPT_EXT_FM) return YM2612Write_940(a, d, get_scanline(is_from_z80));
+          if (((d ^ old_mode) & 0xc0) && (PicoIn.opt & POPT_EXT_FM))
+            return YM2612Write_940(a, d, get_scanline(is_from_z80));
 #endif
-            return 1;
-          }
           return 0;
         }
         case 0x2b: { /* DAC Sel  (YM2612) */
-          int scanline = get_scanline(is_from_z80);
           if (ym2612.dacen != (d & 0x80)) {
+            int pos = get_snd_pos(is_from_z80);
+            // finish the DAC (or skip it) up to now, FM ch6 is muted by it
+            PsndDoDAC(pos);
+            if (!(PicoIn.opt & POPT_EXT_FM))
+              ym2612_fm_sync(addr, d, pos);
             ym2612.dacen = d & 0x80;
-            Pico.snd.dac_line = scanline;
           }
 #ifdef __GP2X__
-          if (PicoIn.opt & POPT_EXT_FM) YM2612Write_940(a, d, scanline);
+          if (PicoIn.opt & POPT_EXT_FM) YM2612Write_940(a, d, get_scanline(is_from_z80));
 #endif
           return 0;
         }
@@ -1060,7 +1136,9 @@ static int ym2612_write_local(u32 a, u32 d, int is_from_z80)
   if (PicoIn.opt & POPT_EXT_FM)
     return YM2612Write_940(a, d, get_scanline(is_from_z80));
 #endif
-  return YM2612Write_(a, d);
+  if (!ym2612_fm_sync(addr, d, get_snd_pos(is_from_z80)))
+    YM2612Write_(a, d);
+  return 0;
 }
 
 
@@ -1098,6 +1176,8 @@ void ym2612_pack_state(void)
 {
   // timers are saved as tick counts, in 16.16 int format
   int tac, tat = 0, tbc, tbt = 0;
+
+  ym2612_thread_sync();
   tac = 1024 - ym2612.OPN.ST.TA;
   tbc = 256  - ym2612.OPN.ST.TB;
   if (Pico.t.timer_a_next_oflow != TIMER_NO_OFLOW)
@@ -1120,6 +1200,9 @@ void ym2612_pack_state(void)
 void ym2612_unpack_state(void)
 {
   int i, ret, tac, tat, tbc, tbt;
+
+  // chip state is replaced, the thread is restarted on next frame
+  ym2612_thread_stop();
   YM2612PicoStateLoad();
 
   // feed all the registers and update internal state
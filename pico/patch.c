@@ -460,6 +460,8 @@ void PicoPatchApply(void)
    int i, u;
    unsigned int addr;
 
+   pcd_s68k_wait();
+
    for (i = 0; i < PicoPatchCount; i++)
    {
       addr = PicoPatches[i].addr;
@@ -486,8 +488,9 @@ void PicoPatchApply(void)
                   *(char *)(Pico.rom + addr) = (char) PicoPatches[i].data_old;
             }
          }
-      // fprintf(stderr, "patched %i: %06x:%04x\n", PicoPatches[i].active, addr,
-      // *(unsigned short *)(Pico.rom + addr));
+         SekRomWritten(addr, 2);
+         // fprintf(stderr, "patched %i: %06x:%04x\n", PicoPatches[i].active, addr,
+         // *(unsigned short *)(Pico.rom + addr));
       }
       else
       {
@@ -46,6 +46,7 @@ void PicoInit(void)
 // to be called once on emu exit
 void PicoExit(void)
 {
+  PsndStemsStop(); // before the sources go away
   if (PicoIn.AHW & PAHW_MCD)
     PicoExitMCD();
   PicoCartUnload();
@@ -59,6 +60,7 @@ void PicoExit(void)
 
 void PicoPower(void)
 {
+  pcd_s68k_wait();
   Pico.m.frame_count = 0;
   Pico.t.m68c_cnt = Pico.t.m68c_aim = 0;
 
@@ -150,9 +152,15 @@ int PicoReset(void)
   if (Pico.romsize <= 0)
     return 1;
 
+  pcd_s68k_wait();
+
 #if defined(CPU_CMP_R) || defined(CPU_CMP_W) || defined(DRC_CMP)
   PicoIn.opt |= POPT_DIS_VDP_FIFO|POPT_DIS_IDLE_DET;
 #endif
+#ifdef CMP_68K
+  // the idle loop patches are FAME opcodes
+  PicoIn.opt |= POPT_DIS_IDLE_DET;
+#endif
 
   /* must call now, so that banking is reset, and correct vectors get fetched */
   if (PicoResetHook)
@@ -214,6 +222,8 @@ int PicoReset(void)
 // flush config changes before emu loop starts
 void PicoLoopPrepare(void)
 {
+  pcd_s68k_wait();
+
   if (PicoIn.regionOverride)
     // force setting possibly changed..
     Pico.m.pal = (PicoIn.regionOverride == 2 || PicoIn.regionOverride == 8) ? 1 : 0;
@@ -295,6 +305,7 @@ PICO_INTERNAL void PicoSyncZ80(unsigned int m68k_cycles_done)
 void PicoFrame(void)
 {
   pprof_start(frame);
+  pcd_s68k_wait();
 
   Pico.m.frame_count++;
 
@@ -322,8 +333,14 @@ end:
   pprof_end(frame);
 }
 
+void PicoFrameWait(void)
+{
+  pcd_s68k_wait();
+}
+
 void PicoFrameDrawOnly(void)
 {
+  pcd_s68k_wait();
   if (!(PicoIn.AHW & PAHW_SMS)) {
     PicoFrameStart();
     PicoDrawSync(223, 0);
@@ -334,6 +351,7 @@ void PicoFrameDrawOnly(void)
 
 void PicoGetInternal(pint_t which, pint_ret_t *r)
 {
+  pcd_s68k_wait();
   switch (which)
   {
     case PI_ROM:         r->vptr = Pico.rom; break;
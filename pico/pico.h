@@ -22,6 +22,7 @@ extern void lprintf(const char *fmt, ...);
 // external funcs for Sega/Mega CD
 extern int  mp3_get_bitrate(void *f, int size);
 extern void mp3_start_play(void *f, int pos);
+// mixes 'length' 44.1kHz stereo frames, the core resamples them
 extern void mp3_update(int *buffer, int length, int stereo);
 
 // this function should write-back d-cache and invalidate i-cache
@@ -55,15 +56,15 @@ extern void *p32x_bios_g, *p32x_bios_m, *p32x_bios_s;
 #define POPT_EN_Z80         (1<< 2)
 #define POPT_EN_STEREO      (1<< 3)
 #define POPT_ALT_RENDERER   (1<< 4) // 00 00x0
-// unused                   (1<< 5)
-// unused                   (1<< 6)
+#define POPT_EN_32X_SPEC    (1<< 5)
+#define POPT_EN_SND_THREAD  (1<< 6)
 #define POPT_ACC_SPRITES    (1<< 7)
 #define POPT_DIS_32C_BORDER (1<< 8) // 00 0x00
 #define POPT_EXT_FM         (1<< 9)
 #define POPT_EN_MCD_PCM     (1<<10)
 #define POPT_EN_MCD_CDDA    (1<<11)
 #define POPT_EN_MCD_GFX     (1<<12) // 00 x000
-// unused                   (1<<13)
+#define POPT_EN_MCD_THREAD  (1<<13)
 #define POPT_EN_SOFTSCALE   (1<<14)
 #define POPT_EN_MCD_RAMCART (1<<15)
 #define POPT_DIS_VDP_FIFO   (1<<16) // 0x 0000
@@ -98,7 +99,7 @@ typedef struct
 	unsigned short quirks;         // game-specific quirks: PQUIRK_*
 	unsigned short overclockM68k;  // overclock the emulated 68k, in %
 
-	int sndRate;                   // rate in Hz
+	int sndRate;                   // rate in Hz, up to PSND_MAX_RATE
 	short *sndOut;                 // PCM output buffer
 	void (*writeSound)(int len);   // write .sndOut callback, called once per frame
 
@@ -117,6 +118,11 @@ int  PicoReset(void);
 void PicoLoopPrepare(void);
 void PicoFrame(void);
 void PicoFrameDrawOnly(void);
+// With POPT_EN_MCD_THREAD the sub cpu may still be finishing the frame
+// after PicoFrame() returns. The Pico* calls wait for it themselves, but a
+// host that reads or writes emulated memory through pointers it holds
+// (RAM, backup RAM, SRAM) must call this first.
+void PicoFrameWait(void);
 typedef enum { PI_ROM, PI_ISPAL, PI_IS40_CELL, PI_IS240_LINES } pint_t;
 typedef union { int vint; void *vptr; } pint_ret_t;
 void PicoGetInternal(pint_t which, pint_ret_t *ret);
@@ -145,6 +151,9 @@ int PicoState(const char *fname, int is_save);
 int PicoStateLoadGfx(const char *fname);
 void *PicoTmpStateSave(void);
 void  PicoTmpStateRestore(void *data);
+size_t PicoStateSnapSize(void);
+int    PicoStateSnapSave(void *buf, size_t size);
+int    PicoStateSnapLoad(const void *buf, size_t size);
 extern void (*PicoStateProgressCB)(const char *str);
 
 // cd/cdd.c
@@ -156,7 +165,8 @@ typedef enum
 {
 	PMT_UNCOMPRESSED = 0,
 	PMT_ZIP,
-	PMT_CSO
+	PMT_CSO,
+	PMT_PDZ
 } pm_type;
 typedef struct
 {
@@ -176,6 +186,8 @@ void PicoCartUnload(void);
 extern void (*PicoCartLoadProgressCB)(int percent);
 extern void (*PicoCDLoadProgressCB)(const char *fname, int percent);
 extern int PicoGameLoaded;
+extern const char *PicoCartCacheDir;
+extern const char *PicoDrcCacheDir;
 
 // Draw.c
 // for line-based renderer, set conversion
@@ -232,9 +244,34 @@ void Pico32xSetClocks(int msh2_hz, int ssh2_hz);
 #define PICO_SSH2_HZ ((int)(7670442.0 * 2.4))
 
 // sound.c
+#define PSND_MAX_RATE 96000
+#define PSND_RATE_ADJ 400   // ring rate control moves samples/frame by up to 1/this
+// .sndOut needs 2*PSND_MAX_LEN shorts
+#define PSND_MAX_LEN  (PSND_MAX_RATE / 50 + PSND_MAX_RATE / 50 / PSND_RATE_ADJ + 2)
 extern void (*PsndMix_32_to_16l)(short *dest, int *src, int count);
 void PsndRerate(int preserve_state);
 
+// sndring.c, for audio pulled from another thread
+int  PsndRingStart(int latency_ms);
+void PsndRingStop(void);
+int  PsndRingRead(short *dest, int frames);
+int  PsndRingFill(void);
+unsigned int PsndRingUnderruns(void);
+
+// stems.c, every sound source captured to its own .wav
+enum {
+  PSND_STEM_FM1,                        // FM channels 1-6
+  PSND_STEM_DAC = PSND_STEM_FM1 + 6,
+  PSND_STEM_PSG1,                       // PSG tones 1-3, noise
+  PSND_STEM_PCM1 = PSND_STEM_PSG1 + 4,  // CD PCM channels 1-8
+  PSND_STEM_CDDA = PSND_STEM_PCM1 + 8,
+  PSND_STEM_PWM,
+  PSND_STEM_COUNT
+};
+int  PsndStemsStart(const char *prefix, unsigned int mask);
+void PsndStemsStop(void);
+int  PsndStemsActive(void);
+
 // media.c
 enum media_type_e {
   PM_BAD_DETECT = -1,
@@ -36,9 +36,9 @@ static void SekSyncM68k(void)
     CycloneRun(&PicoCpuCM68k);
     Pico.t.m68c_cnt -= PicoCpuCM68k.cycles;
 #elif defined(EMU_M68K)
-    Pico.t.m68c_cnt += m68k_execute(cyc_do) - cyc_do;
+    Pico.t.m68c_cnt += m68k_execute(&PicoCpuMM68k, cyc_do) - cyc_do;
 #elif defined(EMU_F68K)
-    Pico.t.m68c_cnt += fm68k_emulate(&PicoCpuFM68k, cyc_do, 0) - cyc_do;
+    Pico.t.m68c_cnt += SekEmulateF68k(&PicoCpuFM68k, cyc_do) - cyc_do;
 #endif
   }
 
@@ -150,8 +150,8 @@ static int PicoFrameHints(void)
       }
     }
 
-    // get samples from sound chips
-    if ((y == 224 || y == line_sample) && PicoIn.sndOut)
+    // get samples from sound chips (without output, still move them on)
+    if (y == 224 || (y == line_sample && PicoIn.sndOut))
     {
       cycles = SekCyclesDone();
 
@@ -239,7 +239,7 @@ static int PicoFrameHints(void)
 #endif
 
   // get samples from sound chips
-  if (y == 224 && PicoIn.sndOut)
+  if (y == 224)
     PsndGetSamples(y);
 
   // Run scanline:
@@ -325,14 +325,14 @@ static int PicoFrameHints(void)
   cycles = SekCyclesDone();
   if (Pico.m.z80Run && !Pico.m.z80_reset && (PicoIn.opt&POPT_EN_Z80))
     PicoSyncZ80(cycles);
-  if (PicoIn.sndOut && ym2612.dacen && Pico.snd.dac_line < lines)
-    PsndDoDAC(lines - 1);
-  if (PicoIn.sndOut && Pico.snd.psg_line < lines)
+  if (PicoIn.sndOut && ym2612.dacen)
+    PsndDoDAC(PsndPos(lines - 1, 488));
+  if (Pico.snd.psg_line < lines)
     PsndDoPSG(lines - 1);
 
 #ifdef PICO_CD
   if (PicoIn.AHW & PAHW_MCD)
-    pcd_sync_s68k(cycles, 0);
+    pcd_sync_s68k_frame_end(cycles);
 #endif
 #ifdef PICO_32X
   p32x_sync_sh2s(cycles);
@@ -81,6 +81,12 @@ extern M68K_CONTEXT PicoCpuFM68k, PicoCpuFS68k;
 #define SekIsStoppedM68k() (PicoCpuFM68k.execinfo&FM68K_HALTED)
 #define SekIsStoppedS68k() (PicoCpuFS68k.execinfo&FM68K_HALTED)
 #define SekShouldInterrupt() fm68k_would_interrupt(&PicoCpuFM68k)
+#ifdef CMP_68K
+int  cmp68k_run(M68K_CONTEXT *ctx, int cycles);
+#define SekEmulateF68k(ctx, cycles) cmp68k_run(ctx, cycles)
+#else
+#define SekEmulateF68k(ctx, cycles) fm68k_emulate(ctx, cycles, 0)
+#endif
 
 #define SekNotPolling     PicoCpuFM68k.not_polling
 #define SekNotPollingS68k PicoCpuFS68k.not_polling
@@ -421,7 +427,7 @@ struct PicoSound
   short len_use;                        // adjusted
   int len_e_add;                        // for non-int samples/frame
   int len_e_cnt;
-  short dac_line;
+  short dac_pos;                        // DAC output done up to this sample
   short psg_line;
 };
 
@@ -638,6 +644,7 @@ extern int PicoCartResize(int newsize);
 extern void Byteswap(void *dst, const void *src, int len);
 extern void (*PicoCartMemSetup)(void);
 extern void (*PicoCartUnloadHook)(void);
+unsigned int rom_crc32(void);
 
 // debug.c
 int CM_compareRun(int cyc, int is_sub);
@@ -696,6 +703,7 @@ void cdd_read_data(unsigned char *dst);
 void cdd_read_audio(unsigned int samples);
 void cdd_update(void);
 void cdd_process(void);
+void cdd_resync_audio(void);
 
 // cd/cd_image.c
 int load_cd_image(const char *cd_img_name, int *type);
@@ -754,13 +762,22 @@ void pcd_event_schedule_s68k(enum pcd_event event, int after);
 void pcd_prepare_frame(void);
 unsigned int pcd_cycles_m68k_to_s68k(unsigned int c);
 int  pcd_sync_s68k(unsigned int m68k_target, int m68k_poll_sync);
+void pcd_sync_s68k_frame_end(unsigned int m68k_target);
 void pcd_run_cpus(int m68k_cycles);
 void pcd_soft_reset(void);
 void pcd_state_loaded(void);
+#ifdef USE_THREADS
+void pcd_s68k_wait(void);
+void pcd_s68k_thread_stop(void);
+#else
+#define pcd_s68k_wait()
+#define pcd_s68k_thread_stop()
+#endif
 
 // cd/pcm.c
 void pcd_pcm_sync(unsigned int to);
 void pcd_pcm_update(int *buffer, int length, int stereo);
+void pcd_pcm_stems(int on);
 void pcd_pcm_write(unsigned int a, unsigned int d);
 unsigned int pcd_pcm_read(unsigned int a);
 
@@ -783,12 +800,34 @@ PICO_INTERNAL void SekUnpackCpu(const unsigned char *cpu, int is_sub);
 void SekStepM68k(void);
 void SekInitIdleDet(void);
 void SekFinishIdleDet(void);
+void SekRegisterIdleHit(unsigned int pc);
+void SekRomChanged(void);
+void SekRomWritten(unsigned int a, unsigned int size);
 #if defined(CPU_CMP_R) || defined(CPU_CMP_W)
 void SekTrace(int is_s68k);
 #else
 #define SekTrace(x)
 #endif
 
+// idle.c
+enum { IDLE_M68K, IDLE_S68K, IDLE_Z80, IDLE_MSH2, IDLE_SSH2 };
+#define IDLEHIT_MAX 128
+extern unsigned int  idlehit_addrs[IDLEHIT_MAX], idlehit_counts[IDLEHIT_MAX];
+extern unsigned char idlehit_cpus[IDLEHIT_MAX];
+struct poll_det {
+  unsigned int addr, cycles;
+  int cnt;
+};
+void PicoIdleHit(int cpu, unsigned int pc);
+void PicoIdleStatsReset(void);
+void PicoIdleStatsPrint(void);
+int  poll_detect(struct poll_det *p, unsigned int a, unsigned int cycles,
+  unsigned int slack, unsigned int max_cycles);
+static __inline void poll_reset(struct poll_det *p)
+{
+  p->addr = p->cnt = 0;
+}
+
 // cd/sek.c
 PICO_INTERNAL void SekInitS68k(void);
 PICO_INTERNAL int  SekResetS68k(void);
@@ -798,11 +837,41 @@ void SekInterruptClearS68k(int irq);
 // sound/sound.c
 extern short cdda_out_buffer[2*1152];
 
-void cdda_start_play(int lba_base, int lba_offset, int lb_len);
+void cdda_start_play(int lba_base, int lba_offset, int lb_len, int data_file);
+#ifdef USE_THREADS
+void cdda_thread_stop(void);
+#else
+#define cdda_thread_stop()
+#endif
+
+// sound/sndring.c
+PICO_INTERNAL void PsndRingWrite(const short *src, int frames);
+PICO_INTERNAL int  PsndRingAdjust(int len);
+
+// sound/stems.c
+struct psnd_stems {
+  int on;
+  int pos;                      // of the PsndRender() in progress, like buf32
+  int *buf[PSND_STEM_COUNT];    // laid out as PsndBuffer, NULL if not captured
+};
+extern struct psnd_stems psnd_stems;
+
+PICO_INTERNAL void PsndStemsFrameEnd(int length);
 
 void ym2612_sync_timers(int z80_cycles, int mode_old, int mode_new);
 void ym2612_pack_state(void);
 void ym2612_unpack_state(void);
+#ifdef USE_THREADS
+extern int ym2612_thread_on;
+void ym2612_thread_write(int reg, int val, int pos);
+void ym2612_thread_sync(void);
+void ym2612_thread_stop(void);
+#else
+#define ym2612_thread_on 0
+#define ym2612_thread_write(reg, val, pos)
+#define ym2612_thread_sync()
+#define ym2612_thread_stop()
+#endif
 
 #define TIMER_NO_OFLOW 0x70000000
 // tA =   72 * (1024 - NA) / M
@@ -849,6 +918,7 @@ PICO_INTERNAL void z80_pack(void *data);
 PICO_INTERNAL int  z80_unpack(const void *data);
 PICO_INTERNAL void z80_reset(void);
 PICO_INTERNAL void z80_exit(void);
+void z80_idle_hit(unsigned int pc);
 
 // cd/misc.c
 PICO_INTERNAL_ASM void wram_2M_to_1M(unsigned char *m);
@@ -857,7 +927,9 @@ PICO_INTERNAL_ASM void wram_1M_to_2M(unsigned char *m);
 // sound/sound.c
 PICO_INTERNAL void PsndReset(void);
 PICO_INTERNAL void PsndStartFrame(void);
-PICO_INTERNAL void PsndDoDAC(int line_to);
+PICO_INTERNAL int  PsndPos(int line, int cycles);
+PICO_INTERNAL void PsndDoDAC(int pos);
+PICO_INTERNAL void PsndDoFM(int pos);
 PICO_INTERNAL void PsndDoPSG(int line_to);
 PICO_INTERNAL void PsndClear(void);
 PICO_INTERNAL void PsndGetSamples(int y);
@@ -908,6 +980,35 @@ void p32x_event_schedule(unsigned int now, enum p32x_event event, int after);
 void p32x_event_schedule_sh2(SH2 *sh2, enum p32x_event event, int after);
 void p32x_schedule_hint(SH2 *sh2, int m68k_cycles);
 
+// 32x/drccache.c
+#ifdef DRC_SH2
+extern int p32x_drc_warm_pending;
+void p32x_drc_cache_load(void);
+void p32x_drc_cache_warm(void);
+void p32x_drc_cache_save(void);
+#else
+#define p32x_drc_warm_pending 0
+#define p32x_drc_cache_load()
+#define p32x_drc_cache_warm()
+#define p32x_drc_cache_save()
+#endif
+
+// 32x/spec.c
+extern int p32x_spec_active;
+extern int p32x_spec_conflicted;
+int  p32x_spec_begin(void);
+void p32x_spec_commit(void);
+void p32x_spec_rollback(void);
+void p32x_spec_finish(void);
+void p32x_spec_save_page(const void *p);
+void p32x_spec_conflict(SH2 *sh2);
+void p32x_spec_reg_access(SH2 *sh2, unsigned int a, int is_write);
+
+// save a page of sdram/dram before it's written during speculation
+#define p32x_spec_write(p) do { \
+  if (unlikely(p32x_spec_active)) p32x_spec_save_page(p); \
+} while (0)
+
 // 32x/memory.c
 extern struct Pico32xMem *Pico32xMem;
 unsigned int PicoRead8_32x(unsigned int a);
@@ -947,6 +1048,9 @@ void p32x_pwm_schedule_sh2(SH2 *sh2);
 void p32x_pwm_sync_to_sh2(SH2 *sh2);
 void p32x_pwm_irq_event(unsigned int m68k_now);
 void p32x_pwm_state_loaded(void);
+#define P32X_PWM_VARS 6
+void p32x_pwm_save_vars(int *vars);
+void p32x_pwm_load_vars(const int *vars);
 
 // 32x/sh2soc.c
 void p32x_dreq0_trigger(void);
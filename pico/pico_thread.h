@@ -0,0 +1,43 @@
+/*
+ * PicoDrive
+ * thin wrapper for the few threading bits the core uses,
+ * only available when built with USE_THREADS (use_threads=1)
+ *
+ * This work is licensed under the terms of MAME license.
+ * See COPYING file in the top-level directory.
+ */
+
+#ifndef PICO_THREAD_INCLUDED
+#define PICO_THREAD_INCLUDED
+
+#ifdef USE_THREADS
+#include <pthread.h>
+
+typedef pthread_t       pico_thread_t;
+typedef pthread_mutex_t pico_mutex_t;
+typedef pthread_cond_t  pico_cond_t;
+
+static inline int pico_thread_create(pico_thread_t *t,
+  void *(*func)(void *), void *arg)
+{
+  return pthread_create(t, NULL, func, arg);
+}
+
+static inline void pico_thread_join(pico_thread_t t)
+{
+  pthread_join(t, NULL);
+}
+
+#define pico_mutex_init(m)     pthread_mutex_init(m, NULL)
+#define pico_mutex_destroy(m)  pthread_mutex_destroy(m)
+#define pico_mutex_lock(m)     pthread_mutex_lock(m)
+#define pico_mutex_unlock(m)   pthread_mutex_unlock(m)
+#define pico_cond_init(c)      pthread_cond_init(c, NULL)
+#define pico_cond_destroy(c)   pthread_cond_destroy(c)
+#define pico_cond_wait(c, m)   pthread_cond_wait(c, m)
+#define pico_cond_signal(c)    pthread_cond_signal(c)
+#define pico_cond_broadcast(c) pthread_cond_broadcast(c)
+
+#endif // USE_THREADS
+
+#endif // PICO_THREAD_INCLUDED
@@ -168,9 +168,9 @@ void SekStepM68k(void)
   CycloneRun(&PicoCpuCM68k);
   Pico.t.m68c_cnt += 1 - PicoCpuCM68k.cycles;
 #elif defined(EMU_M68K)
-  Pico.t.m68c_cnt += m68k_execute(1);
+  Pico.t.m68c_cnt += m68k_execute(&PicoCpuMM68k, 1);
 #elif defined(EMU_F68K)
-  Pico.t.m68c_cnt += fm68k_emulate(&PicoCpuFM68k, 1, 0);
+  Pico.t.m68c_cnt += SekEmulateF68k(&PicoCpuFM68k, 1);
 #endif
 }
 
@@ -273,24 +273,11 @@ static unsigned short **idledet_ptrs = NULL;
 static int idledet_count = 0, idledet_bads = 0;
 static int idledet_start_frame = 0;
 
-#if 0
-#define IDLE_STATS 1
-unsigned int idlehit_addrs[128], idlehit_counts[128];
-
+// called by the patched branches each time they skip the rest of a timeslice
 void SekRegisterIdleHit(unsigned int pc)
 {
-  int i;
-  for (i = 0; i < 127 && idlehit_addrs[i]; i++) {
-    if (idlehit_addrs[i] == pc) {
-      idlehit_counts[i]++;
-      return;
-    }
-  }
-  idlehit_addrs[i] = pc;
-  idlehit_counts[i] = 1;
-  idlehit_addrs[i+1] = 0;
+  PicoIdleHit(IDLE_M68K, pc & 0xffffff);
 }
-#endif
 
 void SekInitIdleDet(void)
 {
@@ -304,9 +291,6 @@ void SekInitIdleDet(void)
     idledet_ptrs = tmp;
   idledet_count = idledet_bads = 0;
   idledet_start_frame = Pico.m.frame_count + 360;
-#ifdef IDLE_STATS
-  idlehit_addrs[0] = 0;
-#endif
 
 #ifdef EMU_C68K
   CycloneInitIdle();
@@ -440,6 +424,25 @@ void SekFinishIdleDet(void)
   idledet_count = -1;
 }
 
+// Pico.rom was (un)loaded or moved
+void SekRomChanged(void)
+{
+#ifdef EMU_F68K
+  if (Pico.rom == NULL || (PicoIn.AHW & PAHW_SMS))
+    fm68k_predecode_setup(NULL, 0);
+  else
+    fm68k_predecode_setup(Pico.rom, Pico.romsize);
+#endif
+}
+
+// ROM contents were modified at runtime (patches, protection copies)
+void SekRomWritten(unsigned int a, unsigned int size)
+{
+#ifdef EMU_F68K
+  fm68k_predecode_invalidate(a, size);
+#endif
+}
+
 
 #if defined(CPU_CMP_R) || defined(CPU_CMP_W)
 #include "debug.h"
@@ -321,14 +321,14 @@ void PicoFrameMS(void)
     }
 
     // 224 because of how it's done for MD...
-    if (y == 224 && PicoIn.sndOut)
+    if (y == 224)
       PsndGetSamplesMS();
 
     cycles_aim += cycles_line;
     cycles_done += z80_run((cycles_aim - cycles_done) >> 8) << 8;
   }
 
-  if (PicoIn.sndOut && Pico.snd.psg_line < lines)
+  if (Pico.snd.psg_line < lines)
     PsndDoPSG(lines - 1);
 }
 
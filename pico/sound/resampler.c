@@ -0,0 +1,115 @@
+/*
+ * PicoDrive
+ * band-limited resampler for the sources not running at output rate
+ *
+ * This work is licensed under the terms of MAME license.
+ * See COPYING file in the top-level directory.
+ *
+ * CD PCM (~32.5kHz), CDDA (44.1kHz) and 32X PWM (set by the game) used to
+ * be stepped through with nearest neighbour, which aliases badly whenever
+ * the rates don't divide. This is a windowed sinc FIR with a table of
+ * RESAMPLER_PHASES fractional positions. Each call consumes exactly the
+ * src_len frames given and produces 'length' frames from them, the ratio
+ * follows the caller and the filter is remade when it moves off by more
+ * than ~3%. Input and output are interleaved stereo ints, output is
+ * added to dest (left channel only if !stereo, like before).
+ */
+
+#include <string.h>
+#include <math.h>
+#include "resampler.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define COEF_BITS  12 // inputs can be ~17 bits (8 PCM channels), sum must fit
+#define PHASE_BITS 6  // log2(RESAMPLER_PHASES)
+
+static int tmp[(RESAMPLER_TAPS + RESAMPLER_MAX_IN) * 2];
+
+static void make_filter(struct resampler *r, unsigned int step)
+{
+  // cutoff in input sample rate units, below the lower nyquist
+  double fc = 0.5 * 0.9 * (step > 0x10000 ? 65536.0 / step : 1.0);
+  int p, k;
+
+  for (p = 0; p < RESAMPLER_PHASES; p++) {
+    double h[RESAMPLER_TAPS], sum = 0;
+    int isum = 0;
+
+    for (k = 0; k < RESAMPLER_TAPS; k++) {
+      // distance of tap k from the output position
+      double d = k - (RESAMPLER_TAPS / 2 - 1) - (double)p / RESAMPLER_PHASES;
+      double x = 2 * M_PI * d / RESAMPLER_TAPS;
+      double w = 0.42 + 0.5 * cos(x) + 0.08 * cos(2 * x); // blackman
+      h[k] = d == 0 ? 2 * fc : sin(2 * M_PI * fc * d) / (M_PI * d);
+      h[k] *= w;
+      sum += h[k];
+    }
+    // normalize for unity gain at DC
+    for (k = 0; k < RESAMPLER_TAPS; k++) {
+      r->coefs[p][k] = (int)floor(h[k] / sum * (1 << COEF_BITS) + 0.5);
+      isum += r->coefs[p][k];
+    }
+    r->coefs[p][RESAMPLER_TAPS / 2 - 1] += (1 << COEF_BITS) - isum;
+  }
+  r->step = step;
+}
+
+void resampler_reset(struct resampler *r)
+{
+  memset(r->hist, 0, sizeof(r->hist));
+}
+
+void resampler_run(struct resampler *r, int *dest, int length, int stereo,
+  const int *src, int src_len)
+{
+  unsigned int step, pos;
+  int i, k;
+
+  if (length <= 0 || src_len <= 0)
+    return;
+  if (src_len > RESAMPLER_MAX_IN)
+    src_len = RESAMPLER_MAX_IN;
+
+  memcpy(tmp, r->hist, sizeof(r->hist));
+  memcpy(tmp + RESAMPLER_TAPS * 2, src, src_len * 2 * sizeof(tmp[0]));
+  memcpy(r->hist, tmp + src_len * 2, sizeof(r->hist));
+
+  if (src_len == length) {
+    // nothing to do, but keep the filter delay so that switching is clean
+    const int *s = tmp + (RESAMPLER_TAPS / 2 - 1) * 2;
+    if (stereo)
+      for (i = 0; i < length * 2; i++)
+        dest[i] += s[i];
+    else
+      for (i = 0; i < length; i++)
+        dest[i] += s[i * 2];
+    return;
+  }
+
+  step = ((unsigned int)src_len << 16) / length;
+  if (r->step == 0 || step > r->step + r->step / 32
+      || step < r->step - r->step / 32)
+    make_filter(r, step);
+
+  for (i = 0, pos = 0; i < length; i++, pos += step) {
+    const short *c = r->coefs[(pos >> (16 - PHASE_BITS)) & (RESAMPLER_PHASES - 1)];
+    const int *s = tmp + (pos >> 16) * 2;
+    int l = 0, rr = 0;
+
+    for (k = 0; k < RESAMPLER_TAPS; k++) {
+      l  += s[k * 2]     * c[k];
+      rr += s[k * 2 + 1] * c[k];
+    }
+    if (stereo) {
+      *dest++ += l  >> COEF_BITS;
+      *dest++ += rr >> COEF_BITS;
+    }
+    else
+      *dest++ += l >> COEF_BITS;
+  }
+}
+
+// vim:shiftwidth=2:ts=2:expandtab
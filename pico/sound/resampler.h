@@ -0,0 +1,18 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#define RESAMPLER_TAPS    32
+#define RESAMPLER_PHASES  64
+#define RESAMPLER_MAX_IN  2048 // input frames per call
+
+struct resampler {
+  unsigned int step;            // input per output frame (16.16) the filter is made for
+  int hist[RESAMPLER_TAPS * 2]; // last input frames, stereo
+  short coefs[RESAMPLER_PHASES][RESAMPLER_TAPS];
+};
+
+void resampler_reset(struct resampler *r);
+void resampler_run(struct resampler *r, int *dest, int length, int stereo,
+  const int *src, int src_len);
+
+#endif
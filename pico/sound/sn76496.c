@@ -20,6 +20,7 @@
 #pragma warning (disable:4244)
 #endif
 
+#include <string.h>
 #include "sn76496.h"
 
 #define MAX_OUTPUT 0x47ff // was 0x7fff
@@ -132,96 +133,191 @@ WRITE8_HANDLER( SN76496_3_w ) {	SN76496Write(3,data); }
 WRITE8_HANDLER( SN76496_4_w ) {	SN76496Write(4,data); }
 */
 
-//static
-void SN76496Update(short *buffer, int length, int stereo)
+/*
+  Output is rendered edge by edge instead of sample by sample. Between two
+  transitions of a square wave (or noise shifts) the channel output is
+  constant, so for each edge only the level change is recorded: the part of
+  the sample after the edge goes to part[], and lvl[] carries it into the
+  following samples. A running sum over lvl[] then gives each sample's
+  integral of the output, which is the same box filter as the old per
+  sample loop, without having to visit every sample for every channel.
+*/
+#define CHUNK 256
+
+static int lvl[CHUNK + 1];	/* level change from this sample on */
+static int part[CHUNK + 1];	/* level change within the sample, weighted */
+static int sum[CHUNK];		/* all channels, when rendering them apart */
+
+int **sn76496_chan_out;
+
+/* add the edges of channel c in the next n samples, returns its starting level */
+static int SN76496Edges(struct SN76496 *R, int c, int n)
 {
-	int i;
-	struct SN76496 *R = &ono_sn;
+	int end = n * STEP;
+	int vol = R->Volume[c];
+	int out = R->Output[c];
+	int start = out ? vol : 0;
+	int t = R->Count[c];
 
-	/* If the volume is 0, increase the counter */
-	for (i = 0;i < 4;i++)
+	while (t <= end)
 	{
-		if (R->Volume[i] == 0)
+		int o, k;
+
+		if (c < 3)
+			o = out ^ 1;
+		else
 		{
-			/* note that I do count += length, NOT count = length + 1. You might think */
-			/* it's the same since the volume is 0, but doing the latter could cause */
-			/* interferencies when the program is rapidly modulating the volume. */
-			if (R->Count[i] <= length*STEP) R->Count[i] += length*STEP;
+			if (R->RNG & 1) R->RNG ^= R->NoiseFB;
+			R->RNG >>= 1;
+			o = R->RNG & 1;
+		}
+		if (o != out)
+		{
+			int dv = o ? vol : -vol;
+			k = t >> 16;
+			if (k < n)
+			{
+				part[k] += dv * (STEP - (t & (STEP - 1)));
+				lvl[k + 1] += dv;
+			}
+			out = o;
 		}
+		t += R->Period[c];
 	}
 
-	while (length > 0)
-	{
-		int vol[4];
-		unsigned int out;
-		int left;
+	R->Count[c] = t - end;
+	R->Output[c] = out;
+	return start;
+}
+
+/* as below, but each channel is also left in sn76496_chan_out */
+static void SN76496UpdateApart(struct SN76496 *R, short *buffer, int length, int stereo, int active)
+{
+	int *out[4];
+	int i, k, n, level;
 
+	for (i = 0;i < 4;i++)
+		out[i] = sn76496_chan_out[i];
 
-		/* vol[] keeps track of how long each square wave stays */
-		/* in the 1 position during the sample period. */
-		vol[0] = vol[1] = vol[2] = vol[3] = 0;
+	for (; length > 0; length -= n)
+	{
+		n = length < CHUNK ? length : CHUNK;
+		memset(sum, 0, n * sizeof(sum[0]));
 
-		for (i = 0;i < 3;i++)
+		for (i = 0;i < 4;i++)
 		{
-			if (R->Output[i]) vol[i] += R->Count[i];
-			R->Count[i] -= STEP;
-			/* Period[i] is the half period of the square wave. Here, in each */
-			/* loop I add Period[i] twice, so that at the end of the loop the */
-			/* square wave is in the same status (0 or 1) it was at the start. */
-			/* vol[i] is also incremented by Period[i], since the wave has been 1 */
-			/* exactly half of the time, regardless of the initial position. */
-			/* If we exit the loop in the middle, Output[i] has to be inverted */
-			/* and vol[i] incremented only if the exit status of the square */
-			/* wave is 1. */
-			while (R->Count[i] <= 0)
+			if (!(active & (1 << i)))
+				continue;
+			memset(lvl, 0, (n + 1) * sizeof(lvl[0]));
+			memset(part, 0, n * sizeof(part[0]));
+
+			level = SN76496Edges(R, i, n);
+			for (k = 0; k < n; k++)
 			{
-				R->Count[i] += R->Period[i];
-				if (R->Count[i] > 0)
-				{
-					R->Output[i] ^= 1;
-					if (R->Output[i]) vol[i] += R->Period[i];
-					break;
-				}
-				R->Count[i] += R->Period[i];
-				vol[i] += R->Period[i];
+				int v;
+
+				level += lvl[k];
+				v = level * STEP + part[k];
+				sum[k] += v;
+				if (out[i] != NULL)
+					out[i][k << stereo] += v / STEP;
 			}
-			if (R->Output[i]) vol[i] -= R->Count[i];
 		}
 
-		left = STEP;
-		do
+		for (k = 0; k < n; k++)
 		{
-			int nextevent;
+			unsigned int o = sum[k];
+			if (o > MAX_OUTPUT * STEP) o = MAX_OUTPUT * STEP;
+			buffer[k << stereo] += o / STEP;
+		}
 
-			if (R->Count[3] < left) nextevent = R->Count[3];
-			else nextevent = left;
+		buffer += n << stereo;
+		for (i = 0;i < 4;i++)
+			if (out[i] != NULL)
+				out[i] += n << stereo;
+	}
+}
 
-			if (R->Output[3]) vol[3] += R->Count[3];
-			R->Count[3] -= nextevent;
-			if (R->Count[3] <= 0)
-			{
-				if (R->RNG & 1) R->RNG ^= R->NoiseFB;
-				R->RNG >>= 1;
-				R->Output[3] = R->RNG & 1;
-				R->Count[3] += R->Period[3];
-				if (R->Output[3]) vol[3] += R->Period[3];
-			}
-			if (R->Output[3]) vol[3] -= R->Count[3];
+//static
+void SN76496Update(short *buffer, int length, int stereo)
+{
+	struct SN76496 *R = &ono_sn;
+	int i, k, n, level, active = 0;
+
+	/* Silent channels are frozen, keeping their phase. Note that it is */
+	/* count += length, NOT count = length + 1, so that rapidly modulating */
+	/* the volume doesn't cause interferences. */
+	for (i = 0;i < 4;i++)
+	{
+		if (R->Volume[i] == 0)
+		{
+			if (R->Count[i] > length*STEP) R->Count[i] -= length*STEP;
+		}
+		else
+			active |= 1 << i;
+	}
+	if (!active)
+		return;
+	if (sn76496_chan_out != NULL)
+	{
+		SN76496UpdateApart(R, buffer, length, stereo, active);
+		return;
+	}
+
+	for (; length > 0; length -= n)
+	{
+		n = length < CHUNK ? length : CHUNK;
+		memset(lvl, 0, (n + 1) * sizeof(lvl[0]));
+		memset(part, 0, n * sizeof(part[0]));
+
+		level = 0;
+		for (i = 0;i < 4;i++)
+			if (active & (1 << i))
+				level += SN76496Edges(R, i, n);
 
-			left -= nextevent;
-		} while (left > 0);
+		for (k = 0; k < n; k++)
+		{
+			unsigned int out;
+
+			level += lvl[k];
+			out = level * STEP + part[k];
+			if (out > MAX_OUTPUT * STEP) out = MAX_OUTPUT * STEP;
 
-		out = vol[0] * R->Volume[0] + vol[1] * R->Volume[1] +
-				vol[2] * R->Volume[2] + vol[3] * R->Volume[3];
+			if ((out /= STEP)) // will be optimized to shift; max 0x47ff = 18431
+				*buffer += out;
+			if(stereo) buffer+=2; // only left for stereo, to be mixed to right later
+			else buffer++;
+		}
+	}
+}
 
-		if (out > MAX_OUTPUT * STEP) out = MAX_OUTPUT * STEP;
 
-		if ((out /= STEP)) // will be optimized to shift; max 0x47ff = 18431
-			*buffer += out;
-		if(stereo) buffer+=2; // only left for stereo, to be mixed to right later
-		else buffer++;
+/* move the chip 'length' samples on without rendering them, for when the */
+/* sound isn't used. The square waves keep their phase, the noise only its */
+/* counter, its shift register isn't stepped (the sequence isn't heard). */
+void SN76496Skip(int length)
+{
+	struct SN76496 *R = &ono_sn;
+	int i;
 
-		length--;
+	for (; length > 0; length -= 0x4000)
+	{
+		unsigned int d = (length < 0x4000 ? length : 0x4000) * STEP;
+
+		for (i = 0;i < 4;i++)
+		{
+			unsigned int t = R->Count[i];
+
+			if (t > d)
+				R->Count[i] = t - d;
+			else if (R->Period[i] > 0)
+			{
+				unsigned int edges = 1 + (d - t) / R->Period[i];
+				R->Count[i] = R->Period[i] - (d - t) % R->Period[i];
+				if (i < 3)
+					R->Output[i] ^= edges & 1;
+			}
+		}
 	}
 }
 
@@ -3,6 +3,10 @@
 
 void SN76496Write(int data);
 void SN76496Update(short *buffer,int length,int stereo);
+void SN76496Skip(int length);
 int  SN76496_init(int clock,int sample_rate);
 
+/* when set, each channel is also left in its own buffer (NULL: skipped) */
+extern int **sn76496_chan_out;
+
 #endif
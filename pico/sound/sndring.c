@@ -0,0 +1,178 @@
+/*
+ * PicoDrive
+ * audio output ring with rate control
+ *
+ * This work is licensed under the terms of MAME license.
+ * See COPYING file in the top-level directory.
+ *
+ * For frontends where the host pulls audio from a thread (or callback) of
+ * its own. Once started, the samples of every emulated frame go in here,
+ * besides .writeSound, and the host takes them out with PsndRingRead().
+ * There is one writer (emulation) and one reader (audio), so no locks are
+ * needed, each side only moves its own index.
+ * The host's audio clock never quite matches the emulated frame rate, so
+ * PsndStartFrame() asks for slightly more or fewer samples per frame (up
+ * to 1/PSND_RATE_ADJ, not audible) to keep the fill level around the
+ * target latency. The reader plays silence until the ring first fills up
+ * to the target, and again after running dry.
+ */
+
+#include <string.h>
+#include "../pico_int.h"
+
+#if defined(__GNUC__) && (__GNUC__ * 100 + __GNUC_MINOR__) >= 407
+#define ring_load(p)     __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define ring_store(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#elif defined(__GNUC__)
+static inline unsigned int ring_load(volatile unsigned int *p)
+{
+  unsigned int v = *p;
+  __sync_synchronize();
+  return v;
+}
+static inline void ring_store(volatile unsigned int *p, unsigned int v)
+{
+  __sync_synchronize();
+  *p = v;
+}
+#else
+// msvc volatile accesses have acquire/release semantics
+#define ring_load(p)     (*(volatile unsigned int *)(p))
+#define ring_store(p, v) (*(volatile unsigned int *)(p) = (v))
+#endif
+
+static struct {
+  short *buf;
+  unsigned int size;    // frames, power of 2
+  unsigned int head;    // frames written, moved by the emulation side
+  unsigned int tail;    // frames read, moved by the audio side
+  int stereo;
+  int rate;
+  int target;           // fill level to keep, frames
+  int primed;           // audio side, filled up to the target
+  unsigned int underruns;
+} ring;
+
+// must not be called while the audio side may be reading
+int PsndRingStart(int latency_ms)
+{
+  int stereo = (PicoIn.opt & POPT_EN_STEREO) ? 1 : 0;
+  unsigned int size;
+
+  PsndRingStop();
+
+  ring.target = PicoIn.sndRate * latency_ms / 1000;
+  if (ring.target < PSND_MAX_LEN / 4)
+    ring.target = PSND_MAX_LEN / 4;
+  for (size = 1; size < ring.target * 2 + PSND_MAX_LEN; size <<= 1)
+    ;
+
+  ring.buf = calloc(size, 2 << stereo);
+  if (ring.buf == NULL)
+    return -1;
+  ring.size = size;
+  ring.head = ring.tail = 0;
+  ring.stereo = stereo;
+  ring.rate = PicoIn.sndRate;
+  ring.primed = 0;
+  ring.underruns = 0;
+  return 0;
+}
+
+void PsndRingStop(void)
+{
+  free(ring.buf);
+  ring.buf = NULL;
+}
+
+// frames buffered, either side may ask
+int PsndRingFill(void)
+{
+  if (ring.buf == NULL)
+    return 0;
+  return ring_load(&ring.head) - ring_load(&ring.tail);
+}
+
+unsigned int PsndRingUnderruns(void)
+{
+  return ring.underruns;
+}
+
+// audio side, returns frames taken, the rest of dest is silence
+int PsndRingRead(short *dest, int frames)
+{
+  unsigned int head, tail, t;
+  int n, len, sh = ring.stereo;
+
+  if (ring.buf == NULL) {
+    memset(dest, 0, frames * ((PicoIn.opt & POPT_EN_STEREO) ? 4 : 2));
+    return 0;
+  }
+
+  head = ring_load(&ring.head);
+  tail = ring.tail;
+  if (!ring.primed && head - tail >= ring.target)
+    ring.primed = 1;
+
+  len = ring.primed ? head - tail : 0;
+  if (len < frames) {
+    if (ring.primed) {
+      ring.underruns++;
+      ring.primed = 0;
+    }
+    memset(dest + (len << sh), 0, (frames - len) << (sh + 1));
+  }
+  else
+    len = frames;
+
+  t = tail & (ring.size - 1);
+  n = ring.size - t < len ? ring.size - t : len;
+  memcpy(dest, ring.buf + (t << sh), n << (sh + 1));
+  memcpy(dest + (n << sh), ring.buf, (len - n) << (sh + 1));
+  ring_store(&ring.tail, tail + len);
+  return len;
+}
+
+// emulation side, at the end of each frame
+PICO_INTERNAL void PsndRingWrite(const short *src, int frames)
+{
+  unsigned int head, tail, h;
+  int n, sh = ring.stereo;
+
+  // restarted with the new rate/channels when those change
+  if (ring.buf == NULL || src == NULL || ring.rate != PicoIn.sndRate
+      || ring.stereo != ((PicoIn.opt & POPT_EN_STEREO) ? 1 : 0))
+    return;
+
+  head = ring.head;
+  tail = ring_load(&ring.tail);
+  if (frames > ring.size - (head - tail))
+    frames = ring.size - (head - tail); // reader stalled, drop
+
+  h = head & (ring.size - 1);
+  n = ring.size - h < frames ? ring.size - h : frames;
+  memcpy(ring.buf + (h << sh), src, n << (sh + 1));
+  memcpy(ring.buf, src + (n << sh), (frames - n) << (sh + 1));
+  ring_store(&ring.head, head + frames);
+}
+
+// length change for the next frame in 16.16 samples, to move the fill
+// level towards the target, at most len/PSND_RATE_ADJ when off by half of
+// it. Shrinking is also limited by the last line's share of the frame,
+// which PsndStartFrame() enforces, so PSND_RATE_ADJ must stay above that.
+PICO_INTERNAL int PsndRingAdjust(int len)
+{
+  int d, max = ring.target / 2;
+
+  if (ring.buf == NULL)
+    return 0;
+
+  d = ring.target - (int)(ring.head - ring_load(&ring.tail));
+  if (d > max)
+    d = max;
+  else if (d < -max)
+    d = -max;
+  return (long long)d * (len << 16) / ((long long)max * PSND_RATE_ADJ);
+}
+
+// vim:shiftwidth=2:ts=2:expandtab
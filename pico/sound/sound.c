@@ -11,23 +11,73 @@
 #include "ym2612.h"
 #include "sn76496.h"
 #include "../pico_int.h"
+#include "../pico_thread.h"
 #include "../cd/cue.h"
 #include "mix.h"
+#include "resampler.h"
 
 void (*PsndMix_32_to_16l)(short *dest, int *src, int count) = mix_32_to_16l_stereo;
 
 // master int buffer to mix to
-static int PsndBuffer[2*(44100+100)/50];
+static int PsndBuffer[2*PSND_MAX_LEN];
 
 // dac, psg
 static unsigned short dac_info[312+4]; // pos in sample buffer
 
+// FM in PsndBuffer is rendered up to here, advanced on register writes
+static int fm_pos;
+
+// sources not heard in the last frame (POPT_EN_*)
+static int snd_off;
+
 // cdda output buffer
 short cdda_out_buffer[2*1152];
 
+// cdda at 44.1kHz, before resampling
+static int cdda_buffer[2*1152];
+static struct resampler cdda_rs;
+static unsigned int cdda_frac;
+
 // sn76496
 extern int *sn76496_regs;
 
+#ifdef USE_THREADS
+/*
+ * FM may be synthesized on another thread (POPT_EN_SND_THREAD). Register
+ * writes are queued with the sample position they were done at, the
+ * thread renders up to that position and then applies the write, the same
+ * as PsndDoFM() does on the emulation thread. This way it keeps up with
+ * the frame and is only waited for when the samples get mixed. Timer, DAC
+ * and address registers are still handled on the emulation side, the
+ * thread keeps its own copy of the mode and DAC enable bits that affect
+ * synthesis (queued as writes to 0x27 and 0x2b).
+ */
+#define FMQ_SIZE 0x1000 // power of 2
+
+struct fm_write {
+  unsigned short pos;
+  unsigned short reg;
+  unsigned char  val;
+};
+
+static struct {
+  pico_thread_t thread;
+  pico_mutex_t mutex;
+  pico_cond_t cond;
+  struct fm_write q[FMQ_SIZE];
+  unsigned int q_head, q_tail; // pushed by emu side, applied by the thread
+  int rendered;                // samples done in this frame
+  int target;                  // samples the mixer wants
+  int active_chs;
+  int stereo, mode, dacen;
+  int quit;
+} fm_thr;
+
+static int fm_buffer[2*PSND_MAX_LEN];
+
+int ym2612_thread_on;
+#endif
+
 
 static void dac_recalculate(void)
 {
@@ -81,6 +131,181 @@ static void dac_recalculate(void)
 }
 
 
+#ifdef USE_THREADS
+// called without the lock, only the thread touches the chip
+static int fm_thread_render(int from, int to)
+{
+  int max = sizeof(fm_buffer) / sizeof(fm_buffer[0]) >> fm_thr.stereo;
+
+  if (to > max)
+    to = max;
+  if (to <= from)
+    return from;
+
+  fm_thr.active_chs |= YM2612UpdateOneEx_(fm_buffer + (from << fm_thr.stereo),
+    to - from, fm_thr.stereo, 1, fm_thr.mode, fm_thr.dacen);
+  return to;
+}
+
+static void *fm_thread(void *arg)
+{
+  struct fm_write *w;
+  unsigned int head, tail;
+  int rendered, target;
+
+  pico_mutex_lock(&fm_thr.mutex);
+  while (!fm_thr.quit) {
+    head = fm_thr.q_head;
+    tail = fm_thr.q_tail;
+    rendered = fm_thr.rendered;
+    target = fm_thr.target;
+    if (head == tail && rendered >= target) {
+      pico_cond_wait(&fm_thr.cond, &fm_thr.mutex);
+      continue;
+    }
+    pico_mutex_unlock(&fm_thr.mutex);
+
+    for (; tail != head; tail++) {
+      w = &fm_thr.q[tail & (FMQ_SIZE - 1)];
+      rendered = fm_thread_render(rendered, w->pos);
+      if (w->reg == 0x27)
+        fm_thr.mode = w->val;
+      else if (w->reg == 0x2b)
+        fm_thr.dacen = w->val & 0x80;
+      else
+        YM2612WriteReg_(w->reg, w->val);
+    }
+    rendered = fm_thread_render(rendered, target);
+
+    pico_mutex_lock(&fm_thr.mutex);
+    fm_thr.q_tail = tail;
+    fm_thr.rendered = rendered;
+    pico_cond_broadcast(&fm_thr.cond);
+  }
+  pico_mutex_unlock(&fm_thr.mutex);
+
+  return NULL;
+}
+
+static void fm_thread_start(void)
+{
+  fm_thr.q_head = fm_thr.q_tail = 0;
+  fm_thr.rendered = fm_thr.target = 0;
+  fm_thr.active_chs = 0;
+  fm_thr.stereo = (PicoIn.opt & POPT_EN_STEREO) ? 1 : 0;
+  fm_thr.mode = ym2612.OPN.ST.mode;
+  fm_thr.dacen = ym2612.dacen;
+  fm_thr.quit = 0;
+
+  pico_mutex_init(&fm_thr.mutex);
+  pico_cond_init(&fm_thr.cond);
+  if (pico_thread_create(&fm_thr.thread, fm_thread, NULL) != 0) {
+    elprintf(EL_STATUS, "sound: can't create FM thread");
+    pico_cond_destroy(&fm_thr.cond);
+    pico_mutex_destroy(&fm_thr.mutex);
+    PicoIn.opt &= ~POPT_EN_SND_THREAD;
+    return;
+  }
+  ym2612_thread_on = 1;
+}
+
+// wait until all queued writes are applied and 'to' samples are rendered
+static void fm_thread_wait(int to)
+{
+  pico_mutex_lock(&fm_thr.mutex);
+  if (fm_thr.target < to) {
+    fm_thr.target = to;
+    pico_cond_broadcast(&fm_thr.cond);
+  }
+  while (fm_thr.q_head != fm_thr.q_tail || fm_thr.rendered < to)
+    pico_cond_wait(&fm_thr.cond, &fm_thr.mutex);
+  pico_mutex_unlock(&fm_thr.mutex);
+}
+
+void ym2612_thread_write(int reg, int val, int pos)
+{
+  struct fm_write *w;
+
+  pico_mutex_lock(&fm_thr.mutex);
+  while (fm_thr.q_head - fm_thr.q_tail >= FMQ_SIZE)
+    pico_cond_wait(&fm_thr.cond, &fm_thr.mutex);
+  w = &fm_thr.q[fm_thr.q_head & (FMQ_SIZE - 1)];
+  w->pos = pos;
+  w->reg = reg;
+  w->val = val;
+  fm_thr.q_head++;
+  pico_cond_broadcast(&fm_thr.cond);
+  pico_mutex_unlock(&fm_thr.mutex);
+}
+
+// before the chip state is accessed directly
+void ym2612_thread_sync(void)
+{
+  if (ym2612_thread_on)
+    fm_thread_wait(0);
+}
+
+void ym2612_thread_stop(void)
+{
+  if (!ym2612_thread_on)
+    return;
+
+  fm_thread_wait(0);
+  pico_mutex_lock(&fm_thr.mutex);
+  fm_thr.quit = 1;
+  pico_cond_broadcast(&fm_thr.cond);
+  pico_mutex_unlock(&fm_thr.mutex);
+  pico_thread_join(fm_thr.thread);
+
+  pico_cond_destroy(&fm_thr.cond);
+  pico_mutex_destroy(&fm_thr.mutex);
+  ym2612_thread_on = 0;
+}
+
+static int fm_thread_get(int *buffer, int offset, int length)
+{
+  fm_thread_wait(offset + length);
+  memcpy(buffer, fm_buffer + (offset << fm_thr.stereo),
+    length << (fm_thr.stereo + 2));
+  return fm_thr.active_chs;
+}
+
+// a new frame of samples begins, the thread is idle here
+static void fm_thread_frame_end(void)
+{
+  int stereo = (PicoIn.opt & POPT_EN_STEREO) ? 1 : 0;
+
+  // stems need the channels rendered apart, that's only done serially
+  if (ym2612_thread_on && (!(PicoIn.opt & POPT_EN_SND_THREAD)
+      || !(PicoIn.opt & POPT_EN_FM) || fm_thr.stereo != stereo
+      || psnd_stems.on))
+    ym2612_thread_stop();
+
+  if (ym2612_thread_on) {
+    pico_mutex_lock(&fm_thr.mutex);
+    fm_thr.rendered = fm_thr.target = 0;
+    fm_thr.active_chs = 0;
+    pico_mutex_unlock(&fm_thr.mutex);
+  }
+  else if ((PicoIn.opt & (POPT_EN_SND_THREAD|POPT_EN_FM)) == (POPT_EN_SND_THREAD|POPT_EN_FM)
+      && !psnd_stems.on)
+    fm_thread_start();
+}
+
+// FM isn't heard anymore, the chip is moved on serially from where it is
+static void fm_thread_mute(void)
+{
+  if (!ym2612_thread_on)
+    return;
+  ym2612_thread_stop();
+  fm_pos = fm_thr.rendered;
+}
+#else
+#define fm_thread_get(buffer, offset, length) 0
+#define fm_thread_frame_end()
+#define fm_thread_mute()
+#endif
+
 PICO_INTERNAL void PsndReset(void)
 {
   // PsndRerate calls YM2612Init, which also resets
@@ -95,6 +320,12 @@ void PsndRerate(int preserve_state)
   void *state = NULL;
   int target_fps = Pico.m.pal ? 50 : 60;
 
+  pcd_s68k_wait();
+  ym2612_thread_stop();
+
+  if (PicoIn.sndRate > PSND_MAX_RATE)
+    PicoIn.sndRate = PSND_MAX_RATE;
+
   if (preserve_state) {
     state = malloc(0x204);
     if (state == NULL) return;
@@ -119,6 +350,7 @@ void PsndRerate(int preserve_state)
   Pico.snd.len = PicoIn.sndRate / target_fps;
   Pico.snd.len_e_add = ((PicoIn.sndRate - Pico.snd.len * target_fps) << 16) / target_fps;
   Pico.snd.len_e_cnt = 0;
+  Pico.snd.len_use = Pico.snd.len;
 
   // recalculate dac info
   dac_recalculate();
@@ -126,6 +358,9 @@ void PsndRerate(int preserve_state)
   // clear all buffers
   memset32(PsndBuffer, 0, sizeof(PsndBuffer)/4);
   memset(cdda_out_buffer, 0, sizeof(cdda_out_buffer));
+  resampler_reset(&cdda_rs);
+  cdda_frac = 0;
+  Pico.snd.dac_pos = fm_pos = 0;
   if (PicoIn.sndOut)
     PsndClear();
 
@@ -139,37 +374,89 @@ void PsndRerate(int preserve_state)
 
 PICO_INTERNAL void PsndStartFrame(void)
 {
-  // compensate for float part of Pico.snd.len
-  Pico.snd.len_use = Pico.snd.len;
-  Pico.snd.len_e_cnt += Pico.snd.len_e_add;
-  if (Pico.snd.len_e_cnt >= 0x10000) {
-    Pico.snd.len_e_cnt -= 0x10000;
-    Pico.snd.len_use++;
-  }
+  int off = POPT_EN_FM|POPT_EN_PSG|POPT_EN_MCD_CDDA;
 
-  Pico.snd.dac_line = Pico.snd.psg_line = 0;
+  // Sources that aren't heard (no sndOut or disabled) aren't synthesized,
+  // PsndDoFM/PsndDoPSG only move the chips on to where the output would be.
+  if (PicoIn.sndOut)
+    off &= ~PicoIn.opt;
+  if ((snd_off & ~off & POPT_EN_MCD_CDDA) && (PicoIn.AHW & PAHW_MCD))
+    cdd_resync_audio();
+  if (off & POPT_EN_FM)
+    fm_thread_mute();
+  if (!PicoIn.sndOut && (PicoIn.AHW & PAHW_MCD))
+    pcd_pcm_sync(SekCyclesDoneS68k()); // only moves the channels
+  snd_off = off;
+
+  // compensate for float part of Pico.snd.len, and steer the output ring
+  Pico.snd.len_e_cnt += Pico.snd.len_e_add + PsndRingAdjust(Pico.snd.len);
+  Pico.snd.len_use = Pico.snd.len + (Pico.snd.len_e_cnt >> 16);
+  Pico.snd.len_e_cnt &= 0xffff;
+  if (Pico.snd.len_use < dac_info[223])
+    Pico.snd.len_use = dac_info[223];
+
+  Pico.snd.psg_line = 0;
   Pico.m.status &= ~1;
   dac_info[224] = Pico.snd.len_use;
 }
 
-PICO_INTERNAL void PsndDoDAC(int line_to)
+// stems of channels first..first+count-1 at 'pos', for the chip cores
+static int **stems_at(int first, int count, int pos)
 {
-  int pos, pos1, len;
-  int dout = ym2612.dacout;
-  int line_from = Pico.snd.dac_line;
+  static int *p[6];
+  int i;
 
-  if (line_to >= 313)
-    line_to = 312;
+  for (i = 0; i < count; i++)
+    p[i] = psnd_stems.buf[first + i] ? psnd_stems.buf[first + i] + pos : NULL;
+  return p;
+}
+
+// stem to render a source to instead of buf32 (and add from), or NULL
+static int *stem_buf(int id, int pos)
+{
+  if (!psnd_stems.on || psnd_stems.buf[id] == NULL)
+    return NULL;
+  return psnd_stems.buf[id] + pos;
+}
+
+static void stem_add(int *dest, const int *src, int count)
+{
+  for (; count > 0; count--)
+    *dest++ += *src++;
+}
+
+// sample position of the point 'cycles' 68k cycles into 'line'
+PICO_INTERNAL int PsndPos(int line, int cycles)
+{
+  int pos, pos1;
+
+  if (line >= 313)
+    line = 312;
+  if (cycles < 0)
+    cycles = 0;
+  else if (cycles > 488)
+    cycles = 488;
+
+  pos  = dac_info[line];
+  pos1 = dac_info[line + 1];
+  if (pos1 <= pos) // sound frame boundary, z80 may be a bit past it
+    return pos;
+  return pos + (pos1 - pos) * cycles / 488;
+}
+
+// output the DAC up to 'pos', done before it changes
+PICO_INTERNAL void PsndDoDAC(int pos1)
+{
+  int pos = Pico.snd.dac_pos;
+  int dout = ym2612.dacout;
+  int len = pos1 - pos;
 
-  pos  = dac_info[line_from];
-  pos1 = dac_info[line_to + 1];
-  len = pos1 - pos;
   if (len <= 0)
     return;
 
-  Pico.snd.dac_line = line_to + 1;
+  Pico.snd.dac_pos = pos1;
 
-  if (!PicoIn.sndOut)
+  if (!PicoIn.sndOut || !ym2612.dacen)
     return;
 
   if (PicoIn.opt & POPT_EN_STEREO) {
@@ -179,6 +466,12 @@ PICO_INTERNAL void PsndDoDAC(int line_to)
     short *d = PicoIn.sndOut + pos;
     for (; len > 0; len--, d++)  *d += dout;
   }
+
+  if (psnd_stems.on && psnd_stems.buf[PSND_STEM_DAC] != NULL) {
+    int stereo = (PicoIn.opt & POPT_EN_STEREO) ? 1 : 0;
+    int *s = psnd_stems.buf[PSND_STEM_DAC] + (pos << stereo);
+    for (len = pos1 - pos; len > 0; len--, s += 1 << stereo) *s += dout;
+  }
 }
 
 PICO_INTERNAL void PsndDoPSG(int line_to)
@@ -200,67 +493,283 @@ PICO_INTERNAL void PsndDoPSG(int line_to)
 
   Pico.snd.psg_line = line_to + 1;
 
-  if (!PicoIn.sndOut || !(PicoIn.opt & POPT_EN_PSG))
+  if (!PicoIn.sndOut || !(PicoIn.opt & POPT_EN_PSG)) {
+    SN76496Skip(len); // not heard, keep the chip in time
     return;
+  }
 
   if (PicoIn.opt & POPT_EN_STEREO) {
     stereo = 1;
     pos <<= 1;
   }
+  if (psnd_stems.on)
+    sn76496_chan_out = stems_at(PSND_STEM_PSG1, 4, pos);
   SN76496Update(PicoIn.sndOut + pos, len, stereo);
+  sn76496_chan_out = NULL;
+}
+
+// render FM up to 'pos', done before a register write changes it
+PICO_INTERNAL void PsndDoFM(int pos)
+{
+  int stereo = (PicoIn.opt & POPT_EN_STEREO) ? 1 : 0;
+  int len;
+
+  if (pos > (sizeof(PsndBuffer) / sizeof(PsndBuffer[0]) >> stereo))
+    pos = sizeof(PsndBuffer) / sizeof(PsndBuffer[0]) >> stereo;
+  len = pos - fm_pos;
+  if (len <= 0)
+    return;
+
+  if (!PicoIn.sndOut || !(PicoIn.opt & POPT_EN_FM)) {
+    YM2612SkipSamples(len); // not heard, keep the chip in time
+    fm_pos = pos;
+    return;
+  }
+
+  if (psnd_stems.on)
+    ym2612_chan_out = stems_at(PSND_STEM_FM1, 6, fm_pos << stereo);
+  YM2612UpdateOne(PsndBuffer + (fm_pos << stereo), len, stereo, 1);
+  ym2612_chan_out = NULL;
+  fm_pos = pos;
 }
 
 // cdda
-static void cdda_raw_update(int *buffer, int length)
+// returns 0 at the end of the file
+static int cdda_raw_update(void *stream, int *buffer, int length)
 {
-  int ret, cdda_bytes, mult = 1;
+  int ret, cdda_bytes;
 
   cdda_bytes = length*4;
-  if (PicoIn.sndRate <= 22050 + 100) mult = 2;
-  if (PicoIn.sndRate <  22050 - 100) mult = 4;
-  cdda_bytes *= mult;
 
-  ret = pm_read(cdda_out_buffer, cdda_bytes, Pico_mcd->cdda_stream);
-  if (ret < cdda_bytes) {
+  ret = pm_read(cdda_out_buffer, cdda_bytes, stream);
+  if (ret < cdda_bytes)
     memset((char *)cdda_out_buffer + ret, 0, cdda_bytes - ret);
-    Pico_mcd->cdda_stream = NULL;
-    return;
-  }
 
   // now mix
-  switch (mult) {
-    case 1: mix_16h_to_32(buffer, cdda_out_buffer, length*2); break;
-    case 2: mix_16h_to_32_s1(buffer, cdda_out_buffer, length*2); break;
-    case 4: mix_16h_to_32_s2(buffer, cdda_out_buffer, length*2); break;
-  }
+  mix_16h_to_32(buffer, cdda_out_buffer, length*2);
+  return ret == cdda_bytes;
 }
 
-void cdda_start_play(int lba_base, int lba_offset, int lb_len)
+static void cdda_seek(void *stream, int type, int lba_base, int lba_offset, int lb_len)
 {
-  if (Pico_mcd->cdda_type == CT_MP3)
+  if (type == CT_MP3)
   {
     int pos1024 = 0;
 
     if (lba_offset)
       pos1024 = lba_offset * 1024 / lb_len;
 
-    mp3_start_play(Pico_mcd->cdda_stream, pos1024);
+    mp3_start_play(stream, pos1024);
     return;
   }
 
-  pm_seek(Pico_mcd->cdda_stream, (lba_base + lba_offset) * 2352, SEEK_SET);
-  if (Pico_mcd->cdda_type == CT_WAV)
+  pm_seek(stream, (lba_base + lba_offset) * 2352, SEEK_SET);
+  if (type == CT_WAV)
   {
     // skip headers, assume it's 44kHz stereo uncompressed
-    pm_seek(Pico_mcd->cdda_stream, 44, SEEK_CUR);
+    pm_seek(stream, 44, SEEK_CUR);
   }
 }
 
+#ifdef USE_THREADS
+/*
+ * Audio tracks in files of their own (mp3, or bin/wav per track) are read
+ * and decoded on a thread, ahead of playback into a ring of 44.1kHz frames,
+ * so that file access and mp3 decoding don't stall the emulation thread.
+ * A seek drops what was buffered and the thread refills from the new
+ * position, the mixer only copies out of the ring and waits just when the
+ * thread is behind. Audio stored in the data track file is still read
+ * inline, sector reads share that file handle.
+ */
+#define CDDA_RING  0x2000 // frames, power of 2
+#define CDDA_CHUNK 1152   // frames decoded at a time, one mp3 frame
+
+static struct {
+  pico_thread_t thread;
+  pico_mutex_t mutex;
+  pico_cond_t cond;
+  int ring[CDDA_RING * 2];
+  unsigned int head, tail;   // frames, filled by the thread, taken by the mixer
+  unsigned int seek_req;     // incremented on each seek
+  void *stream;
+  int type, lba_base, lba_offset, lb_len;
+  int eof, quit;
+} cdda_thr;
+
+static int cdda_thread_on;
+
+static void *cdda_thread(void *arg)
+{
+  static int chunk[CDDA_CHUNK * 2];
+  unsigned int seek_done = 0, h;
+  void *stream = NULL;
+  int type = 0, more, n;
+
+  pico_mutex_lock(&cdda_thr.mutex);
+  while (!cdda_thr.quit) {
+    if (cdda_thr.seek_req != seek_done) {
+      int base = cdda_thr.lba_base, offset = cdda_thr.lba_offset;
+      int len = cdda_thr.lb_len;
+      seek_done = cdda_thr.seek_req;
+      stream = cdda_thr.stream;
+      type = cdda_thr.type;
+      pico_mutex_unlock(&cdda_thr.mutex);
+      cdda_seek(stream, type, base, offset, len);
+      pico_mutex_lock(&cdda_thr.mutex);
+      continue;
+    }
+    if (stream == NULL || cdda_thr.eof
+        || cdda_thr.head - cdda_thr.tail > CDDA_RING - CDDA_CHUNK) {
+      pico_cond_wait(&cdda_thr.cond, &cdda_thr.mutex);
+      continue;
+    }
+    pico_mutex_unlock(&cdda_thr.mutex);
+
+    memset32(chunk, 0, CDDA_CHUNK * 2);
+    if (type == CT_MP3) {
+      mp3_update(chunk, CDDA_CHUNK, 1);
+      more = 1;
+    }
+    else
+      more = cdda_raw_update(stream, chunk, CDDA_CHUNK);
+
+    pico_mutex_lock(&cdda_thr.mutex);
+    if (cdda_thr.seek_req != seek_done)
+      continue; // stale, the position changed meanwhile
+
+    h = cdda_thr.head & (CDDA_RING - 1);
+    n = CDDA_RING - h < CDDA_CHUNK ? CDDA_RING - h : CDDA_CHUNK;
+    memcpy(cdda_thr.ring + h * 2, chunk, n * 2 * sizeof(chunk[0]));
+    memcpy(cdda_thr.ring, chunk + n * 2, (CDDA_CHUNK - n) * 2 * sizeof(chunk[0]));
+    cdda_thr.head += CDDA_CHUNK;
+    cdda_thr.eof = !more;
+    pico_cond_broadcast(&cdda_thr.cond);
+  }
+  pico_mutex_unlock(&cdda_thr.mutex);
+
+  return NULL;
+}
+
+static void cdda_thread_seek(int lba_base, int lba_offset, int lb_len)
+{
+  if (!cdda_thread_on) {
+    memset(&cdda_thr, 0, sizeof(cdda_thr));
+    pico_mutex_init(&cdda_thr.mutex);
+    pico_cond_init(&cdda_thr.cond);
+    if (pico_thread_create(&cdda_thr.thread, cdda_thread, NULL) != 0) {
+      elprintf(EL_STATUS, "sound: can't create CDDA thread");
+      pico_cond_destroy(&cdda_thr.cond);
+      pico_mutex_destroy(&cdda_thr.mutex);
+      cdda_seek(Pico_mcd->cdda_stream, Pico_mcd->cdda_type,
+        lba_base, lba_offset, lb_len);
+      return;
+    }
+    cdda_thread_on = 1;
+  }
+
+  pico_mutex_lock(&cdda_thr.mutex);
+  cdda_thr.stream = Pico_mcd->cdda_stream;
+  cdda_thr.type = Pico_mcd->cdda_type;
+  cdda_thr.lba_base = lba_base;
+  cdda_thr.lba_offset = lba_offset;
+  cdda_thr.lb_len = lb_len;
+  cdda_thr.head = cdda_thr.tail = 0;
+  cdda_thr.eof = 0;
+  cdda_thr.seek_req++;
+  pico_cond_broadcast(&cdda_thr.cond);
+  pico_mutex_unlock(&cdda_thr.mutex);
+}
+
+// must be done before the track files are closed
+void cdda_thread_stop(void)
+{
+  if (!cdda_thread_on)
+    return;
+
+  pico_mutex_lock(&cdda_thr.mutex);
+  cdda_thr.quit = 1;
+  pico_cond_broadcast(&cdda_thr.cond);
+  pico_mutex_unlock(&cdda_thr.mutex);
+  pico_thread_join(cdda_thr.thread);
+
+  pico_cond_destroy(&cdda_thr.cond);
+  pico_mutex_destroy(&cdda_thr.mutex);
+  cdda_thread_on = 0;
+}
+
+static void cdda_thread_get(int *buffer, int length)
+{
+  unsigned int t;
+  int n;
+
+  pico_mutex_lock(&cdda_thr.mutex);
+  // only if it's behind, like after a seek or when running unthrottled
+  while (cdda_thr.head - cdda_thr.tail < length && !cdda_thr.eof) {
+    pico_cond_broadcast(&cdda_thr.cond);
+    pico_cond_wait(&cdda_thr.cond, &cdda_thr.mutex);
+  }
+  if (length > cdda_thr.head - cdda_thr.tail)
+    length = cdda_thr.head - cdda_thr.tail;
+
+  t = cdda_thr.tail & (CDDA_RING - 1);
+  n = CDDA_RING - t < length ? CDDA_RING - t : length;
+  memcpy(buffer, cdda_thr.ring + t * 2, n * 2 * sizeof(buffer[0]));
+  memcpy(buffer + n * 2, cdda_thr.ring, (length - n) * 2 * sizeof(buffer[0]));
+  cdda_thr.tail += length;
+
+  if (cdda_thr.eof && cdda_thr.head == cdda_thr.tail)
+    Pico_mcd->cdda_stream = NULL;
+  pico_cond_broadcast(&cdda_thr.cond);
+  pico_mutex_unlock(&cdda_thr.mutex);
+}
+#else
+#define cdda_thread_on 0
+#define cdda_thread_get(buffer, length)
+#endif
+
+static void cdda_update(int *buffer, int length, int stereo)
+{
+  int len44;
+
+  // 44.1kHz frames covering this output, keeping the remainder
+  cdda_frac += 44100 * length;
+  len44 = cdda_frac / PicoIn.sndRate;
+  cdda_frac -= len44 * PicoIn.sndRate;
+  if (len44 > 1152)
+    len44 = 1152;
+
+  memset32(cdda_buffer, 0, len44 * 2);
+  if (cdda_thread_on)
+    cdda_thread_get(cdda_buffer, len44);
+  else if (Pico_mcd->cdda_type == CT_MP3)
+    mp3_update(cdda_buffer, len44, 1);
+  else if (!cdda_raw_update(Pico_mcd->cdda_stream, cdda_buffer, len44))
+    Pico_mcd->cdda_stream = NULL;
+
+  resampler_run(&cdda_rs, buffer, length, stereo, cdda_buffer, len44);
+}
+
+// data_file: the track is in the data track file
+void cdda_start_play(int lba_base, int lba_offset, int lb_len, int data_file)
+{
+#ifdef USE_THREADS
+  if (!data_file && Pico_mcd->cdda_stream != NULL) {
+    cdda_thread_seek(lba_base, lba_offset, lb_len);
+    return;
+  }
+  // the thread may be using the decoder or cdda_out_buffer
+  cdda_thread_stop();
+#endif
+  cdda_seek(Pico_mcd->cdda_stream, Pico_mcd->cdda_type,
+    lba_base, lba_offset, lb_len);
+}
+
 
 PICO_INTERNAL void PsndClear(void)
 {
   int len = Pico.snd.len;
   if (Pico.snd.len_e_add) len++;
+  if (len < Pico.snd.len_use) len = Pico.snd.len_use;
   if (PicoIn.opt & POPT_EN_STEREO)
     memset32((int *) PicoIn.sndOut, 0, len); // assume PicoIn.sndOut to be aligned
   else {
@@ -275,10 +784,14 @@ PICO_INTERNAL void PsndClear(void)
 static int PsndRender(int offset, int length)
 {
   int  buf32_updated = 0;
-  int *buf32 = PsndBuffer+offset;
   int stereo = (PicoIn.opt & 8) >> 3;
+  int *buf32 = PsndBuffer+(offset<<stereo);
+
+  if (ym2612_thread_on && (PicoIn.opt & POPT_EN_FM))
+    buf32_updated = fm_thread_get(buf32, offset, length);
 
   offset <<= stereo;
+  psnd_stems.pos = offset;
 
   pprof_start(sound);
 
@@ -288,9 +801,11 @@ static int PsndRender(int offset, int length)
   }
 
   // Add in the stereo FM buffer
-  if (PicoIn.opt & POPT_EN_FM) {
-    buf32_updated = YM2612UpdateOne(buf32, length, stereo, 1);
-  } else
+  if (ym2612_thread_on && (PicoIn.opt & POPT_EN_FM))
+    ; // already there
+  else
+    PsndDoFM((offset >> stereo) + length);
+  if (!(PicoIn.opt & POPT_EN_FM))
     memset32(buf32, 0, length<<stereo);
 
 //printf("active_chs: %02x\n", buf32_updated);
@@ -308,15 +823,16 @@ static int PsndRender(int offset, int length)
       && Pico_mcd->cdda_stream != NULL
       && !(Pico_mcd->s68k_regs[0x36] & 1))
   {
-    // note: only 44, 22 and 11 kHz supported, with forced stereo
-    if (Pico_mcd->cdda_type == CT_MP3)
-      mp3_update(buf32, length, stereo);
-    else
-      cdda_raw_update(buf32, length);
+    int *s = stem_buf(PSND_STEM_CDDA, offset);
+    cdda_update(s ? s : buf32, length, stereo);
+    if (s) stem_add(buf32, s, length << stereo);
   }
 
-  if ((PicoIn.AHW & PAHW_32X) && (PicoIn.opt & POPT_EN_PWM))
-    p32x_pwm_update(buf32, length, stereo);
+  if ((PicoIn.AHW & PAHW_32X) && (PicoIn.opt & POPT_EN_PWM)) {
+    int *s = stem_buf(PSND_STEM_PWM, offset);
+    p32x_pwm_update(s ? s : buf32, length, stereo);
+    if (s) stem_add(buf32, s, length << stereo);
+  }
 
   // convert + limit to normal 16bit output
   PsndMix_32_to_16l(PicoIn.sndOut+offset, buf32, length);
@@ -331,24 +847,37 @@ PICO_INTERNAL void PsndGetSamples(int y)
 {
   static int curr_pos = 0;
 
-  if (ym2612.dacen && Pico.snd.dac_line < y)
-    PsndDoDAC(y - 1);
+  if (ym2612.dacen)
+    PsndDoDAC(PsndPos(y, 0));
   PsndDoPSG(y - 1);
 
+  if (!PicoIn.sndOut) {
+    // nothing to output, only bring FM to the end of the sound frame
+    if (y == 224) {
+      PsndDoFM(Pico.snd.len_use);
+      Pico.snd.dac_pos = fm_pos = 0;
+      dac_info[224] = 0;
+    }
+    return;
+  }
+
   if (y == 224)
   {
     if (Pico.m.status & 2)
-         curr_pos += PsndRender(curr_pos, Pico.snd.len-Pico.snd.len/2);
+         curr_pos += PsndRender(curr_pos, Pico.snd.len_use-Pico.snd.len/2);
     else curr_pos  = PsndRender(0, Pico.snd.len_use);
     if (Pico.m.status & 1)
          Pico.m.status |=  2;
     else Pico.m.status &= ~2;
+    PsndStemsFrameEnd(curr_pos);
+    PsndRingWrite(PicoIn.sndOut, curr_pos);
     if (PicoIn.writeSound)
       PicoIn.writeSound(curr_pos * ((PicoIn.opt & POPT_EN_STEREO) ? 4 : 2));
     // clear sound buffer
     PsndClear();
-    Pico.snd.dac_line = 224;
+    Pico.snd.dac_pos = fm_pos = 0;
     dac_info[224] = 0;
+    fm_thread_frame_end();
   }
   else if (Pico.m.status & 3) {
     Pico.m.status |=  2;
@@ -362,6 +891,10 @@ PICO_INTERNAL void PsndGetSamplesMS(void)
   int length = Pico.snd.len_use;
 
   PsndDoPSG(223);
+  if (!PicoIn.sndOut) {
+    dac_info[224] = 0;
+    return;
+  }
 
   // upmix to "stereo" if needed
   if (PicoIn.opt & POPT_EN_STEREO) {
@@ -370,6 +903,8 @@ PICO_INTERNAL void PsndGetSamplesMS(void)
       *p |= *p << 16;
   }
 
+  PsndStemsFrameEnd(length);
+  PsndRingWrite(PicoIn.sndOut, length);
   if (PicoIn.writeSound != NULL)
     PicoIn.writeSound(length * ((PicoIn.opt & POPT_EN_STEREO) ? 4 : 2));
   PsndClear();
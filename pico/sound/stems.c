@@ -0,0 +1,308 @@
+/*
+ * PicoDrive
+ * per source audio capture ("stems")
+ *
+ * This work is licensed under the terms of MAME license.
+ * See COPYING file in the top-level directory.
+ *
+ * For offline analysis, each sound source can be written to a .wav of its
+ * own besides the normal mix: the 6 FM channels, DAC, PSG tones and noise,
+ * the 8 CD PCM channels, CDDA and 32X PWM. While capturing, the sources
+ * render to psnd_stems.buf first and are added to the mix from there (FM
+ * goes through the serial path then, the FM thread is stopped). When off,
+ * all that's left of it is a flag test per render call.
+ * Capture begins on a sound frame boundary. Finished frames are converted
+ * to 16 bit and handed to a writer thread, so the emulation only waits on
+ * the disk if it gets STEMS_SLOTS frames ahead.
+ */
+
+#include <string.h>
+#include "../pico_int.h"
+#include "../pico_thread.h"
+
+#ifdef USE_THREADS
+#define STEMS_SLOTS 16  // power of 2
+#else
+#define STEMS_SLOTS 1
+#endif
+
+struct psnd_stems psnd_stems;
+
+static const char * const stem_names[PSND_STEM_COUNT] = {
+  "fm1", "fm2", "fm3", "fm4", "fm5", "fm6", "dac",
+  "psg1", "psg2", "psg3", "noise",
+  "pcm1", "pcm2", "pcm3", "pcm4", "pcm5", "pcm6", "pcm7", "pcm8",
+  "cdda", "pwm",
+};
+
+static struct {
+  int count;                   // stems captured
+  unsigned char id[PSND_STEM_COUNT];
+  FILE *f[PSND_STEM_COUNT];
+  unsigned int bytes[PSND_STEM_COUNT];
+  int *bufs;                   // behind psnd_stems.buf
+  unsigned char *slots;        // frames for the writer, 16 bit little endian
+  int slot_len[STEMS_SLOTS];   // bytes of each stem in the slot
+  unsigned int head, tail;
+  int stereo, rate;
+  int pending;                 // waiting for the frame boundary
+#ifdef USE_THREADS
+  pico_thread_t thread;
+  pico_mutex_t mutex;
+  pico_cond_t cond;
+  int thread_on, quit;
+#endif
+} st;
+
+#define STEM_BUF_LEN  (2*PSND_MAX_LEN)        // ints
+#define STEM_SLOT_LEN (2*PSND_MAX_LEN*2)      // bytes
+
+static void put16(unsigned char *p, unsigned int v)
+{
+  p[0] = v;
+  p[1] = v >> 8;
+}
+
+static void put32(unsigned char *p, unsigned int v)
+{
+  put16(p, v);
+  put16(p + 2, v >> 16);
+}
+
+static int wav_header(FILE *f, int rate, int channels, unsigned int bytes)
+{
+  unsigned char h[44];
+
+  memcpy(h, "RIFF", 4);
+  put32(h + 4, 36 + bytes);
+  memcpy(h + 8, "WAVEfmt ", 8);
+  put32(h + 16, 16);
+  put16(h + 20, 1); // PCM
+  put16(h + 22, channels);
+  put32(h + 24, rate);
+  put32(h + 28, rate * channels * 2);
+  put16(h + 32, channels * 2);
+  put16(h + 34, 16);
+  memcpy(h + 36, "data", 4);
+  put32(h + 40, bytes);
+
+  fseek(f, 0, SEEK_SET);
+  return fwrite(h, 1, sizeof(h), f) == sizeof(h) ? 0 : -1;
+}
+
+static void stems_write(unsigned int n)
+{
+  const unsigned char *p;
+  int k, len;
+
+  n &= STEMS_SLOTS - 1;
+  p = st.slots + n * st.count * STEM_SLOT_LEN;
+  len = st.slot_len[n];
+  for (k = 0; k < st.count; k++, p += STEM_SLOT_LEN) {
+    if (st.f[k] == NULL)
+      continue;
+    if (fwrite(p, 1, len, st.f[k]) != len) {
+      elprintf(EL_STATUS, "stems: write failed, %s dropped", stem_names[st.id[k]]);
+      fclose(st.f[k]);
+      st.f[k] = NULL;
+      continue;
+    }
+    st.bytes[k] += len;
+  }
+}
+
+#ifdef USE_THREADS
+static void *stems_thread(void *arg)
+{
+  unsigned int tail;
+
+  pico_mutex_lock(&st.mutex);
+  for (;;) {
+    if (st.head == st.tail) {
+      if (st.quit)
+        break;
+      pico_cond_wait(&st.cond, &st.mutex);
+      continue;
+    }
+    tail = st.tail;
+    pico_mutex_unlock(&st.mutex);
+
+    stems_write(tail);
+
+    pico_mutex_lock(&st.mutex);
+    st.tail = tail + 1;
+    pico_cond_broadcast(&st.cond);
+  }
+  pico_mutex_unlock(&st.mutex);
+
+  return NULL;
+}
+#endif
+
+static void stems_close(void)
+{
+  int k;
+
+  psnd_stems.on = 0;
+  memset(psnd_stems.buf, 0, sizeof(psnd_stems.buf));
+  pcd_pcm_stems(0);
+
+#ifdef USE_THREADS
+  // the writer finishes what's queued first
+  if (st.thread_on) {
+    pico_mutex_lock(&st.mutex);
+    st.quit = 1;
+    pico_cond_broadcast(&st.cond);
+    pico_mutex_unlock(&st.mutex);
+    pico_thread_join(st.thread);
+    pico_cond_destroy(&st.cond);
+    pico_mutex_destroy(&st.mutex);
+  }
+#endif
+
+  for (k = 0; k < st.count; k++) {
+    if (st.f[k] == NULL)
+      continue;
+    wav_header(st.f[k], st.rate, st.stereo + 1, st.bytes[k]);
+    fclose(st.f[k]);
+  }
+  free(st.bufs);
+  free(st.slots);
+  memset(&st, 0, sizeof(st));
+}
+
+// writes <prefix>_<source>.wav for every PSND_STEM_* bit set in 'mask',
+// starting with the next sound frame, until PsndStemsStop()
+int PsndStemsStart(const char *prefix, unsigned int mask)
+{
+  char path[512];
+  int i, k;
+
+  pcd_s68k_wait(); // PCM stems are made by the sub cpu side
+  PsndStemsStop();
+
+  st.stereo = (PicoIn.opt & POPT_EN_STEREO) ? 1 : 0;
+  st.rate = PicoIn.sndRate;
+  for (i = k = 0; i < PSND_STEM_COUNT; i++) {
+    if (!(mask & (1u << i)))
+      continue;
+    snprintf(path, sizeof(path), "%s_%s.wav", prefix, stem_names[i]);
+    st.id[k] = i;
+    st.f[k] = fopen(path, "wb");
+    st.count = ++k;
+    if (st.f[k - 1] == NULL || wav_header(st.f[k - 1], st.rate, st.stereo + 1, 0)) {
+      elprintf(EL_STATUS, "stems: can't write %s", path);
+      goto fail;
+    }
+  }
+  if (k == 0)
+    return -1;
+
+  st.bufs = calloc(k, STEM_BUF_LEN * sizeof(st.bufs[0]));
+  st.slots = malloc(STEMS_SLOTS * k * STEM_SLOT_LEN);
+  if (st.bufs == NULL || st.slots == NULL)
+    goto fail;
+
+#ifdef USE_THREADS
+  pico_mutex_init(&st.mutex);
+  pico_cond_init(&st.cond);
+  if (pico_thread_create(&st.thread, stems_thread, NULL) != 0) {
+    elprintf(EL_STATUS, "stems: can't create writer thread");
+    pico_cond_destroy(&st.cond);
+    pico_mutex_destroy(&st.mutex);
+    goto fail;
+  }
+  st.thread_on = 1;
+#endif
+
+  st.pending = 1;
+  return 0;
+
+fail:
+  stems_close();
+  return -1;
+}
+
+void PsndStemsStop(void)
+{
+  pcd_s68k_wait();
+  if (st.count)
+    stems_close();
+}
+
+// capturing or about to, off again once stopped or the output format changed
+int PsndStemsActive(void)
+{
+  return st.count != 0;
+}
+
+static void stems_begin(void)
+{
+  int k;
+
+  st.pending = 0;
+  for (k = 0; k < st.count; k++) {
+    psnd_stems.buf[st.id[k]] = st.bufs + k * STEM_BUF_LEN;
+    if (st.id[k] >= PSND_STEM_PCM1 && st.id[k] < PSND_STEM_PCM1 + 8)
+      pcd_pcm_stems(1);
+  }
+  psnd_stems.on = 1;
+}
+
+// called at the end of each sound frame of 'length' samples
+PICO_INTERNAL void PsndStemsFrameEnd(int length)
+{
+  unsigned char *slot;
+  int k, i, id, *s;
+
+  if (!psnd_stems.on) {
+    if (st.pending)
+      stems_begin();
+    return;
+  }
+
+  if (st.rate != PicoIn.sndRate
+      || st.stereo != ((PicoIn.opt & POPT_EN_STEREO) ? 1 : 0)) {
+    elprintf(EL_STATUS, "stems: output format changed, capture stopped");
+    stems_close();
+    return;
+  }
+
+#ifdef USE_THREADS
+  pico_mutex_lock(&st.mutex);
+  while (st.head - st.tail >= STEMS_SLOTS)
+    pico_cond_wait(&st.cond, &st.mutex);
+  pico_mutex_unlock(&st.mutex);
+#endif
+
+  slot = st.slots + (st.head & (STEMS_SLOTS - 1)) * st.count * STEM_SLOT_LEN;
+  for (k = 0; k < st.count; k++, slot += STEM_SLOT_LEN) {
+    id = st.id[k];
+    s = psnd_stems.buf[id];
+    // DAC and PSG are mono, only left is rendered (like in the mix)
+    if (st.stereo && id >= PSND_STEM_DAC && id < PSND_STEM_PCM1)
+      for (i = 0; i < length * 2; i += 2)
+        s[i + 1] = s[i];
+    for (i = 0; i < length << st.stereo; i++) {
+      int v = s[i];
+      if (v > 32767)
+        v = 32767;
+      else if (v < -32768)
+        v = -32768;
+      put16(slot + i * 2, v);
+    }
+  }
+  st.slot_len[st.head & (STEMS_SLOTS - 1)] = (length << st.stereo) * 2;
+  memset(st.bufs, 0, st.count * STEM_BUF_LEN * sizeof(st.bufs[0]));
+
+#ifdef USE_THREADS
+  pico_mutex_lock(&st.mutex);
+  st.head++;
+  pico_cond_broadcast(&st.cond);
+  pico_mutex_unlock(&st.mutex);
+#else
+  stems_write(st.head++);
+#endif
+}
+
+// vim:shiftwidth=2:ts=2:expandtab
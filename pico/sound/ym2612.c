@@ -826,8 +826,26 @@ typedef struct
 
 
 #if !defined(_ASM_YM2612_C) || defined(EXTERNAL_YM2612)
-static void chan_render_loop(chan_rend_context *ct, int *buffer, int length)
+/* Like the upd_algo* routines of the asm version, the loop is instantiated
+ * for each algorithm and for LFO on/off, so per sample there's only the work
+ * the channel actually needs. Hot state is kept in locals as the compiler
+ * can't tell that the buffer doesn't alias the context. */
+#ifdef __GNUC__
+__attribute__((always_inline))
+#endif
+INLINE void chan_render_loop_(chan_rend_context *ct, int *buffer, int length,
+	const int algo, const int lfo)
 {
+	FM_SLOT *SLOT = ct->CH->SLOT;
+	UINT32 phase1 = ct->phase1, phase2 = ct->phase2, phase3 = ct->phase3, phase4 = ct->phase4;
+	UINT32 incr1 = ct->incr1, incr2 = ct->incr2, incr3 = ct->incr3, incr4 = ct->incr4;
+	UINT16 vol_out1 = ct->vol_out1, vol_out2 = ct->vol_out2;
+	UINT16 vol_out3 = ct->vol_out3, vol_out4 = ct->vol_out4;
+	UINT32 lfo_cnt = ct->lfo_cnt, lfo_inc = ct->lfo_inc;
+	UINT32 eg_cnt = ct->eg_cnt, eg_timer = ct->eg_timer, eg_timer_add = ct->eg_timer_add;
+	UINT32 pack = ct->pack;
+	INT32  mem = ct->mem, op1_out = ct->op1_out;
+	int had_output = 0;
 	int scounter;					/* sample counter */
 
 	/* sample generating loop */
@@ -836,68 +854,68 @@ static void chan_render_loop(chan_rend_context *ct, int *buffer, int length)
 		int smp = 0;		/* produced sample */
 		unsigned int eg_out, eg_out2, eg_out4;
 
-		if (ct->pack & 8) { /* LFO enabled ? (test Earthworm Jim in between demo 1 and 2) */
-			ct->pack = (ct->pack&0xffff) | (advance_lfo(ct->pack >> 16, ct->lfo_cnt, ct->lfo_cnt + ct->lfo_inc) << 16);
-			ct->lfo_cnt += ct->lfo_inc;
+		if (lfo) { /* LFO enabled ? (test Earthworm Jim in between demo 1 and 2) */
+			pack = (pack&0xffff) | (advance_lfo(pack >> 16, lfo_cnt, lfo_cnt + lfo_inc) << 16);
+			lfo_cnt += lfo_inc;
 		}
 
-		ct->eg_timer += ct->eg_timer_add;
-		while (ct->eg_timer >= EG_TIMER_OVERFLOW)
+		eg_timer += eg_timer_add;
+		while (eg_timer >= EG_TIMER_OVERFLOW)
 		{
-			ct->eg_timer -= EG_TIMER_OVERFLOW;
-			ct->eg_cnt++;
+			eg_timer -= EG_TIMER_OVERFLOW;
+			eg_cnt++;
 
-			if (ct->CH->SLOT[SLOT1].state != EG_OFF) update_eg_phase(&ct->vol_out1, &ct->CH->SLOT[SLOT1], ct->eg_cnt);
-			if (ct->CH->SLOT[SLOT2].state != EG_OFF) update_eg_phase(&ct->vol_out2, &ct->CH->SLOT[SLOT2], ct->eg_cnt);
-			if (ct->CH->SLOT[SLOT3].state != EG_OFF) update_eg_phase(&ct->vol_out3, &ct->CH->SLOT[SLOT3], ct->eg_cnt);
-			if (ct->CH->SLOT[SLOT4].state != EG_OFF) update_eg_phase(&ct->vol_out4, &ct->CH->SLOT[SLOT4], ct->eg_cnt);
+			if (SLOT[SLOT1].state != EG_OFF) update_eg_phase(&vol_out1, &SLOT[SLOT1], eg_cnt);
+			if (SLOT[SLOT2].state != EG_OFF) update_eg_phase(&vol_out2, &SLOT[SLOT2], eg_cnt);
+			if (SLOT[SLOT3].state != EG_OFF) update_eg_phase(&vol_out3, &SLOT[SLOT3], eg_cnt);
+			if (SLOT[SLOT4].state != EG_OFF) update_eg_phase(&vol_out4, &SLOT[SLOT4], eg_cnt);
 		}
 
-		if (ct->pack & 4) continue; /* output disabled */
+		if (algo > 7) continue; /* output disabled */
 
 		/* calculate channel sample */
-		eg_out = ct->vol_out1;
-		if ( (ct->pack & 8) && (ct->pack&(1<<(SLOT1+8))) ) eg_out += ct->pack >> (((ct->pack&0xc0)>>6)+24);
+		eg_out = vol_out1;
+		if ( lfo && (pack&(1<<(SLOT1+8))) ) eg_out += pack >> (((pack&0xc0)>>6)+24);
 
 		if( eg_out < ENV_QUIET )	/* SLOT 1 */
 		{
 			int out = 0;
 
-			if (ct->pack&0xf000) out = ((ct->op1_out>>16) + ((ct->op1_out<<16)>>16)) << ((ct->pack&0xf000)>>12); /* op1_out0 + op1_out1 */
-			ct->op1_out <<= 16;
-			ct->op1_out |= (unsigned short)op_calc1(ct->phase1, eg_out, out);
+			if (pack&0xf000) out = ((op1_out>>16) + ((op1_out<<16)>>16)) << ((pack&0xf000)>>12); /* op1_out0 + op1_out1 */
+			op1_out <<= 16;
+			op1_out |= (unsigned short)op_calc1(phase1, eg_out, out);
 		} else {
-			ct->op1_out <<= 16; /* op1_out0 = op1_out1; op1_out1 = 0; */
+			op1_out <<= 16; /* op1_out0 = op1_out1; op1_out1 = 0; */
 		}
 
-		eg_out  = ct->vol_out3; // volume_calc(&CH->SLOT[SLOT3]);
-		eg_out2 = ct->vol_out2; // volume_calc(&CH->SLOT[SLOT2]);
-		eg_out4 = ct->vol_out4; // volume_calc(&CH->SLOT[SLOT4]);
+		eg_out  = vol_out3; // volume_calc(&CH->SLOT[SLOT3]);
+		eg_out2 = vol_out2; // volume_calc(&CH->SLOT[SLOT2]);
+		eg_out4 = vol_out4; // volume_calc(&CH->SLOT[SLOT4]);
 
-		if (ct->pack & 8) {
-			unsigned int add = ct->pack >> (((ct->pack&0xc0)>>6)+24);
-			if (ct->pack & (1<<(SLOT3+8))) eg_out  += add;
-			if (ct->pack & (1<<(SLOT2+8))) eg_out2 += add;
-			if (ct->pack & (1<<(SLOT4+8))) eg_out4 += add;
+		if (lfo) {
+			unsigned int add = pack >> (((pack&0xc0)>>6)+24);
+			if (pack & (1<<(SLOT3+8))) eg_out  += add;
+			if (pack & (1<<(SLOT2+8))) eg_out2 += add;
+			if (pack & (1<<(SLOT4+8))) eg_out4 += add;
 		}
 
-		switch( ct->CH->ALGO )
+		switch( algo )
 		{
 			case 0:
 			{
 				/* M1---C1---MEM---M2---C2---OUT */
 				int m2,c1,c2=0;	/* Phase Modulation input for operators 2,3,4 */
-				m2 = ct->mem;
-				c1 = ct->op1_out>>16;
+				m2 = mem;
+				c1 = op1_out>>16;
 				if( eg_out  < ENV_QUIET ) {		/* SLOT 3 */
-					c2  = op_calc(ct->phase3, eg_out,  m2);
+					c2  = op_calc(phase3, eg_out,  m2);
 				}
 				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
-					ct->mem = op_calc(ct->phase2, eg_out2, c1);
+					mem = op_calc(phase2, eg_out2, c1);
 				}
-				else ct->mem = 0;
+				else mem = 0;
 				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
-					smp = op_calc(ct->phase4, eg_out4, c2);
+					smp = op_calc(phase4, eg_out4, c2);
 				}
 				break;
 			}
@@ -906,16 +924,16 @@ static void chan_render_loop(chan_rend_context *ct, int *buffer, int length)
 				/* M1------+-MEM---M2---C2---OUT */
 				/*      C1-+                     */
 				int m2,c2=0;
-				m2 = ct->mem;
-				ct->mem = ct->op1_out>>16;
+				m2 = mem;
+				mem = op1_out>>16;
 				if( eg_out  < ENV_QUIET ) {		/* SLOT 3 */
-					c2  = op_calc(ct->phase3, eg_out,  m2);
+					c2  = op_calc(phase3, eg_out,  m2);
 				}
 				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
-					ct->mem+= op_calc(ct->phase2, eg_out2, 0);
+					mem+= op_calc(phase2, eg_out2, 0);
 				}
 				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
-					smp = op_calc(ct->phase4, eg_out4, c2);
+					smp = op_calc(phase4, eg_out4, c2);
 				}
 				break;
 			}
@@ -924,17 +942,17 @@ static void chan_render_loop(chan_rend_context *ct, int *buffer, int length)
 				/* M1-----------------+-C2---OUT */
 				/*      C1---MEM---M2-+          */
 				int m2,c2;
-				m2 = ct->mem;
-				c2 = ct->op1_out>>16;
+				m2 = mem;
+				c2 = op1_out>>16;
 				if( eg_out  < ENV_QUIET ) {		/* SLOT 3 */
-					c2 += op_calc(ct->phase3, eg_out,  m2);
+					c2 += op_calc(phase3, eg_out,  m2);
 				}
 				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
-					ct->mem = op_calc(ct->phase2, eg_out2, 0);
+					mem = op_calc(phase2, eg_out2, 0);
 				}
-				else ct->mem = 0;
+				else mem = 0;
 				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
-					smp = op_calc(ct->phase4, eg_out4, c2);
+					smp = op_calc(phase4, eg_out4, c2);
 				}
 				break;
 			}
@@ -943,17 +961,17 @@ static void chan_render_loop(chan_rend_context *ct, int *buffer, int length)
 				/* M1---C1---MEM------+-C2---OUT */
 				/*                 M2-+          */
 				int c1,c2;
-				c2 = ct->mem;
-				c1 = ct->op1_out>>16;
+				c2 = mem;
+				c1 = op1_out>>16;
 				if( eg_out  < ENV_QUIET ) {		/* SLOT 3 */
-					c2 += op_calc(ct->phase3, eg_out,  0);
+					c2 += op_calc(phase3, eg_out,  0);
 				}
 				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
-					ct->mem = op_calc(ct->phase2, eg_out2, c1);
+					mem = op_calc(phase2, eg_out2, c1);
 				}
-				else ct->mem = 0;
+				else mem = 0;
 				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
-					smp = op_calc(ct->phase4, eg_out4, c2);
+					smp = op_calc(phase4, eg_out4, c2);
 				}
 				break;
 			}
@@ -963,15 +981,15 @@ static void chan_render_loop(chan_rend_context *ct, int *buffer, int length)
 				/* M2---C2-+     */
 				/* MEM: not used */
 				int c1,c2=0;
-				c1 = ct->op1_out>>16;
+				c1 = op1_out>>16;
 				if( eg_out  < ENV_QUIET ) {		/* SLOT 3 */
-					c2  = op_calc(ct->phase3, eg_out,  0);
+					c2  = op_calc(phase3, eg_out,  0);
 				}
 				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
-					smp = op_calc(ct->phase2, eg_out2, c1);
+					smp = op_calc(phase2, eg_out2, c1);
 				}
 				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
-					smp+= op_calc(ct->phase4, eg_out4, c2);
+					smp+= op_calc(phase4, eg_out4, c2);
 				}
 				break;
 			}
@@ -981,16 +999,16 @@ static void chan_render_loop(chan_rend_context *ct, int *buffer, int length)
 				/* M1-+-MEM---M2-+-OUT */
 				/*    +----C2----+     */
 				int m2,c1,c2;
-				m2 = ct->mem;
-				ct->mem = c1 = c2 = ct->op1_out>>16;
+				m2 = mem;
+				mem = c1 = c2 = op1_out>>16;
 				if( eg_out < ENV_QUIET ) {		/* SLOT 3 */
-					smp = op_calc(ct->phase3, eg_out, m2);
+					smp = op_calc(phase3, eg_out, m2);
 				}
 				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
-					smp+= op_calc(ct->phase2, eg_out2, c1);
+					smp+= op_calc(phase2, eg_out2, c1);
 				}
 				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
-					smp+= op_calc(ct->phase4, eg_out4, c2);
+					smp+= op_calc(phase4, eg_out4, c2);
 				}
 				break;
 			}
@@ -1001,15 +1019,15 @@ static void chan_render_loop(chan_rend_context *ct, int *buffer, int length)
 				/*      C2-+     */
 				/* MEM: not used */
 				int c1;
-				c1 = ct->op1_out>>16;
+				c1 = op1_out>>16;
 				if( eg_out < ENV_QUIET ) {		/* SLOT 3 */
-					smp = op_calc(ct->phase3, eg_out,  0);
+					smp = op_calc(phase3, eg_out,  0);
 				}
 				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
-					smp+= op_calc(ct->phase2, eg_out2, c1);
+					smp+= op_calc(phase2, eg_out2, c1);
 				}
 				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
-					smp+= op_calc(ct->phase4, eg_out4, 0);
+					smp+= op_calc(phase4, eg_out4, 0);
 				}
 				break;
 			}
@@ -1020,15 +1038,15 @@ static void chan_render_loop(chan_rend_context *ct, int *buffer, int length)
 				/* M2-+     */
 				/* C2-+     */
 				/* MEM: not used*/
-				smp = ct->op1_out>>16;
+				smp = op1_out>>16;
 				if( eg_out < ENV_QUIET ) {		/* SLOT 3 */
-					smp += op_calc(ct->phase3, eg_out,  0);
+					smp += op_calc(phase3, eg_out,  0);
 				}
 				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
-					smp += op_calc(ct->phase2, eg_out2, 0);
+					smp += op_calc(phase2, eg_out2, 0);
 				}
 				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
-					smp += op_calc(ct->phase4, eg_out4, 0);
+					smp += op_calc(phase4, eg_out4, 0);
 				}
 				break;
 			}
@@ -1037,28 +1055,72 @@ static void chan_render_loop(chan_rend_context *ct, int *buffer, int length)
 
 		/* mix sample to output buffer */
 		if (smp) {
-			if (ct->pack & 1) { /* stereo */
-				if (ct->pack & 0x20) /* L */ /* TODO: check correctness */
+			if (pack & 1) { /* stereo */
+				if (pack & 0x20) /* L */ /* TODO: check correctness */
 					buffer[scounter*2] += smp;
-				if (ct->pack & 0x10) /* R */
+				if (pack & 0x10) /* R */
 					buffer[scounter*2+1] += smp;
 			} else {
 				buffer[scounter] += smp;
 			}
-			ct->algo |= 8;
+			had_output = 1;
 		}
 
 		/* update phase counters AFTER output calculations */
-		ct->phase1 += ct->incr1;
-		ct->phase2 += ct->incr2;
-		ct->phase3 += ct->incr3;
-		ct->phase4 += ct->incr4;
+		phase1 += incr1;
+		phase2 += incr2;
+		phase3 += incr3;
+		phase4 += incr4;
 	}
+
+	ct->phase1 = phase1; ct->phase2 = phase2; ct->phase3 = phase3; ct->phase4 = phase4;
+	ct->vol_out1 = vol_out1; ct->vol_out2 = vol_out2;
+	ct->vol_out3 = vol_out3; ct->vol_out4 = vol_out4;
+	ct->lfo_cnt = lfo_cnt;
+	ct->eg_cnt = eg_cnt;
+	ct->eg_timer = eg_timer;
+	ct->pack = pack;
+	ct->mem = mem;
+	ct->op1_out = op1_out;
+	if (had_output)
+		ct->algo |= 8;
+}
+
+#define CHAN_RENDER_ALGO(lfo) \
+	switch (algo) { \
+	case 0: chan_render_loop_(ct, buffer, length, 0, lfo); break; \
+	case 1: chan_render_loop_(ct, buffer, length, 1, lfo); break; \
+	case 2: chan_render_loop_(ct, buffer, length, 2, lfo); break; \
+	case 3: chan_render_loop_(ct, buffer, length, 3, lfo); break; \
+	case 4: chan_render_loop_(ct, buffer, length, 4, lfo); break; \
+	case 5: chan_render_loop_(ct, buffer, length, 5, lfo); break; \
+	case 6: chan_render_loop_(ct, buffer, length, 6, lfo); break; \
+	case 7: chan_render_loop_(ct, buffer, length, 7, lfo); break; \
+	default: chan_render_loop_(ct, buffer, length, 8, lfo); break; \
+	}
+
+static void chan_render_loop(chan_rend_context *ct, int *buffer, int length)
+{
+	int algo = (ct->pack & 4) ? 8 : ct->CH->ALGO; /* 8: output disabled */
+
+	if (ct->pack & 8)
+		CHAN_RENDER_ALGO(1)
+	else
+		CHAN_RENDER_ALGO(0)
 }
 #else
 void chan_render_loop(chan_rend_context *ct, int *buffer, unsigned short length);
 #endif
 
+#ifdef YM2612_REF_LOOP
+/* tools/ymcmp.c: switch to the generic loop to check the above against it */
+static int ref_loop;
+static void chan_render_loop_ref(chan_rend_context *ct, int *buffer, int length);
+#define chan_render_loop(ct, buffer, length) \
+	(ref_loop ? chan_render_loop_ref(ct, buffer, length) : \
+	            chan_render_loop(ct, buffer, length))
+#endif
+
 static chan_rend_context crct;
 
 static void chan_render_prep(void)
@@ -1576,8 +1638,39 @@ static int OPNWriteReg(int r, int v)
 /*      YM2612 local section                                                   */
 /*******************************************************************************/
 
-/* Generate samples for YM2612 */
-int YM2612UpdateOne_(int *buffer, int length, int stereo, int is_buf_empty)
+int **ym2612_chan_out;
+
+/* each channel to its own buffer first, then added to the mix */
+static int chan_render_apart(int *buffer, int length, int stereo, int pan, int dacen)
+{
+	int active_chs = 0;
+	int c, i, *out;
+
+	for (c = 0; c < 6; c++)
+	{
+		UINT32 flags = stereo | (((pan >> (c*2)) & 3) << 4);
+		if (c == 5)
+			flags |= dacen << 2;
+		if (!(ym2612.slot_mask & (0xf << (c*4))))
+			continue;
+
+		out = ym2612_chan_out[c];
+		if (out == NULL) {
+			active_chs |= chan_render(buffer, length, c, flags) << c;
+			continue;
+		}
+		active_chs |= chan_render(out, length, c, flags) << c;
+		for (i = 0; i < length << stereo; i++)
+			buffer[i] += out[i];
+	}
+
+	return active_chs;
+}
+
+/* Generate samples for YM2612, with mode (3 slot) and DAC enable
+ * given by the caller instead of taken from the register interface */
+int YM2612UpdateOneEx_(int *buffer, int length, int stereo, int is_buf_empty,
+	int mode, int dacen)
 {
 	int pan;
 	int active_chs = 0;
@@ -1606,7 +1699,7 @@ int YM2612UpdateOne_(int *buffer, int length, int stereo, int is_buf_empty)
 	/* refresh PG and EG */
 	refresh_fc_eg_chan( &ym2612.CH[0] );
 	refresh_fc_eg_chan( &ym2612.CH[1] );
-	if( (ym2612.OPN.ST.mode & 0xc0) )
+	if( (mode & 0xc0) )
 		/* 3SLOT MODE */
 		refresh_fc_eg_chan_sl3();
 	else
@@ -1621,17 +1714,143 @@ int YM2612UpdateOne_(int *buffer, int length, int stereo, int is_buf_empty)
 	/* mix to 32bit dest */
 	// flags: stereo, ?, disabled, ?, pan_r, pan_l
 	chan_render_prep();
-	if (ym2612.slot_mask & 0x00000f) active_chs |= chan_render(buffer, length, 0, stereo|((pan&0x003)<<4)) << 0;
-	if (ym2612.slot_mask & 0x0000f0) active_chs |= chan_render(buffer, length, 1, stereo|((pan&0x00c)<<2)) << 1;
-	if (ym2612.slot_mask & 0x000f00) active_chs |= chan_render(buffer, length, 2, stereo|((pan&0x030)   )) << 2;
-	if (ym2612.slot_mask & 0x00f000) active_chs |= chan_render(buffer, length, 3, stereo|((pan&0x0c0)>>2)) << 3;
-	if (ym2612.slot_mask & 0x0f0000) active_chs |= chan_render(buffer, length, 4, stereo|((pan&0x300)>>4)) << 4;
-	if (ym2612.slot_mask & 0xf00000) active_chs |= chan_render(buffer, length, 5, stereo|((pan&0xc00)>>6)|(ym2612.dacen<<2)) << 5;
+	if (ym2612_chan_out != NULL)
+		active_chs = chan_render_apart(buffer, length, stereo, pan, dacen);
+	else
+	{
+		if (ym2612.slot_mask & 0x00000f) active_chs |= chan_render(buffer, length, 0, stereo|((pan&0x003)<<4)) << 0;
+		if (ym2612.slot_mask & 0x0000f0) active_chs |= chan_render(buffer, length, 1, stereo|((pan&0x00c)<<2)) << 1;
+		if (ym2612.slot_mask & 0x000f00) active_chs |= chan_render(buffer, length, 2, stereo|((pan&0x030)   )) << 2;
+		if (ym2612.slot_mask & 0x00f000) active_chs |= chan_render(buffer, length, 3, stereo|((pan&0x0c0)>>2)) << 3;
+		if (ym2612.slot_mask & 0x0f0000) active_chs |= chan_render(buffer, length, 4, stereo|((pan&0x300)>>4)) << 4;
+		if (ym2612.slot_mask & 0xf00000) active_chs |= chan_render(buffer, length, 5, stereo|((pan&0xc00)>>6)|(dacen<<2)) << 5;
+	}
 	chan_render_finish();
 
 	return active_chs; // 1 if buffer updated
 }
 
+int YM2612UpdateOne_(int *buffer, int length, int stereo, int is_buf_empty)
+{
+	return YM2612UpdateOneEx_(buffer, length, stereo, is_buf_empty,
+		ym2612.OPN.ST.mode, ym2612.dacen);
+}
+
+/* Run a slot's envelope over 'count' EG counter steps after eg_cnt, like
+ * update_eg_phase() does, but only visiting the counter values its rate
+ * acts on, and stopping as soon as nothing can change anymore. */
+static void eg_skip_slot(FM_SLOT *SLOT, UINT32 eg_cnt, UINT32 count)
+{
+	UINT32 end = eg_cnt + count;
+
+	while (SLOT->state != EG_OFF)
+	{
+		UINT32 pack = SLOT->eg_pack[SLOT->state - 1];
+		UINT32 shift = pack >> 24;
+		INT32 volume = SLOT->volume;
+		INT32 eg_inc_val;
+
+		if ((pack & 0xffffff) == 0)
+			break; /* rate 0, frozen */
+		if (SLOT->state == EG_SUS && volume >= MAX_ATT_INDEX)
+			break;
+
+		/* next counter value this rate acts on */
+		eg_cnt = ((eg_cnt >> shift) + 1) << shift;
+		if ((INT32)(end - eg_cnt) < 0)
+			break;
+
+		eg_inc_val = pack >> ((eg_cnt >> shift) & 7) * 3;
+		eg_inc_val = (1 << (eg_inc_val & 7)) >> 1;
+
+		switch (SLOT->state)
+		{
+		case EG_ATT:
+			volume += ( ~volume * eg_inc_val ) >> 4;
+			if ( volume <= MIN_ATT_INDEX )
+			{
+				volume = MIN_ATT_INDEX;
+				SLOT->state = EG_DEC;
+			}
+			break;
+
+		case EG_DEC:
+			volume += eg_inc_val;
+			if ( volume >= (INT32) SLOT->sl )
+				SLOT->state = EG_SUS;
+			break;
+
+		case EG_SUS:
+			volume += eg_inc_val;
+			if ( volume >= MAX_ATT_INDEX )
+				volume = MAX_ATT_INDEX;
+			break;
+
+		case EG_REL:
+			volume += eg_inc_val;
+			if ( volume >= MAX_ATT_INDEX )
+			{
+				volume = MAX_ATT_INDEX;
+				SLOT->state = EG_OFF;
+			}
+			break;
+		}
+		SLOT->volume = volume;
+	}
+}
+
+/* Bring the chip 'length' samples forward without making them, for when
+ * the sound isn't used. Envelopes step through only what changes them,
+ * phase and LFO are moved in one go (ignoring LFO PM, it's inaudible
+ * here). Timers don't need this, they run on the CPU clocks. */
+void YM2612SkipSamples_(int length)
+{
+	unsigned long long eg_timer;
+	UINT32 steps;
+	int c, s;
+
+	if (length <= 0)
+		return;
+
+	refresh_fc_eg_chan( &ym2612.CH[0] );
+	refresh_fc_eg_chan( &ym2612.CH[1] );
+	if( (ym2612.OPN.ST.mode & 0xc0) )
+		refresh_fc_eg_chan_sl3();
+	else
+		refresh_fc_eg_chan( &ym2612.CH[2] );
+	refresh_fc_eg_chan( &ym2612.CH[3] );
+	refresh_fc_eg_chan( &ym2612.CH[4] );
+	refresh_fc_eg_chan( &ym2612.CH[5] );
+
+	if (ym2612.OPN.lfo_inc)
+	{
+		int pos;
+		ym2612.OPN.lfo_cnt += ym2612.OPN.lfo_inc * length;
+		pos = (ym2612.OPN.lfo_cnt >> LFO_SH) & 127;
+		g_lfo_ampm = ((pos < 64 ? pos * 2 : 126 - (pos & 63) * 2) << 8) | (pos >> 2);
+	}
+
+	eg_timer = ym2612.OPN.eg_timer + (unsigned long long)ym2612.OPN.eg_timer_add * length;
+	steps = eg_timer / EG_TIMER_OVERFLOW;
+	ym2612.OPN.eg_timer = eg_timer % EG_TIMER_OVERFLOW;
+
+	for (c = 0; c < 6; c++)
+	{
+		FM_CH *CH = &ym2612.CH[c];
+		if (!(ym2612.slot_mask & (0xf << (c*4))))
+			continue;
+
+		for (s = 0; s < 4; s++)
+		{
+			CH->SLOT[s].phase += CH->SLOT[s].Incr * length;
+			eg_skip_slot(&CH->SLOT[s], ym2612.OPN.eg_cnt, steps);
+		}
+		if (!(CH->SLOT[SLOT1].state | CH->SLOT[SLOT2].state | CH->SLOT[SLOT3].state | CH->SLOT[SLOT4].state))
+			ym2612.slot_mask &= ~(0xf << (c*4));
+	}
+	ym2612.OPN.eg_cnt += steps;
+}
+
 
 /* initialize YM2612 emulator */
 void YM2612Init_(int clock, int rate)
@@ -1684,116 +1903,120 @@ void YM2612ResetChip_(void)
 }
 
 
-/* YM2612 write */
-/* a = address */
-/* v = value   */
+/* YM2612 data write to register addr (0x000-0x1ff) */
 /* returns 1 if sample affecting state changed */
-int YM2612Write_(unsigned int a, unsigned int v)
+int YM2612WriteReg_(unsigned int addr, unsigned int v)
 {
-	int addr, ret=1;
+	int ret=1;
 
 	v &= 0xff;	/* adjust to 8 bit bus */
 
-	switch( a & 3 ){
-	case 0:	/* address port 0 */
-	case 2:	/* address port 1 */
-		ym2612.OPN.ST.address = v;
-		ym2612.addr_A1 = (a & 2) >> 1;
-		ret = 0;
-		break;
-
-	case 1:
-	case 3:	/* data port */
-		addr = ym2612.OPN.ST.address | ((int)ym2612.addr_A1 << 8);
-
-		switch( addr & 0x1f0 )
+	switch( addr & 0x1f0 )
+	{
+	case 0x20:	/* 0x20-0x2f Mode */
+		switch( addr )
 		{
-		case 0x20:	/* 0x20-0x2f Mode */
-			switch( addr )
+		case 0x22:	/* LFO FREQ (YM2608/YM2610/YM2610B/YM2612) */
+			if (v&0x08) /* LFO enabled ? */
 			{
-			case 0x22:	/* LFO FREQ (YM2608/YM2610/YM2610B/YM2612) */
-				if (v&0x08) /* LFO enabled ? */
-				{
-					ym2612.OPN.lfo_inc = ym2612.OPN.lfo_freq[v&7];
-				}
-				else
-				{
-					ym2612.OPN.lfo_inc = 0;
-					ym2612.OPN.lfo_cnt = 0;
-				}
-				break;
+				ym2612.OPN.lfo_inc = ym2612.OPN.lfo_freq[v&7];
+			}
+			else
+			{
+				ym2612.OPN.lfo_inc = 0;
+				ym2612.OPN.lfo_cnt = 0;
+			}
+			break;
 #if 0 // handled elsewhere
-			case 0x24: { // timer A High 8
-					int TAnew = (ym2612.OPN.ST.TA & 0x03)|(((int)v)<<2);
-					if(ym2612.OPN.ST.TA != TAnew) {
-						// we should reset ticker only if new value is written. Outrun requires this.
-						ym2612.OPN.ST.TA = TAnew;
-						ym2612.OPN.ST.TAC = (1024-TAnew)*18;
-						ym2612.OPN.ST.TAT = 0;
-					}
-				}
-				ret=0;
-				break;
-			case 0x25: { // timer A Low 2
-					int TAnew = (ym2612.OPN.ST.TA & 0x3fc)|(v&3);
-					if(ym2612.OPN.ST.TA != TAnew) {
-						ym2612.OPN.ST.TA = TAnew;
-						ym2612.OPN.ST.TAC = (1024-TAnew)*18;
-						ym2612.OPN.ST.TAT = 0;
-					}
+		case 0x24: { // timer A High 8
+				int TAnew = (ym2612.OPN.ST.TA & 0x03)|(((int)v)<<2);
+				if(ym2612.OPN.ST.TA != TAnew) {
+					// we should reset ticker only if new value is written. Outrun requires this.
+					ym2612.OPN.ST.TA = TAnew;
+					ym2612.OPN.ST.TAC = (1024-TAnew)*18;
+					ym2612.OPN.ST.TAT = 0;
 				}
-				ret=0;
-				break;
-			case 0x26: // timer B
-				if(ym2612.OPN.ST.TB != v) {
-					ym2612.OPN.ST.TB = v;
-					ym2612.OPN.ST.TBC  = (256-v)<<4;
-					ym2612.OPN.ST.TBC *= 18;
-					ym2612.OPN.ST.TBT  = 0;
+			}
+			ret=0;
+			break;
+		case 0x25: { // timer A Low 2
+				int TAnew = (ym2612.OPN.ST.TA & 0x3fc)|(v&3);
+				if(ym2612.OPN.ST.TA != TAnew) {
+					ym2612.OPN.ST.TA = TAnew;
+					ym2612.OPN.ST.TAC = (1024-TAnew)*18;
+					ym2612.OPN.ST.TAT = 0;
 				}
-				ret=0;
-				break;
+			}
+			ret=0;
+			break;
+		case 0x26: // timer B
+			if(ym2612.OPN.ST.TB != v) {
+				ym2612.OPN.ST.TB = v;
+				ym2612.OPN.ST.TBC  = (256-v)<<4;
+				ym2612.OPN.ST.TBC *= 18;
+				ym2612.OPN.ST.TBT  = 0;
+			}
+			ret=0;
+			break;
 #endif
-			case 0x27:	/* mode, timer control */
-				set_timers( v );
-				ret=0;
-				break;
-			case 0x28:	/* key on / off */
-				{
-					UINT8 c;
-
-					c = v & 0x03;
-					if( c == 3 ) { ret=0; break; }
-					if( v&0x04 ) c+=3;
-					if(v&0x10) FM_KEYON(c,SLOT1); else FM_KEYOFF(c,SLOT1);
-					if(v&0x20) FM_KEYON(c,SLOT2); else FM_KEYOFF(c,SLOT2);
-					if(v&0x40) FM_KEYON(c,SLOT3); else FM_KEYOFF(c,SLOT3);
-					if(v&0x80) FM_KEYON(c,SLOT4); else FM_KEYOFF(c,SLOT4);
-					break;
-				}
-			case 0x2a:	/* DAC data (YM2612) */
-				ym2612.dacout = ((int)v - 0x80) << 6;	/* level unknown (notaz: 8 seems to be too much) */
-				ret=0;
-				break;
-			case 0x2b:	/* DAC Sel  (YM2612) */
-				/* b7 = dac enable */
-				ym2612.dacen = v & 0x80;
-				ret=0;
-				break;
-			default:
+		case 0x27:	/* mode, timer control */
+			set_timers( v );
+			ret=0;
+			break;
+		case 0x28:	/* key on / off */
+			{
+				UINT8 c;
+
+				c = v & 0x03;
+				if( c == 3 ) { ret=0; break; }
+				if( v&0x04 ) c+=3;
+				if(v&0x10) FM_KEYON(c,SLOT1); else FM_KEYOFF(c,SLOT1);
+				if(v&0x20) FM_KEYON(c,SLOT2); else FM_KEYOFF(c,SLOT2);
+				if(v&0x40) FM_KEYON(c,SLOT3); else FM_KEYOFF(c,SLOT3);
+				if(v&0x80) FM_KEYON(c,SLOT4); else FM_KEYOFF(c,SLOT4);
 				break;
 			}
+		case 0x2a:	/* DAC data (YM2612) */
+			ym2612.dacout = ((int)v - 0x80) << 6;	/* level unknown (notaz: 8 seems to be too much) */
+			ret=0;
+			break;
+		case 0x2b:	/* DAC Sel  (YM2612) */
+			/* b7 = dac enable */
+			ym2612.dacen = v & 0x80;
+			ret=0;
+			break;
+		default:
 			break;
-		default:	/* 0x30-0xff OPN section */
-			/* write register */
-			ret = OPNWriteReg(addr,v);
 		}
 		break;
+	default:	/* 0x30-0xff OPN section */
+		/* write register */
+		ret = OPNWriteReg(addr,v);
 	}
 
 	return ret;
 }
 
+/* YM2612 write */
+/* a = address */
+/* v = value   */
+/* returns 1 if sample affecting state changed */
+int YM2612Write_(unsigned int a, unsigned int v)
+{
+	v &= 0xff;	/* adjust to 8 bit bus */
+
+	switch( a & 3 ){
+	case 0:	/* address port 0 */
+	case 2:	/* address port 1 */
+		ym2612.OPN.ST.address = v;
+		ym2612.addr_A1 = (a & 2) >> 1;
+		return 0;
+	}
+
+	/* data port */
+	return YM2612WriteReg_(ym2612.OPN.ST.address | ((int)ym2612.addr_A1 << 8), v);
+}
+
 #if 0
 UINT8 YM2612Read_(void)
 {
@@ -157,8 +157,15 @@ extern YM2612 ym2612;
 void YM2612Init_(int baseclock, int rate);
 void YM2612ResetChip_(void);
 int  YM2612UpdateOne_(int *buffer, int length, int stereo, int is_buf_empty);
+int  YM2612UpdateOneEx_(int *buffer, int length, int stereo, int is_buf_empty,
+			int mode, int dacen);
+void YM2612SkipSamples_(int length);
+
+/* when set, each channel is also left in its own buffer (NULL: skipped) */
+extern int **ym2612_chan_out;
 
 int  YM2612Write_(unsigned int a, unsigned int v);
+int  YM2612WriteReg_(unsigned int addr, unsigned int v);
 //unsigned char YM2612Read_(void);
 
 int  YM2612PicoTick_(int n);
@@ -172,6 +179,7 @@ int  YM2612PicoStateLoad2(int *tat, int *tbt);
 #define YM2612Init          YM2612Init_
 #define YM2612ResetChip     YM2612ResetChip_
 #define YM2612UpdateOne     YM2612UpdateOne_
+#define YM2612SkipSamples   YM2612SkipSamples_
 #define YM2612PicoStateLoad YM2612PicoStateLoad_
 #else
 /* GP2X specific */
@@ -188,6 +196,9 @@ extern int PicoIn.opt;
 #define YM2612UpdateOne(buffer,length,stereo,is_buf_empty) \
 	(PicoIn.opt&0x200) ? YM2612UpdateOne_940(buffer, length, stereo, is_buf_empty) : \
 				YM2612UpdateOne_(buffer, length, stereo, is_buf_empty);
+#define YM2612SkipSamples(length) { \
+	if (!(PicoIn.opt&0x200)) YM2612SkipSamples_(length); \
+}
 #define YM2612PicoStateLoad() { \
 	if (PicoIn.opt&0x200) YM2612PicoStateLoad_940(); \
 	else               YM2612PicoStateLoad_(); \
@@ -376,6 +376,43 @@ static int g_read_offs = 0;
   CHECKED_READ(len, data); \
 }
 
+// common post-load fixups, all memory must already be in place
+static void state_loaded(const unsigned char *buff_m68k,
+  const unsigned char *buff_s68k, const unsigned char *buff_z80)
+{
+  if (PicoIn.AHW & PAHW_SMS)
+    PicoStateLoadedMS();
+
+  if (PicoIn.AHW & PAHW_32X)
+    Pico32xStateLoaded(1);
+
+  if (PicoLoadStateHook != NULL)
+    PicoLoadStateHook();
+
+  // must unpack 68k and z80 after banks are set up
+  if (!(PicoIn.AHW & PAHW_SMS))
+    SekUnpackCpu(buff_m68k, 0);
+  if (PicoIn.AHW & PAHW_MCD)
+    SekUnpackCpu(buff_s68k, 1);
+
+  z80_unpack(buff_z80);
+
+  // due to dep from 68k cycles..
+  Pico.t.m68c_aim = Pico.t.m68c_cnt;
+  if (PicoIn.AHW & PAHW_32X)
+    Pico32xStateLoaded(0);
+  if (PicoIn.AHW & PAHW_MCD)
+  {
+    SekCycleAimS68k = SekCycleCntS68k;
+    pcd_state_loaded();
+  }
+
+  Pico.m.dirtyPal = 1;
+  Pico.video.status &= ~(SR_VB | SR_F);
+  Pico.video.status |= ((Pico.video.reg[1] >> 3) ^ SR_VB) & SR_VB;
+  Pico.video.status |= (Pico.video.pending_ints << 2) & SR_F;
+}
+
 static int state_load(void *file)
 {
   unsigned char buff_m68k[0x60], buff_s68k[0x60];
@@ -541,38 +578,7 @@ breakswitch:
   }
 
 readend:
-  if (PicoIn.AHW & PAHW_SMS)
-    PicoStateLoadedMS();
-
-  if (PicoIn.AHW & PAHW_32X)
-    Pico32xStateLoaded(1);
-
-  if (PicoLoadStateHook != NULL)
-    PicoLoadStateHook();
-
-  // must unpack 68k and z80 after banks are set up
-  if (!(PicoIn.AHW & PAHW_SMS))
-    SekUnpackCpu(buff_m68k, 0);
-  if (PicoIn.AHW & PAHW_MCD)
-    SekUnpackCpu(buff_s68k, 1);
-
-  z80_unpack(buff_z80);
-
-  // due to dep from 68k cycles..
-  Pico.t.m68c_aim = Pico.t.m68c_cnt;
-  if (PicoIn.AHW & PAHW_32X)
-    Pico32xStateLoaded(0);
-  if (PicoIn.AHW & PAHW_MCD)
-  {
-    SekCycleAimS68k = SekCycleCntS68k;
-    pcd_state_loaded();
-  }
-
-  Pico.m.dirtyPal = 1;
-  Pico.video.status &= ~(SR_VB | SR_F);
-  Pico.video.status |= ((Pico.video.reg[1] >> 3) ^ SR_VB) & SR_VB;
-  Pico.video.status |= (Pico.video.pending_ints << 2) & SR_F;
-
+  state_loaded(buff_m68k, buff_s68k, buff_z80);
   retval = 0;
 
 out:
@@ -640,6 +646,8 @@ static int pico_state_internal(void *afile, int is_save)
 {
   int ret;
 
+  pcd_s68k_wait();
+
   if (is_save)
     ret = state_save(afile);
   else
@@ -679,6 +687,7 @@ int PicoStateLoadGfx(const char *fname)
   void *afile;
   int ret;
 
+  pcd_s68k_wait();
   afile = open_save_file(fname, 0);
   if (afile == NULL)
     return -1;
@@ -723,6 +732,7 @@ void *PicoTmpStateSave(void)
   if (t == NULL)
     return NULL;
 
+  pcd_s68k_wait();
   memcpy(t->vram, PicoMem.vram, sizeof(PicoMem.vram));
   memcpy(t->cram, PicoMem.cram, sizeof(PicoMem.cram));
   memcpy(t->vsram, PicoMem.vsram, sizeof(PicoMem.vsram));
@@ -745,6 +755,7 @@ void PicoTmpStateRestore(void *data)
   if (t == NULL)
     return;
 
+  pcd_s68k_wait();
   memcpy(PicoMem.vram, t->vram, sizeof(PicoMem.vram));
   memcpy(PicoMem.cram, t->cram, sizeof(PicoMem.cram));
   memcpy(PicoMem.vsram, t->vsram, sizeof(PicoMem.vsram));
@@ -761,4 +772,207 @@ void PicoTmpStateRestore(void *data)
 #endif
 }
 
+// in-memory snapshot for runahead, rewind and such:
+// raw copies into caller's buffer, no chunk framing, ROM/BIOS left out,
+// so it's only good for the same machine config and loaded media.
+#define SNAP_MAGIC 0x50534e50 // PNSP
+
+struct PicoSnapHdr
+{
+  unsigned int magic;
+  unsigned int ahw;
+  unsigned int size;
+  unsigned int sram_size;
+};
+
+#define SNAP_AREA(ptr,len) { \
+  if (p != NULL) { \
+    if (is_save) memcpy(p, ptr, len); \
+    else         memcpy(ptr, p, len); \
+    p += len; \
+  } \
+  size += len; \
+}
+
+#define SNAP_BUFF(buff) SNAP_AREA(&buff, sizeof(buff))
+
+// with NULL p only counts the (maximum) size
+static size_t state_snap(unsigned char *p, int is_save)
+{
+  unsigned char buff_m68k[0x60], buff_s68k[0x60];
+  unsigned char buff_z80[Z80_STATE_SIZE];
+  unsigned char buff_evt[0x40];
+  size_t size = 0;
+  int len;
+
+  pcd_s68k_wait();
+
+  if (p != NULL && is_save) {
+    memset(buff_m68k, 0, sizeof(buff_m68k));
+    memset(buff_s68k, 0, sizeof(buff_s68k));
+    if (!(PicoIn.AHW & PAHW_SMS)) {
+      SekPackCpu(buff_m68k, 0);
+      ym2612_pack_state();
+    }
+    z80_pack(buff_z80);
+  }
+
+  if (!(PicoIn.AHW & PAHW_SMS)) {
+    SNAP_BUFF(buff_m68k);
+    SNAP_BUFF(PicoMem.ram);
+    SNAP_BUFF(PicoMem.vsram);
+    SNAP_BUFF(PicoMem.ioports);
+    SNAP_AREA(YM2612GetRegs(), 0x200+4);
+  }
+  else {
+    SNAP_BUFF(Pico.ms);
+  }
+
+  SNAP_BUFF(PicoMem.vram);
+  SNAP_BUFF(PicoMem.zram);
+  SNAP_BUFF(PicoMem.cram);
+  SNAP_BUFF(Pico.m);
+  SNAP_BUFF(Pico.video);
+  SNAP_BUFF(buff_z80);
+  SNAP_AREA(sn76496_regs, 28*4);
+
+  if ((Pico.sv.flags & SRF_ENABLED) && Pico.sv.data != NULL)
+    SNAP_AREA(Pico.sv.data, Pico.sv.size);
+
+  if (PicoIn.AHW & PAHW_MCD)
+  {
+    if (p != NULL && is_save) {
+      SekPackCpu(buff_s68k, 1);
+      memcpy(&Pico_mcd->m.hint_vector, Pico_mcd->bios + 0x72,
+        sizeof(Pico_mcd->m.hint_vector));
+      memset(buff_evt, 0, sizeof(buff_evt));
+      memcpy(buff_evt, pcd_event_times, sizeof(pcd_event_times));
+    }
+
+    SNAP_BUFF(buff_s68k);
+    SNAP_BUFF(Pico_mcd->s68k_regs); // before wram, selects the layout below
+    SNAP_BUFF(Pico_mcd->prg_ram);
+    // word RAM is kept in whatever format it currently is in,
+    // converting costs more than the copy
+    if (Pico_mcd->s68k_regs[3] & 4) {
+      SNAP_BUFF(Pico_mcd->word_ram1M);
+    } else {
+      SNAP_BUFF(Pico_mcd->word_ram2M);
+    }
+    SNAP_BUFF(Pico_mcd->pcm_ram);
+    SNAP_BUFF(Pico_mcd->bram);
+    SNAP_BUFF(Pico_mcd->pcm);
+    SNAP_BUFF(Pico_mcd->m);
+    SNAP_BUFF(buff_evt);
+
+    // variable sized contexts, stored with their length
+    if (p == NULL)
+      size += 3 * (4 + CHUNK_LIMIT_W);
+    else if (is_save) {
+      len = gfx_context_save(p + 4);
+      memcpy(p, &len, 4); p += 4 + len; size += 4 + len;
+      len = cdc_context_save(p + 4);
+      memcpy(p, &len, 4); p += 4 + len; size += 4 + len;
+      len = cdd_context_save(p + 4);
+      memcpy(p, &len, 4); p += 4 + len; size += 4 + len;
+    }
+    else {
+      memcpy(&len, p, 4); gfx_context_load(p + 4);
+      p += 4 + len; size += 4 + len;
+      memcpy(&len, p, 4); cdc_context_load(p + 4);
+      p += 4 + len; size += 4 + len;
+      memcpy(&len, p, 4); cdd_context_load(p + 4);
+      p += 4 + len; size += 4 + len;
+      memcpy(pcd_event_times, buff_evt, sizeof(pcd_event_times));
+    }
+  }
+
+#ifndef NO_32X
+  if (PicoIn.AHW & PAHW_32X)
+  {
+    unsigned char cpubuff[2][SH2_STATE_SIZE];
+
+    if (p != NULL && is_save) {
+      memset(cpubuff, 0, sizeof(cpubuff));
+      sh2_pack(&sh2s[0], cpubuff[0]);
+      sh2_pack(&sh2s[1], cpubuff[1]);
+      memset(buff_evt, 0, sizeof(buff_evt));
+      memcpy(buff_evt, p32x_event_times, sizeof(p32x_event_times));
+    }
+
+    SNAP_BUFF(cpubuff);
+    SNAP_BUFF(sh2s[0].data_array);
+    SNAP_BUFF(sh2s[0].peri_regs);
+    SNAP_BUFF(sh2s[1].data_array);
+    SNAP_BUFF(sh2s[1].peri_regs);
+    SNAP_BUFF(Pico32x);
+    SNAP_BUFF(Pico32xMem->sdram);
+    SNAP_BUFF(Pico32xMem->dram);
+    SNAP_BUFF(Pico32xMem->pal);
+    SNAP_BUFF(buff_evt);
+
+    if (p != NULL && !is_save) {
+      sh2_unpack(&sh2s[0], cpubuff[0]);
+      sh2_unpack(&sh2s[1], cpubuff[1]);
+      memcpy(p32x_event_times, buff_evt, sizeof(p32x_event_times));
+    }
+  }
+#endif
+
+  if (carthw_chunks != NULL)
+  {
+    carthw_state_chunk *chwc;
+    for (chwc = carthw_chunks; chwc->ptr != NULL; chwc++)
+      SNAP_AREA(chwc->ptr, chwc->size);
+  }
+
+  if (p != NULL && !is_save) {
+    if (!(PicoIn.AHW & PAHW_SMS))
+      ym2612_unpack_state();
+    // pcd_state_loaded() expects 2M format
+    if ((PicoIn.AHW & PAHW_MCD) && (Pico_mcd->s68k_regs[3] & 4))
+      wram_1M_to_2M(Pico_mcd->word_ram2M);
+    state_loaded(buff_m68k, buff_s68k, buff_z80);
+  }
+
+  return size;
+}
+
+// buffer size needed for PicoStateSnapSave() with current hw and media
+size_t PicoStateSnapSize(void)
+{
+  return sizeof(struct PicoSnapHdr) + state_snap(NULL, 1);
+}
+
+int PicoStateSnapSave(void *buf, size_t size)
+{
+  struct PicoSnapHdr *hdr = buf;
+
+  if (buf == NULL || size < PicoStateSnapSize())
+    return -1;
+
+  hdr->magic = SNAP_MAGIC;
+  hdr->ahw = PicoIn.AHW;
+  hdr->sram_size = Pico.sv.size;
+  hdr->size = state_snap((unsigned char *)(hdr + 1), 1);
+  return 0;
+}
+
+int PicoStateSnapLoad(const void *buf, size_t size)
+{
+  const struct PicoSnapHdr *hdr = buf;
+
+  if (buf == NULL || size < sizeof(*hdr) || hdr->magic != SNAP_MAGIC)
+    return -1;
+  if (hdr->ahw != PicoIn.AHW || hdr->sram_size != Pico.sv.size
+      || size < sizeof(*hdr) + hdr->size)
+  {
+    elprintf(EL_STATUS, "snapshot: hw/media mismatch");
+    return -1;
+  }
+
+  state_snap((unsigned char *)(hdr + 1), 0);
+  return 0;
+}
+
 // vim:shiftwidth=2:ts=2:expandtab
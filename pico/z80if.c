@@ -121,9 +121,16 @@ void z80_reset(void)
   Cz80_Reset(&CZ80);
   if (PicoIn.AHW & PAHW_SMS)
     Cz80_Set_Reg(&CZ80, CZ80_SP, 0xdff0);
+  CZ80.IdleDet = !(PicoIn.opt & POPT_DIS_IDLE_DET);
 #endif
 }
 
+// cz80 found the z80 spinning in an idle loop at pc
+void z80_idle_hit(unsigned int pc)
+{
+  PicoIdleHit(IDLE_Z80, pc);
+}
+
 struct z80sr_main {
   u8 a, f;
   u8 b, c;
@@ -36,6 +36,24 @@ else
 DEFINES += CPU_CMP_R
 endif # cpu_cmp_w
 endif
+ifeq "$(drc_cmp)" "1"
+# SH2 drc checked against a 'tracelog' written by an interpreter run
+DEFINES += DRC_CMP
+endif
+ifeq "$(cmp68k)" "1"
+# FAME checked against Musashi, every cmp68k_n instructions
+DEFINES += CMP_68K
+ifdef cmp68k_n
+DEFINES += CMP68K_N=$(cmp68k_n)
+endif
+SRCS_COMMON += $(R)pico/cmp68k.c $(R)cpu/musashi/m68kops.c $(R)cpu/musashi/m68kcpu.c
+use_fame = 1
+use_m68kdrc = 0
+endif
+ifeq "$(use_threads)" "1"
+DEFINES += USE_THREADS
+LDLIBS += -lpthread
+endif
 ifeq "$(pprof)" "1"
 DEFINES += PPROF
 SRCS_COMMON += $(R)platform/linux/pprof.c
@@ -79,7 +97,8 @@ SRCS_COMMON += $(R)pico/pico.c $(R)pico/cart.c $(R)pico/memory.c \
 	$(R)pico/state.c $(R)pico/sek.c $(R)pico/z80if.c \
 	$(R)pico/videoport.c $(R)pico/draw2.c $(R)pico/draw.c \
 	$(R)pico/mode4.c $(R)pico/misc.c $(R)pico/eeprom.c \
-	$(R)pico/patch.c $(R)pico/debug.c $(R)pico/media.c
+	$(R)pico/patch.c $(R)pico/debug.c $(R)pico/media.c \
+	$(R)pico/idle.c
 # SMS
 ifneq "$(no_sms)" "1"
 SRCS_COMMON += $(R)pico/sms.c
@@ -94,7 +113,8 @@ SRCS_COMMON += $(R)pico/cd/mcd.c $(R)pico/cd/memory.c $(R)pico/cd/sek.c \
 # 32X
 ifneq "$(no_32x)" "1"
 SRCS_COMMON += $(R)pico/32x/32x.c $(R)pico/32x/memory.c $(R)pico/32x/draw.c \
-	$(R)pico/32x/sh2soc.c $(R)pico/32x/pwm.c
+	$(R)pico/32x/sh2soc.c $(R)pico/32x/pwm.c $(R)pico/32x/spec.c \
+	$(R)pico/32x/drccache.c
 else
 DEFINES += NO_32X
 endif
@@ -114,6 +134,9 @@ endif
 # sound
 SRCS_COMMON += $(R)pico/sound/sound.c
 SRCS_COMMON += $(R)pico/sound/sn76496.c $(R)pico/sound/ym2612.c
+SRCS_COMMON += $(R)pico/sound/resampler.c
+SRCS_COMMON += $(R)pico/sound/sndring.c
+SRCS_COMMON += $(R)pico/sound/stems.c
 ifneq "$(ARCH)$(asm_mix)" "arm1"
 SRCS_COMMON += $(R)pico/sound/mix.c
 endif
@@ -133,6 +156,10 @@ endif
 ifeq "$(use_fame)" "1"
 DEFINES += EMU_F68K
 SRCS_COMMON += $(R)cpu/fame/famec.c
+ifeq "$(use_m68kdrc)" "1"
+DEFINES += DRC_M68K
+SRCS_COMMON += $(R)cpu/fame/compiler.c
+endif
 endif
 
 # --- Z80 ---
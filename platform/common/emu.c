@@ -53,7 +53,7 @@ int pico_inp_mode;
 int flip_after_sync;
 int engineState = PGS_Menu;
 
-static short __attribute__((aligned(4))) sndBuffer[2*44100/50];
+static short __attribute__((aligned(4))) sndBuffer[2*PSND_MAX_LEN];
 
 /* tmp buff to reduce stack usage for plats with small stack */
 static char static_buff[512];
@@ -887,6 +887,8 @@ int emu_save_load_game(int load, int sram)
 		int sram_size;
 		unsigned char *sram_data;
 		int truncate = 1;
+
+		PicoFrameWait();
 		if (PicoIn.AHW & PAHW_MCD)
 		{
 			if (PicoIn.opt & POPT_EN_MCD_RAMCART) {
@@ -17,9 +17,11 @@
 #include "emu.h"
 #include "version.h"
 #include <cpu/debug.h>
+#include <pico/pico.h>
 
 
 static int load_state_slot = -1;
+static const char *stems_prefix;
 char **g_argv;
 
 void parse_cmd_line(int argc, char *argv[])
@@ -38,6 +40,9 @@ void parse_cmd_line(int argc, char *argv[])
 			{
 				if (x+1 < argc) { ++x; load_state_slot = atoi(argv[x]); }
 			}
+			else if (strcasecmp(argv[x], "-stems") == 0) {
+				if (x+1 < argc) { ++x; stems_prefix = argv[x]; }
+			}
 			else if (strcasecmp(argv[x], "-pdb") == 0) {
 				if (x+1 < argc) { ++x; pdb_command(argv[x]); }
 			}
@@ -66,7 +71,8 @@ void parse_cmd_line(int argc, char *argv[])
 		printf("usage: %s [options] [romfile]\n", argv[0]);
 		printf("options:\n"
 			" -config <file>    use specified config file instead of default 'config.cfg'\n"
-			" -loadstate <num>  if ROM is specified, try loading savestate slot <num>\n");
+			" -loadstate <num>  if ROM is specified, try loading savestate slot <num>\n"
+			" -stems <prefix>   if ROM is specified, record each sound source to <prefix>_<source>.wav\n");
 		exit(1);
 	}
 }
@@ -103,6 +109,9 @@ int main(int argc, char *argv[])
 				state_slot = load_state_slot;
 				emu_save_load_game(1, 0);
 			}
+			// until the ROM is unloaded
+			if (stems_prefix != NULL)
+				PsndStemsStart(stems_prefix, ~0u);
 		}
 	}
 
@@ -29,7 +29,7 @@
 static const char *rom_exts[] = {
 	"zip",
 	"bin", "smd", "gen", "md",
-	"iso", "cso", "cue",
+	"iso", "cso", "cue", "pdz",
 	"32x",
 	"sms",
 	NULL
@@ -408,6 +408,8 @@ static const char h_srcart[] = "Emulate the save RAM cartridge accessory\n"
 				"most games don't need this";
 static const char h_scfx[]   = "Emulate scale/rotate ASIC chip for graphics effects\n"
 				"disable to improve performance";
+static const char h_cdthr[]  = "Finish sub-CPU frame on a 2nd thread\n"
+				"needs a multicore CPU";
 
 static menu_entry e_menu_cd_options[] =
 {
@@ -416,6 +418,9 @@ static menu_entry e_menu_cd_options[] =
 	mee_onoff_h("PCM audio",            MA_CDOPT_PCM,           PicoIn.opt, POPT_EN_MCD_PCM, h_cdpcm),
 	mee_onoff_h("SaveRAM cart",         MA_CDOPT_SAVERAM,       PicoIn.opt, POPT_EN_MCD_RAMCART, h_srcart),
 	mee_onoff_h("Scale/Rot. fx",        MA_CDOPT_SCALEROT_CHIP, PicoIn.opt, POPT_EN_MCD_GFX, h_scfx),
+#ifdef USE_THREADS
+	mee_onoff_h("Sub-CPU thread",       MA_CDOPT_THREAD,        PicoIn.opt, POPT_EN_MCD_THREAD, h_cdthr),
+#endif
 	mee_end,
 };
 
@@ -463,6 +468,8 @@ static const char h_pwm[]        = "Disabling may improve performance, but break
 static const char h_sh2cycles[]  = "Cycles/millisecond (similar to DOSBox)\n"
 				   "lower values speed up emulation but break games\n"
 				   "at least 11000 recommended for compatibility";
+static const char h_sh2spec[]    = "Let the SH2s run ahead of each other and redo\n"
+				   "the work if they turn out to interact";
 
 static menu_entry e_menu_32x_options[] =
 {
@@ -471,6 +478,7 @@ static menu_entry e_menu_32x_options[] =
 	mee_onoff_h   ("PWM sound",         MA_32XOPT_PWM,         PicoIn.opt, POPT_EN_PWM, h_pwm),
 	mee_cust_h    ("Master SH2 cycles", MA_32XOPT_MSH2_CYCLES, mh_opt_sh2cycles, mgn_opt_sh2cycles, h_sh2cycles),
 	mee_cust_h    ("Slave SH2 cycles",  MA_32XOPT_SSH2_CYCLES, mh_opt_sh2cycles, mgn_opt_sh2cycles, h_sh2cycles),
+	mee_onoff_h   ("Speculative sync",  MA_32XOPT_SPEC,        PicoIn.opt, POPT_EN_32X_SPEC, h_sh2spec),
 	mee_end,
 };
 
@@ -491,6 +499,8 @@ static int menu_loop_32x_options(int id, int keys)
 // ------------ adv options menu ------------
 
 static const char h_ovrclk[] = "Will break some games, keep at 0";
+static const char h_sndthr[] = "Synthesize FM on a 2nd thread\n"
+				"needs a multicore CPU";
 
 static menu_entry e_menu_adv_options[] =
 {
@@ -500,6 +510,9 @@ static menu_entry e_menu_adv_options[] =
 	mee_onoff     ("Emulate Z80",              MA_OPT2_ENABLE_Z80,    PicoIn.opt, POPT_EN_Z80),
 	mee_onoff     ("Emulate YM2612 (FM)",      MA_OPT2_ENABLE_YM2612, PicoIn.opt, POPT_EN_FM),
 	mee_onoff     ("Emulate SN76496 (PSG)",    MA_OPT2_ENABLE_SN76496,PicoIn.opt, POPT_EN_PSG),
+#ifdef USE_THREADS
+	mee_onoff_h   ("FM sound thread",          MA_OPT2_SND_THREAD,    PicoIn.opt, POPT_EN_SND_THREAD, h_sndthr),
+#endif
 	mee_onoff     ("gzip savestates",          MA_OPT2_GZIP_STATES,   currentConfig.EmuOpt, EOPT_GZIP_SAVES),
 	mee_onoff     ("Don't save last used ROM", MA_OPT2_NO_LAST_ROM,   currentConfig.EmuOpt, EOPT_NO_AUTOSVCFG),
 	mee_onoff     ("Disable idle loop patching",MA_OPT2_NO_IDLE_LOOPS,PicoIn.opt, POPT_DIS_IDLE_DET),
@@ -556,24 +569,25 @@ static menu_entry e_menu_options[];
 
 static int sndrate_prevnext(int rate, int dir)
 {
-	static const int rates[] = { 8000, 11025, 16000, 22050, 44100 };
+	static const int rates[] = { 8000, 11025, 16000, 22050, 44100, 48000, 96000 };
+	const int last = sizeof(rates) / sizeof(rates[0]) - 1;
 	int i;
 
-	for (i = 0; i < 5; i++)
+	for (i = 0; i <= last; i++)
 		if (rates[i] == rate) break;
 
 	i += dir ? 1 : -1;
-	if (i > 4) {
+	if (i > last) {
 		if (!(PicoIn.opt & POPT_EN_STEREO)) {
 			PicoIn.opt |= POPT_EN_STEREO;
 			return rates[0];
 		}
-		return rates[4];
+		return rates[last];
 	}
 	if (i < 0) {
 		if (PicoIn.opt & POPT_EN_STEREO) {
 			PicoIn.opt &= ~POPT_EN_STEREO;
-			return rates[4];
+			return rates[last];
 		}
 		return rates[0];
 	}
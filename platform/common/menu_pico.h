@@ -49,6 +49,7 @@ typedef enum
 	MA_OPT2_ENABLE_Z80,
 	MA_OPT2_ENABLE_YM2612,
 	MA_OPT2_ENABLE_SN76496,
+	MA_OPT2_SND_THREAD,
 	MA_OPT2_GZIP_STATES,
 	MA_OPT2_NO_LAST_ROM,
 	MA_OPT2_RAMTIMINGS,	/* gp2x */
@@ -82,12 +83,14 @@ typedef enum
 	MA_CDOPT_READAHEAD,
 	MA_CDOPT_SAVERAM,
 	MA_CDOPT_SCALEROT_CHIP,
+	MA_CDOPT_THREAD,
 	MA_CDOPT_DONE,
 	MA_32XOPT_ENABLE_32X,
 	MA_32XOPT_RENDERER,
 	MA_32XOPT_PWM,
 	MA_32XOPT_MSH2_CYCLES,
 	MA_32XOPT_SSH2_CYCLES,
+	MA_32XOPT_SPEC,
 	MA_CTRL_PLAYER1,
 	MA_CTRL_PLAYER2,
 	MA_CTRL_EMU,
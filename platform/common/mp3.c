@@ -157,44 +157,31 @@ void mp3_start_play(void *f_, int pos1024)
 
 void mp3_update(int *buffer, int length, int stereo)
 {
-	int length_mp3, shr = 0;
-	void (*mix_samples)(int *dest_buf, short *mp3_buf, int count) = mix_16h_to_32;
-
 	if (mp3_current_file == NULL || mp3_file_pos >= mp3_file_len)
 		return; /* no file / EOF */
 
 	if (!decoder_active)
 		return;
 
-	length_mp3 = length;
-	if (PicoIn.sndRate <= 11025 + 100) {
-		mix_samples = mix_16h_to_32_s2;
-		length_mp3 <<= 2; shr = 2;
-	}
-	else if (PicoIn.sndRate <= 22050 + 100) {
-		mix_samples = mix_16h_to_32_s1;
-		length_mp3 <<= 1; shr = 1;
-	}
-
-	if (1152 - cdda_out_pos >= length_mp3) {
-		mix_samples(buffer, cdda_out_buffer + cdda_out_pos * 2,
+	/* the core resamples, length is in 44.1kHz frames */
+	if (1152 - cdda_out_pos >= length) {
+		mix_16h_to_32(buffer, cdda_out_buffer + cdda_out_pos * 2,
 			length * 2);
 
-		cdda_out_pos += length_mp3;
+		cdda_out_pos += length;
 	} else {
 		int ret, left = 1152 - cdda_out_pos;
 
 		if (left > 0)
-			mix_samples(buffer, cdda_out_buffer + cdda_out_pos * 2,
-				(left >> shr) * 2);
+			mix_16h_to_32(buffer, cdda_out_buffer + cdda_out_pos * 2,
+				left * 2);
 
 		ret = mp3dec_decode(mp3_current_file, &mp3_file_pos,
 			mp3_file_len);
 		if (ret == 0) {
-			cdda_out_pos = length_mp3 - left;
-			mix_samples(buffer + (left >> shr) * 2,
-				cdda_out_buffer,
-				(cdda_out_pos >> shr) * 2);
+			cdda_out_pos = length - left;
+			mix_16h_to_32(buffer + left * 2,
+				cdda_out_buffer, cdda_out_pos * 2);
 		} else
 			cdda_out_pos = 0;
 	}
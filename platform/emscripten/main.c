@@ -24,26 +24,10 @@ int vdp_start_line = 0;
 int vdp_line_count = 240;
 
 static unsigned short vout_buf[320*240];
-static short snd_buffer[2*48000/50];
-#define SND_QUEUE_SAMPLES 65536
-static short snd_queue[SND_QUEUE_SAMPLES];
-static int snd_queue_insert_idx = 0;
-static int snd_queue_read_idx = 0;
+static short snd_buffer[2*PSND_MAX_LEN];
+#define SND_LATENCY_MS 80 // SDL pulls 2048 frames at a time
 
 static int em_sound_init();
-static void snd_write(int len) {
-    if (sound_dev > 0) {
-        SDL_QueueAudio(sound_dev, PicoIn.sndOut, len);
-        //printf("Enqueuing %d bytes to sound\n", len);
-    }
-    //len = len * 2;
-    //for (int i = 0; i < len; i++) {
-    //    if (snd_queue_insert_idx >= SND_QUEUE_SAMPLES)
-    //        snd_queue_insert_idx -= SND_QUEUE_SAMPLES;
-    //    snd_queue[snd_queue_insert_idx] = snd_buffer[i];
-    //    snd_queue_insert_idx++;
-    //}
-}
 
 static void em_byteswap(void *dst, const void *src, int len)
 {
@@ -76,10 +60,7 @@ int cart_insert(unsigned char *buf, unsigned int size, char *config)
         int ret = PicoCartInsert(new_rom, size, NULL);
         PicoDetectRegion();
         PicoLoopPrepare();
-        snd_queue_insert_idx = 0;
-        snd_queue_read_idx = 0;
         memset(snd_buffer, 0, sizeof(snd_buffer));
-        memset(snd_queue, 0, sizeof(snd_queue));
         PicoIn.sndOut = snd_buffer;
         PsndRerate(0);
         if (loaded_rom)
@@ -148,6 +129,7 @@ void set_loop(bool _simulate, bool _render_graphics, bool _render_sound)
             {
                 SDL_PauseAudioDevice(sound_dev, 1);
             }
+            PsndRingStop();
             render_sound = false;
         }
     }
@@ -207,17 +189,8 @@ void em_main_loop(void *something)
 
 static void em_audio_mixer_s16(void *user, Uint8 *stream, int len)
 {
-    int samples = len / 2; // 2 bytes per sample
-    short *buf = (short *)stream;
-    for (int i = 0; i < samples; i++)
-    {
-        if (snd_queue_insert_idx == snd_queue_read_idx)
-            return;
-        if (snd_queue_read_idx >= SND_QUEUE_SAMPLES)
-            snd_queue_read_idx -= SND_QUEUE_SAMPLES;
-        buf[i] = snd_queue[snd_queue_read_idx];
-        snd_queue_read_idx++;
-    }
+    // the core keeps the ring filled at the rate SDL takes it out
+    PsndRingRead((short *)stream, len / 4); // 4 bytes per stereo frame
 }
 static int em_sound_init()
 {
@@ -226,13 +199,13 @@ static int em_sound_init()
         SDL_CloseAudioDevice(sound_dev);
         sound_dev = 0;
     }
+    PsndRingStop();
     SDL_AudioSpec as;
     as.freq = PicoIn.sndRate;
     as.format = AUDIO_S16;
     as.channels = 2;
     as.samples = 2048;
-    //as.callback = em_audio_mixer_s16;
-    as.callback = NULL;
+    as.callback = em_audio_mixer_s16;
 
     SDL_AudioSpec as_got;
     int dev = SDL_OpenAudioDevice(NULL, 0, &as, &as_got, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
@@ -246,6 +219,11 @@ static int em_sound_init()
         PicoIn.sndRate = as_got.freq;
         PsndRerate(1);
     }
+    if (PsndRingStart(SND_LATENCY_MS) < 0)
+    {
+        SDL_CloseAudioDevice(dev);
+        return -1;
+    }
     sound_dev = dev;
     SDL_PauseAudioDevice(dev, 0);
     return 0;
@@ -313,9 +291,8 @@ int main(int argc, char const *argv[])
         | POPT_ACC_SPRITES | POPT_DIS_32C_BORDER;
     PicoIn.sndRate = 44100;
     PicoIn.autoRgnOrder = 0x184; // TODO: use parameters here
-    PicoIn.writeSound = snd_write;
+    PicoIn.writeSound = NULL;
     memset(snd_buffer, 0, sizeof(snd_buffer));
-    memset(snd_queue, 0, sizeof(snd_queue));
     PicoIn.sndOut = snd_buffer;
     PicoIn.overclockM68k = 0;
     PicoIn.regionOverride = 0;
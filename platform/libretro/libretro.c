@@ -79,7 +79,9 @@ static void *vout_buf;
 static int vout_width, vout_height, vout_offset;
 static float user_vout_width = 0.0;
 
-static short ALIGNED(4) sndBuffer[2*44100/50];
+static short ALIGNED(4) sndBuffer[2*PSND_MAX_LEN];
+static int memory_exposed; // retro_get_memory_data() was asked
+static int stems_wanted;
 
 static void snd_write(int len);
 
@@ -522,12 +524,25 @@ void retro_set_environment(retro_environment_t cb)
       { "picodrive_input2",      "Input device 2; 3 button pad|6 button pad|None" },
       { "picodrive_sprlim",      "No sprite limit; disabled|enabled" },
       { "picodrive_ramcart",     "MegaCD RAM cart; disabled|enabled" },
+#ifdef USE_THREADS
+      { "picodrive_cdthread",    "MegaCD sub-CPU thread; disabled|enabled" },
+      { "picodrive_sndthread",   "FM sound thread; disabled|enabled" },
+#endif
       { "picodrive_region",      "Region; Auto|Japan NTSC|Japan PAL|US|Europe" },
       { "picodrive_aspect",      "Core-provided aspect ratio; PAR|4/3|CRT" },
       { "picodrive_overscan",    "Show Overscan; disabled|enabled" },
       { "picodrive_overclk68k",  "68k overclock; disabled|+25%|+50%|+75%|+100%|+200%|+400%" },
-#ifdef DRC_SH2
+      { "picodrive_sound_rate",  "Audio sample rate (Hz); 44100|48000|96000" },
+      { "picodrive_sh2spec",     "32X speculative SH2 sync; disabled|enabled" },
+      { "picodrive_stems",       "Record each sound source to save dir; disabled|enabled" },
+#if defined(DRC_SH2) || defined(DRC_M68K)
       { "picodrive_drc", "Dynamic recompilers; enabled|disabled" },
+#endif
+#ifdef DRC_SH2
+      { "picodrive_drccache", "Keep 32X recompiler block lists in system dir; disabled|enabled" },
+#endif
+#ifdef USE_ROM_MMAP
+      { "picodrive_romcache", "Shared ROM cache in system dir; disabled|enabled" },
 #endif
       { NULL, NULL },
    };
@@ -560,7 +575,7 @@ void retro_get_system_info(struct retro_system_info *info)
 #define GIT_VERSION ""
 #endif
    info->library_version = VERSION GIT_VERSION;
-   info->valid_extensions = "bin|gen|smd|md|32x|cue|iso|sms";
+   info->valid_extensions = "bin|gen|smd|md|32x|cue|iso|pdz|sms";
    info->need_fullpath = true;
 }
 
@@ -570,7 +585,7 @@ void retro_get_system_av_info(struct retro_system_av_info *info)
 
    memset(info, 0, sizeof(*info));
    info->timing.fps            = Pico.m.pal ? 50 : 60;
-   info->timing.sample_rate    = 44100;
+   info->timing.sample_rate    = PicoIn.sndRate;
    info->geometry.base_width   = vout_width;
    info->geometry.base_height  = vout_height;
    info->geometry.max_width    = vout_width;
@@ -744,6 +759,7 @@ void retro_cheat_set(unsigned index, bool enabled, const char *code)
 	char *buff;
 
 	if (code=='\0') return;
+	PicoFrameWait();
 	strcpy(codeCopy,code);
 	buff = strtok(codeCopy,"+");
 
@@ -972,6 +988,54 @@ static const char *find_bios(int *region, const char *cd_fname)
    return NULL;
 }
 
+// picodrive_stems: record every sound source of the loaded content to
+// <save dir>/<content name>_<source>.wav while the option is enabled,
+// later takes go to <content name>-2_<source>.wav and so on
+static void stems_update(void)
+{
+   const char *dir = NULL, *name, *p;
+   char base[512], prefix[528], path[544];
+   int len, take, ok;
+   FILE *f;
+
+   if (!stems_wanted || Pico.rom == NULL || disks[0].fname == NULL) {
+      PsndStemsStop();
+      return;
+   }
+   if (PsndStemsActive())
+      return;
+
+   for (name = p = disks[0].fname; *p != 0; p++)
+      if (*p == '/' || *p == SLASH)
+         name = p + 1;
+   p = strrchr(name, '.');
+   len = p != NULL ? p - name : strlen(name);
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY, &dir) && dir)
+      snprintf(base, sizeof(base), "%s%c%.*s", dir, SLASH, len, name);
+   else
+      snprintf(base, sizeof(base), "%.*s", len, name);
+
+   // PsndStemsStart() truncates, don't lose an earlier take
+   for (take = 1; ; take++) {
+      if (take == 1)
+         snprintf(prefix, sizeof(prefix), "%s", base);
+      else
+         snprintf(prefix, sizeof(prefix), "%s-%d", base, take);
+      snprintf(path, sizeof(path), "%s_fm1.wav", prefix);
+      f = fopen(path, "rb");
+      if (f == NULL)
+         break;
+      fclose(f);
+   }
+
+   ok = PsndStemsStart(prefix, ~0u) == 0;
+   if (log_cb)
+      log_cb(ok ? RETRO_LOG_INFO : RETRO_LOG_ERROR,
+         ok ? "recording stems to %s_*.wav\n" : "can't record stems to %s_*.wav\n",
+         prefix);
+}
+
 bool retro_load_game(const struct retro_game_info *info)
 {
    enum media_type_e media_type;
@@ -1089,6 +1153,7 @@ bool retro_load_game(const struct retro_game_info *info)
    memset(sndBuffer, 0, sizeof(sndBuffer));
    PicoIn.sndOut = sndBuffer;
    PsndRerate(0);
+   stems_update();
 
    return true;
 }
@@ -1100,6 +1165,9 @@ bool retro_load_game_special(unsigned game_type, const struct retro_game_info *i
 
 void retro_unload_game(void)
 {
+   PicoFrameWait();
+   memory_exposed = 0;
+   PsndStemsStop();
 }
 
 unsigned retro_get_region(void)
@@ -1111,6 +1179,10 @@ void *retro_get_memory_data(unsigned type)
 {
    uint8_t* data;
 
+   // the frontend may read through these any time between frames
+   PicoFrameWait();
+   memory_exposed = 1;
+
    switch(type)
    {
       case RETRO_MEMORY_SAVE_RAM:
@@ -1138,6 +1210,7 @@ size_t retro_get_memory_size(unsigned type)
    unsigned int i;
    int sum;
 
+   PicoFrameWait();
    switch(type)
    {
       case RETRO_MEMORY_SAVE_RAM:
@@ -1241,6 +1314,26 @@ static void update_variables(void)
          PicoIn.opt &= ~POPT_EN_MCD_RAMCART;
    }
 
+#ifdef USE_THREADS
+   var.value = NULL;
+   var.key = "picodrive_cdthread";
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value) {
+      if (strcmp(var.value, "enabled") == 0)
+         PicoIn.opt |= POPT_EN_MCD_THREAD;
+      else
+         PicoIn.opt &= ~POPT_EN_MCD_THREAD;
+   }
+
+   var.value = NULL;
+   var.key = "picodrive_sndthread";
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value) {
+      if (strcmp(var.value, "enabled") == 0)
+         PicoIn.opt |= POPT_EN_SND_THREAD;
+      else
+         PicoIn.opt &= ~POPT_EN_SND_THREAD;
+   }
+#endif
+
    OldPicoRegionOverride = PicoIn.regionOverride;
    var.value = NULL;
    var.key = "picodrive_region";
@@ -1265,6 +1358,23 @@ static void update_variables(void)
       PsndRerate(1);
    }
 
+   var.value = NULL;
+   var.key = "picodrive_sound_rate";
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value) {
+      int rate = atoi(var.value);
+      if (rate != PicoIn.sndRate) {
+         PicoIn.sndRate = rate;
+         if (Pico.rom) {
+            struct retro_system_av_info av_info;
+            PsndStemsStop(); // files are at the old rate, a new take follows
+            PsndRerate(1);
+            stems_update();
+            retro_get_system_av_info(&av_info);
+            environ_cb(RETRO_ENVIRONMENT_SET_SYSTEM_AV_INFO, &av_info);
+         }
+      }
+   }
+
    old_user_vout_width = user_vout_width;
    var.value = NULL;
    var.key = "picodrive_aspect";
@@ -1302,7 +1412,23 @@ static void update_variables(void)
          PicoIn.overclockM68k = atoi(var.value + 1);
    }
 
-#ifdef DRC_SH2
+   var.value = NULL;
+   var.key = "picodrive_sh2spec";
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value) {
+      if (strcmp(var.value, "enabled") == 0)
+         PicoIn.opt |= POPT_EN_32X_SPEC;
+      else
+         PicoIn.opt &= ~POPT_EN_32X_SPEC;
+   }
+
+   var.value = NULL;
+   var.key = "picodrive_stems";
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value) {
+      stems_wanted = strcmp(var.value, "enabled") == 0;
+      stems_update();
+   }
+
+#if defined(DRC_SH2) || defined(DRC_M68K)
    var.value = NULL;
    var.key = "picodrive_drc";
    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value) {
@@ -1316,6 +1442,30 @@ static void update_variables(void)
    if(!ctr_svchack_successful)
       PicoIn.opt &= ~POPT_EN_DRC;
 #endif
+
+#ifdef DRC_SH2
+   var.value = NULL;
+   var.key = "picodrive_drccache";
+   PicoDrcCacheDir = NULL;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value) {
+      const char *dir = NULL;
+      if (strcmp(var.value, "enabled") == 0
+          && environ_cb(RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY, &dir) && dir)
+         PicoDrcCacheDir = dir;
+   }
+#endif
+
+#ifdef USE_ROM_MMAP
+   var.value = NULL;
+   var.key = "picodrive_romcache";
+   PicoCartCacheDir = NULL;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value) {
+      const char *dir = NULL;
+      if (strcmp(var.value, "enabled") == 0
+          && environ_cb(RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY, &dir) && dir)
+         PicoCartCacheDir = dir;
+   }
+#endif
 }
 
 void retro_run(void)
@@ -1339,6 +1489,10 @@ void retro_run(void)
 
    video_cb((short *)vout_buf + vout_offset,
       vout_width, vout_height, vout_width * 2);
+
+   // the sub cpu can't be left running if the frontend watches memory
+   if (memory_exposed)
+      PicoFrameWait();
 }
 
 void retro_init(void)
@@ -0,0 +1,441 @@
+/*
+ * bin_to_pdz
+ * converts cue/bin (also wav tracks) or plain iso/bin CD images
+ * to a single hunk compressed .pdz image, see pico/cd/pdz.h
+ *
+ * This work is licensed under the terms of MAME license.
+ * See COPYING file in the top-level directory.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <zlib.h>
+
+#include "../../pico/cd/pdz.h"
+
+#ifndef MAX_PATH
+#define MAX_PATH 1024
+#endif
+
+#ifdef _WIN32
+#define DIR_SEPARATOR_CHAR '\\'
+#else
+#define DIR_SEPARATOR_CHAR '/'
+#endif
+
+#define HUNK_SECTORS_DEF 8
+
+typedef unsigned char u8;
+typedef unsigned int u32;
+
+typedef struct
+{
+  char name[MAX_PATH];
+  u32 sector_size;    // 2048 for MODE1/2048 files, raw otherwise
+  u32 skip;           // header bytes, for .wav
+  u32 sectors;
+  u32 base;           // first sector of this file in the image
+} file_struct;
+
+typedef struct
+{
+  u32 file;
+  u32 type;
+  u32 pregap;
+  u32 index1;         // in file
+} track_struct;
+
+static file_struct files[PDZ_MAX_TRACKS];
+static track_struct tracks[PDZ_MAX_TRACKS];
+static int file_count, track_count;
+
+static u32 msf_to_sectors(const char *s)
+{
+  u32 m = 0, sec = 0, f = 0;
+  sscanf(s, "%u:%u:%u", &m, &sec, &f);
+  return m * 60 * 75 + sec * 75 + f;
+}
+
+static char *skip_whitespace(char *str)
+{
+  while (isspace(*str))
+    str++;
+  return str;
+}
+
+static int load_cue(const char *cue_name)
+{
+  char line[MAX_PATH + 64], dir[MAX_PATH];
+  char *p, *name, *e;
+  FILE *f;
+
+  f = fopen(cue_name, "r");
+  if (f == NULL) {
+    printf("can't open \"%s\"\n", cue_name);
+    return -1;
+  }
+
+  snprintf(dir, sizeof(dir), "%s", cue_name);
+  p = strrchr(dir, DIR_SEPARATOR_CHAR);
+  if (p != NULL)
+    p[1] = 0;
+  else
+    dir[0] = 0;
+
+  while (fgets(line, sizeof(line), f))
+  {
+    p = skip_whitespace(line);
+
+    if (strncmp(p, "FILE ", 5) == 0)
+    {
+      if (file_count >= PDZ_MAX_TRACKS)
+        goto bad;
+      p = skip_whitespace(p + 5);
+      if (*p == '"') {
+        name = ++p;
+        e = strchr(p, '"');
+      }
+      else {
+        name = p;
+        e = p;
+        while (*e && !isspace(*e))
+          e++;
+      }
+      if (e == NULL || *e == 0)
+        goto bad;
+      *e++ = 0;
+      e = skip_whitespace(e);
+
+      snprintf(files[file_count].name, MAX_PATH, "%s%s", dir, name);
+      files[file_count].sector_size = PDZ_SECTOR_SIZE;
+      files[file_count].skip = 0;
+      if (strncmp(e, "WAVE", 4) == 0)
+        files[file_count].skip = 44;
+      else if (strncmp(e, "BINARY", 6) != 0) {
+        printf("unsupported file type: %s", e);
+        goto bad;
+      }
+      file_count++;
+    }
+    else if (strncmp(p, "TRACK ", 6) == 0)
+    {
+      if (file_count == 0 || track_count >= PDZ_MAX_TRACKS)
+        goto bad;
+      tracks[track_count].file = file_count - 1;
+      tracks[track_count].type = PDZ_TRACK_DATA;
+      if (strstr(p, "AUDIO"))
+        tracks[track_count].type = PDZ_TRACK_AUDIO;
+      else if (strstr(p, "MODE1/2048"))
+        files[file_count - 1].sector_size = 2048;
+      else if (!strstr(p, "MODE1/2352")) {
+        printf("unsupported track: %s", p);
+        goto bad;
+      }
+      track_count++;
+    }
+    else if (strncmp(p, "PREGAP ", 7) == 0 && track_count > 0)
+    {
+      tracks[track_count - 1].pregap = msf_to_sectors(skip_whitespace(p + 7));
+    }
+    else if (strncmp(p, "INDEX 01 ", 9) == 0 && track_count > 0)
+    {
+      tracks[track_count - 1].index1 = msf_to_sectors(skip_whitespace(p + 9));
+    }
+  }
+  fclose(f);
+
+  if (track_count == 0 || tracks[0].type != PDZ_TRACK_DATA) {
+    printf("no data track in cue\n");
+    return -1;
+  }
+  return 0;
+
+bad:
+  printf("can't handle cue \"%s\"\n", cue_name);
+  fclose(f);
+  return -1;
+}
+
+static int load_image(const char *name)
+{
+  char buf[32];
+  FILE *f;
+
+  f = fopen(name, "rb");
+  if (f == NULL) {
+    printf("can't open \"%s\"\n", name);
+    return -1;
+  }
+  if (fread(buf, 1, sizeof(buf), f) != sizeof(buf))
+    buf[0] = 0;
+  fclose(f);
+
+  snprintf(files[0].name, MAX_PATH, "%s", name);
+  files[0].sector_size = PDZ_SECTOR_SIZE;
+  if (strncmp(buf, "SEGADISCSYSTEM", 14) == 0)
+    files[0].sector_size = 2048;
+  else if (strncmp(buf + 16, "SEGADISCSYSTEM", 14) != 0)
+    printf("warning: not a Sega CD image?\n");
+  file_count = 1;
+
+  tracks[0].type = PDZ_TRACK_DATA;
+  track_count = 1;
+  return 0;
+}
+
+static u8 to_bcd(int v)
+{
+  return ((v / 10) << 4) | (v % 10);
+}
+
+// make raw Mode 1 sector out of 2048 bytes of data, EDC/ECC left empty
+static void iso_to_raw(u8 *sector, u32 lba)
+{
+  memmove(sector + 16, sector, 2048);
+  memset(sector, 0xff, 12);
+  sector[0] = sector[11] = 0;
+  lba += 150;
+  sector[12] = to_bcd(lba / 75 / 60);
+  sector[13] = to_bcd((lba / 75) % 60);
+  sector[14] = to_bcd(lba % 75);
+  sector[15] = 1;
+  memset(sector + 16 + 2048, 0, PDZ_SECTOR_SIZE - 16 - 2048);
+}
+
+static void delta(u8 *p, int len)
+{
+  unsigned int prev[2] = { 0, 0 };
+  int i, c;
+
+  for (i = 0; i + 4 <= len; i += 4) {
+    for (c = 0; c < 2; c++) {
+      unsigned int v = p[i+c*2] | (p[i+c*2+1] << 8);
+      p[i+c*2] = v - prev[c];
+      p[i+c*2+1] = (v - prev[c]) >> 8;
+      prev[c] = v;
+    }
+  }
+}
+
+static int deflate_buf(u8 *dst, int dst_len, const u8 *src, int src_len)
+{
+  z_stream stream;
+  int ret;
+
+  memset(&stream, 0, sizeof(stream));
+  ret = deflateInit2(&stream, 9, Z_DEFLATED, -15, 9, Z_DEFAULT_STRATEGY);
+  if (ret != Z_OK)
+    return -1;
+
+  stream.next_in = (Bytef *)src;
+  stream.avail_in = src_len;
+  stream.next_out = dst;
+  stream.avail_out = dst_len;
+  ret = deflate(&stream, Z_FINISH);
+  deflateEnd(&stream);
+  if (ret != Z_STREAM_END)
+    return -1; // doesn't fit, store instead
+
+  return stream.total_out;
+}
+
+static void put32(u8 *p, u32 v)
+{
+  p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+static int write32(FILE *f, u32 v)
+{
+  u8 b[4];
+  put32(b, v);
+  return fwrite(b, 1, 4, f) == 4 ? 0 : -1;
+}
+
+int main(int argc, char *argv[])
+{
+  char out_name[MAX_PATH], *in_name = NULL, *p;
+  u32 hunk_sectors = HUNK_SECTORS_DEF, hunk_bytes, hunk_count;
+  u32 sectors, audio_start, hunk, fill, pos, lba;
+  u8 *raw, *packed, *packed2, *tmp;
+  u32 *index;
+  FILE *in = NULL, *out;
+  int i, len, len2, len3, cur_file;
+
+  out_name[0] = 0;
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-h") == 0 && i + 1 < argc)
+      hunk_sectors = atoi(argv[++i]);
+    else if (in_name == NULL)
+      in_name = argv[i];
+    else
+      snprintf(out_name, sizeof(out_name), "%s", argv[i]);
+  }
+  if (in_name == NULL || hunk_sectors < 1 || hunk_sectors > 256) {
+    printf("usage: %s [-h <sectors_per_hunk>] <image.cue|.iso|.bin> [out.pdz]\n",
+      argv[0]);
+    return 1;
+  }
+
+  p = strrchr(in_name, '.');
+  if (p != NULL && strcasecmp(p, ".cue") == 0)
+    len = load_cue(in_name);
+  else
+    len = load_image(in_name);
+  if (len != 0)
+    return 1;
+
+  if (out_name[0] == 0) {
+    snprintf(out_name, sizeof(out_name) - 4, "%s", in_name);
+    p = strrchr(out_name, '.');
+    if (p == NULL || strchr(p, DIR_SEPARATOR_CHAR))
+      p = out_name + strlen(out_name);
+    strcpy(p, ".pdz");
+  }
+
+  // lay out files one after another
+  for (sectors = 0, i = 0; i < file_count; i++) {
+    FILE *f = fopen(files[i].name, "rb");
+    long size;
+    if (f == NULL) {
+      printf("can't open \"%s\"\n", files[i].name);
+      return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f) - files[i].skip;
+    fclose(f);
+    if (size < 0)
+      size = 0;
+    files[i].sectors = (size + files[i].sector_size - 1) / files[i].sector_size;
+    files[i].base = sectors;
+    sectors += files[i].sectors;
+  }
+
+  audio_start = sectors;
+  for (i = 0; i < track_count; i++) {
+    u32 start = files[tracks[i].file].base + tracks[i].index1;
+    if (tracks[i].type == PDZ_TRACK_AUDIO && audio_start == sectors)
+      audio_start = files[tracks[i].file].base;
+    printf("track %2d: %s %8u pregap %u\n", i + 1,
+      tracks[i].type == PDZ_TRACK_AUDIO ? "AUDIO" : "DATA ",
+      start, tracks[i].pregap);
+  }
+
+  hunk_bytes = hunk_sectors * PDZ_SECTOR_SIZE;
+  hunk_count = (sectors + hunk_sectors - 1) / hunk_sectors;
+  raw = malloc(hunk_bytes);
+  packed = malloc(hunk_bytes);
+  packed2 = malloc(hunk_bytes);
+  tmp = malloc(hunk_bytes);
+  index = calloc(hunk_count + 1, sizeof(index[0]));
+  if (raw == NULL || packed == NULL || packed2 == NULL || tmp == NULL || index == NULL) {
+    printf("out of memory\n");
+    return 1;
+  }
+
+  out = fopen(out_name, "wb");
+  if (out == NULL) {
+    printf("can't create \"%s\"\n", out_name);
+    return 1;
+  }
+
+  // header, track list, index placeholder
+  fwrite(PDZ_MAGIC, 1, 4, out);
+  write32(out, PDZ_VERSION);
+  write32(out, hunk_sectors);
+  write32(out, sectors);
+  write32(out, track_count);
+  for (i = 0; i < track_count; i++) {
+    write32(out, tracks[i].type);
+    write32(out, tracks[i].pregap);
+    write32(out, files[tracks[i].file].base + tracks[i].index1);
+  }
+  fwrite(index, 4, hunk_count + 1, out);
+  pos = ftell(out);
+
+  cur_file = -1;
+  for (hunk = 0, lba = 0; hunk < hunk_count; hunk++)
+  {
+    u32 flags = 0;
+
+    memset(raw, 0, hunk_bytes);
+    for (fill = 0; fill < hunk_sectors && lba < sectors; fill++, lba++)
+    {
+      u8 *sector = raw + fill * PDZ_SECTOR_SIZE;
+
+      if (cur_file < 0 || lba >= files[cur_file].base + files[cur_file].sectors) {
+        if (in != NULL)
+          fclose(in);
+        do {
+          cur_file++;
+        } while (files[cur_file].sectors == 0);
+        in = fopen(files[cur_file].name, "rb");
+        if (in == NULL) {
+          printf("can't open \"%s\"\n", files[cur_file].name);
+          goto fail;
+        }
+        fseek(in, files[cur_file].skip, SEEK_SET);
+      }
+      // short reads (end of file) are left zero filled
+      fread(sector, 1, files[cur_file].sector_size, in);
+      if (files[cur_file].sector_size == 2048)
+        iso_to_raw(sector, lba);
+    }
+
+    len = fill * PDZ_SECTOR_SIZE;
+    len2 = deflate_buf(packed, len, raw, len);
+    if (len2 < 0) {
+      flags = PDZ_HUNK_STORED;
+      len2 = len;
+      memcpy(packed, raw, len);
+    }
+
+    // CDDA usually packs better as sample deltas
+    if (hunk * hunk_sectors >= audio_start) {
+      memcpy(tmp, raw, len);
+      delta(tmp, len);
+      len3 = deflate_buf(packed2, len2, tmp, len);
+      if (len3 > 0 && len3 < len2) {
+        flags = PDZ_HUNK_DELTA;
+        len2 = len3;
+        memcpy(packed, packed2, len3);
+      }
+    }
+
+    index[hunk] = pos | flags;
+    if (fwrite(packed, 1, len2, out) != len2) {
+      printf("write failed\n");
+      goto fail;
+    }
+    pos += len2;
+    if (pos > PDZ_HUNK_OFFS) {
+      printf("image too large\n");
+      goto fail;
+    }
+
+    if ((hunk & 0x3ff) == 0 || hunk == hunk_count - 1) {
+      printf("\r%3u%% ", (hunk + 1) * 100 / hunk_count);
+      fflush(stdout);
+    }
+  }
+  index[hunk_count] = pos;
+  printf("\n%s: %u sectors, %u -> %u bytes\n", out_name, sectors,
+    sectors * PDZ_SECTOR_SIZE, pos);
+
+  // now the real index
+  fseek(out, 4 * 5 + track_count * 4 * 3, SEEK_SET);
+  for (hunk = 0; hunk <= hunk_count; hunk++)
+    write32(out, index[hunk]);
+
+  if (in != NULL)
+    fclose(in);
+  fclose(out);
+  return 0;
+
+fail:
+  if (in != NULL)
+    fclose(in);
+  fclose(out);
+  remove(out_name);
+  return 1;
+}
@@ -0,0 +1,367 @@
+/*
+ * Check the per-algorithm YM2612 render loop against the generic loop it
+ * replaced. Random register writes are played to the chip twice, once
+ * rendered through each loop, and the output must match sample for sample.
+ *
+ * usage: ymcmp [frames] [seeds]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define YM2612_REF_LOOP
+#include "../pico/sound/ym2612.c"
+
+void memset32(int *dest, int c, int count)
+{
+	while (count--)
+		*dest++ = c;
+}
+
+/* chan_render_loop() as it was before it was split per algorithm */
+static void chan_render_loop_ref(chan_rend_context *ct, int *buffer, int length)
+{
+	int scounter;					/* sample counter */
+
+	/* sample generating loop */
+	for (scounter = 0; scounter < length; scounter++)
+	{
+		int smp = 0;		/* produced sample */
+		unsigned int eg_out, eg_out2, eg_out4;
+
+		if (ct->pack & 8) { /* LFO enabled ? (test Earthworm Jim in between demo 1 and 2) */
+			ct->pack = (ct->pack&0xffff) | (advance_lfo(ct->pack >> 16, ct->lfo_cnt, ct->lfo_cnt + ct->lfo_inc) << 16);
+			ct->lfo_cnt += ct->lfo_inc;
+		}
+
+		ct->eg_timer += ct->eg_timer_add;
+		while (ct->eg_timer >= EG_TIMER_OVERFLOW)
+		{
+			ct->eg_timer -= EG_TIMER_OVERFLOW;
+			ct->eg_cnt++;
+
+			if (ct->CH->SLOT[SLOT1].state != EG_OFF) update_eg_phase(&ct->vol_out1, &ct->CH->SLOT[SLOT1], ct->eg_cnt);
+			if (ct->CH->SLOT[SLOT2].state != EG_OFF) update_eg_phase(&ct->vol_out2, &ct->CH->SLOT[SLOT2], ct->eg_cnt);
+			if (ct->CH->SLOT[SLOT3].state != EG_OFF) update_eg_phase(&ct->vol_out3, &ct->CH->SLOT[SLOT3], ct->eg_cnt);
+			if (ct->CH->SLOT[SLOT4].state != EG_OFF) update_eg_phase(&ct->vol_out4, &ct->CH->SLOT[SLOT4], ct->eg_cnt);
+		}
+
+		if (ct->pack & 4) continue; /* output disabled */
+
+		/* calculate channel sample */
+		eg_out = ct->vol_out1;
+		if ( (ct->pack & 8) && (ct->pack&(1<<(SLOT1+8))) ) eg_out += ct->pack >> (((ct->pack&0xc0)>>6)+24);
+
+		if( eg_out < ENV_QUIET )	/* SLOT 1 */
+		{
+			int out = 0;
+
+			if (ct->pack&0xf000) out = ((ct->op1_out>>16) + ((ct->op1_out<<16)>>16)) << ((ct->pack&0xf000)>>12); /* op1_out0 + op1_out1 */
+			ct->op1_out <<= 16;
+			ct->op1_out |= (unsigned short)op_calc1(ct->phase1, eg_out, out);
+		} else {
+			ct->op1_out <<= 16; /* op1_out0 = op1_out1; op1_out1 = 0; */
+		}
+
+		eg_out  = ct->vol_out3; // volume_calc(&CH->SLOT[SLOT3]);
+		eg_out2 = ct->vol_out2; // volume_calc(&CH->SLOT[SLOT2]);
+		eg_out4 = ct->vol_out4; // volume_calc(&CH->SLOT[SLOT4]);
+
+		if (ct->pack & 8) {
+			unsigned int add = ct->pack >> (((ct->pack&0xc0)>>6)+24);
+			if (ct->pack & (1<<(SLOT3+8))) eg_out  += add;
+			if (ct->pack & (1<<(SLOT2+8))) eg_out2 += add;
+			if (ct->pack & (1<<(SLOT4+8))) eg_out4 += add;
+		}
+
+		switch( ct->CH->ALGO )
+		{
+			case 0:
+			{
+				/* M1---C1---MEM---M2---C2---OUT */
+				int m2,c1,c2=0;	/* Phase Modulation input for operators 2,3,4 */
+				m2 = ct->mem;
+				c1 = ct->op1_out>>16;
+				if( eg_out  < ENV_QUIET ) {		/* SLOT 3 */
+					c2  = op_calc(ct->phase3, eg_out,  m2);
+				}
+				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
+					ct->mem = op_calc(ct->phase2, eg_out2, c1);
+				}
+				else ct->mem = 0;
+				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
+					smp = op_calc(ct->phase4, eg_out4, c2);
+				}
+				break;
+			}
+			case 1:
+			{
+				/* M1------+-MEM---M2---C2---OUT */
+				/*      C1-+                     */
+				int m2,c2=0;
+				m2 = ct->mem;
+				ct->mem = ct->op1_out>>16;
+				if( eg_out  < ENV_QUIET ) {		/* SLOT 3 */
+					c2  = op_calc(ct->phase3, eg_out,  m2);
+				}
+				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
+					ct->mem+= op_calc(ct->phase2, eg_out2, 0);
+				}
+				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
+					smp = op_calc(ct->phase4, eg_out4, c2);
+				}
+				break;
+			}
+			case 2:
+			{
+				/* M1-----------------+-C2---OUT */
+				/*      C1---MEM---M2-+          */
+				int m2,c2;
+				m2 = ct->mem;
+				c2 = ct->op1_out>>16;
+				if( eg_out  < ENV_QUIET ) {		/* SLOT 3 */
+					c2 += op_calc(ct->phase3, eg_out,  m2);
+				}
+				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
+					ct->mem = op_calc(ct->phase2, eg_out2, 0);
+				}
+				else ct->mem = 0;
+				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
+					smp = op_calc(ct->phase4, eg_out4, c2);
+				}
+				break;
+			}
+			case 3:
+			{
+				/* M1---C1---MEM------+-C2---OUT */
+				/*                 M2-+          */
+				int c1,c2;
+				c2 = ct->mem;
+				c1 = ct->op1_out>>16;
+				if( eg_out  < ENV_QUIET ) {		/* SLOT 3 */
+					c2 += op_calc(ct->phase3, eg_out,  0);
+				}
+				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
+					ct->mem = op_calc(ct->phase2, eg_out2, c1);
+				}
+				else ct->mem = 0;
+				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
+					smp = op_calc(ct->phase4, eg_out4, c2);
+				}
+				break;
+			}
+			case 4:
+			{
+				/* M1---C1-+-OUT */
+				/* M2---C2-+     */
+				/* MEM: not used */
+				int c1,c2=0;
+				c1 = ct->op1_out>>16;
+				if( eg_out  < ENV_QUIET ) {		/* SLOT 3 */
+					c2  = op_calc(ct->phase3, eg_out,  0);
+				}
+				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
+					smp = op_calc(ct->phase2, eg_out2, c1);
+				}
+				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
+					smp+= op_calc(ct->phase4, eg_out4, c2);
+				}
+				break;
+			}
+			case 5:
+			{
+				/*    +----C1----+     */
+				/* M1-+-MEM---M2-+-OUT */
+				/*    +----C2----+     */
+				int m2,c1,c2;
+				m2 = ct->mem;
+				ct->mem = c1 = c2 = ct->op1_out>>16;
+				if( eg_out < ENV_QUIET ) {		/* SLOT 3 */
+					smp = op_calc(ct->phase3, eg_out, m2);
+				}
+				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
+					smp+= op_calc(ct->phase2, eg_out2, c1);
+				}
+				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
+					smp+= op_calc(ct->phase4, eg_out4, c2);
+				}
+				break;
+			}
+			case 6:
+			{
+				/* M1---C1-+     */
+				/*      M2-+-OUT */
+				/*      C2-+     */
+				/* MEM: not used */
+				int c1;
+				c1 = ct->op1_out>>16;
+				if( eg_out < ENV_QUIET ) {		/* SLOT 3 */
+					smp = op_calc(ct->phase3, eg_out,  0);
+				}
+				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
+					smp+= op_calc(ct->phase2, eg_out2, c1);
+				}
+				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
+					smp+= op_calc(ct->phase4, eg_out4, 0);
+				}
+				break;
+			}
+			case 7:
+			{
+				/* M1-+     */
+				/* C1-+-OUT */
+				/* M2-+     */
+				/* C2-+     */
+				/* MEM: not used*/
+				smp = ct->op1_out>>16;
+				if( eg_out < ENV_QUIET ) {		/* SLOT 3 */
+					smp += op_calc(ct->phase3, eg_out,  0);
+				}
+				if( eg_out2 < ENV_QUIET ) {		/* SLOT 2 */
+					smp += op_calc(ct->phase2, eg_out2, 0);
+				}
+				if( eg_out4 < ENV_QUIET ) {		/* SLOT 4 */
+					smp += op_calc(ct->phase4, eg_out4, 0);
+				}
+				break;
+			}
+		}
+		/* done calculating channel sample */
+
+		/* mix sample to output buffer */
+		if (smp) {
+			if (ct->pack & 1) { /* stereo */
+				if (ct->pack & 0x20) /* L */ /* TODO: check correctness */
+					buffer[scounter*2] += smp;
+				if (ct->pack & 0x10) /* R */
+					buffer[scounter*2+1] += smp;
+			} else {
+				buffer[scounter] += smp;
+			}
+			ct->algo |= 8;
+		}
+
+		/* update phase counters AFTER output calculations */
+		ct->phase1 += ct->incr1;
+		ct->phase2 += ct->incr2;
+		ct->phase3 += ct->incr3;
+		ct->phase4 += ct->incr4;
+	}
+}
+
+
+#define MAX_LEN 800
+
+static unsigned int rnd_state;
+
+static unsigned int rnd(void)
+{
+	rnd_state = rnd_state * 1103515245 + 12345;
+	return rnd_state >> 8;
+}
+
+static void w(int part, int r, int v)
+{
+	YM2612Write_(part*2, r);
+	YM2612Write_(part*2+1, v);
+}
+
+/* render frames of random register activity, seeded by seed */
+static void play(unsigned int seed, int frames, int *out)
+{
+	int f, i, c, n;
+
+	rnd_state = seed;
+	YM2612Init_(53693175/7, 44100);
+	YM2612ResetChip_();
+	// not cleared by a chip reset, but both runs must start the same
+	g_lfo_ampm = 0;
+	memset(&crct, 0, sizeof(crct));
+
+	// all channels voiced and panned, so that something is heard
+	for (c = 0; c < 6; c++) {
+		int p = c / 3, ch = c % 3;
+		for (i = 0; i < 4; i++) {
+			w(p, 0x30+ch+i*4, rnd() & 0x7f);
+			w(p, 0x40+ch+i*4, (rnd() & 0x1f) | (i == 3 ? 0 : 0x10));
+			w(p, 0x50+ch+i*4, rnd() | 0x1f);
+			w(p, 0x60+ch+i*4, rnd() & 0x9f);
+			w(p, 0x70+ch+i*4, rnd() & 0x1f);
+			w(p, 0x80+ch+i*4, rnd() & 0xff);
+		}
+		w(p, 0xb0+ch, rnd() & 0x3f);
+		w(p, 0xb4+ch, 0xc0 | (rnd() & 0x37));
+		w(p, 0xa4+ch, rnd() & 0x3f);
+		w(p, 0xa0+ch, rnd() & 0xff);
+	}
+
+	for (f = 0; f < frames; f++, out += MAX_LEN*2 + 1)
+	{
+		int stereo = (f & 64) ? 0 : 1;
+		int len = 700 + (f % 7) * 10;
+
+		n = rnd() % 8;
+		for (i = 0; i < n; i++) {
+			unsigned int r = rnd(), v = rnd() & 0xff;
+			int p = r & 1, ch = (r >> 1) % 3, sl = (r >> 3) & 3;
+			switch ((r >> 5) % 12) {
+			case 0: w(0, 0x28, (rnd() & 0xf0) | (p << 2) | ch); break; // key on
+			case 1: w(0, 0x28, (p << 2) | ch); break;                    // key off
+			case 2: w(p, 0xa4+ch, v & 0x3f); w(p, 0xa0+ch, rnd()); break;
+			case 3: w(p, 0xb0+ch, v & 0x3f); break;                      // algo, fb
+			case 4: w(p, 0xb4+ch, v); break;                             // pan, ams, pms
+			case 5: w(0, 0x22, v & 0x0f); break;                         // lfo
+			case 6: w(p, 0x40+ch+sl*4, v & 0x7f); break;
+			case 7: w(p, 0x50+ch+sl*4, v); w(p, 0x60+ch+sl*4, v); break;
+			case 8: w(p, 0x80+ch+sl*4, v); w(p, 0x70+ch+sl*4, v & 0x1f); break;
+			case 9: w(p, 0x30+ch+sl*4, v & 0x7f); break;
+			case 10: w(0, 0x27, v & 0x40); break;                        // 3 slot mode
+			case 11: w(0, 0x2b, v & 0x80);                               // dac
+				 w(0, 0xa8 + (v & 3), rnd()); w(0, 0xac + (v & 3), rnd() & 0x3f); break;
+			}
+		}
+
+		memset(out, 0, (MAX_LEN*2 + 1) * sizeof(*out));
+		out[MAX_LEN*2] = YM2612UpdateOne_(out, len, stereo, (f & 3) != 0);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int frames = argc > 1 ? atoi(argv[1]) : 2000;
+	int seeds = argc > 2 ? atoi(argv[2]) : 8;
+	size_t size = (size_t)frames * (MAX_LEN*2 + 1);
+	int *a = malloc(size * sizeof(*a));
+	int *b = malloc(size * sizeof(*b));
+	int s, fails = 0;
+
+	if (a == NULL || b == NULL) {
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	for (s = 1; s <= seeds; s++)
+	{
+		size_t i;
+
+		ref_loop = 1;
+		play(s, frames, a);
+		ref_loop = 0;
+		play(s, frames, b);
+
+		for (i = 0; i < size; i++)
+			if (a[i] != b[i])
+				break;
+		if (i < size) {
+			printf("seed %d: mismatch in frame %d, sample %d: %d != %d\n", s,
+				(int)(i / (MAX_LEN*2 + 1)), (int)(i % (MAX_LEN*2 + 1)), a[i], b[i]);
+			fails++;
+		}
+		else
+			printf("seed %d: %d frames ok\n", s, frames);
+	}
+
+	free(a);
+	free(b);
+	return fails ? 1 : 0;
+}